@@ -0,0 +1,47 @@
+/* File: bench.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <lib/debug/platform.hpp>
+
+#include <lib/bench/main.hpp>
+
+#include <bench/lib/data/serialize.hpp>
+
+#include <bench/lib/impl/codec/lz.hpp>
+
+#include <bench/lib/impl/stream/fifo.hpp>
+#include <bench/lib/impl/stream/spsc.hpp>
+#include <bench/lib/impl/stream/streams.hpp>
+
+int main( int argc, char * argv[] ) {
+	CPPLIB__BENCH_SYSTEM_INFO;
+
+	CPPLIB__BENCH_MAIN_BEGIN( argc, argv );
+
+#ifdef CPPLIB__bench__lib__data__serialize__hpp
+	CPPLIB__BENCH_RUN( ::bench::lib::data::Serialize );
+#endif // CPPLIB__bench__lib__data__serialize__hpp
+
+#ifdef CPPLIB__bench__lib__impl__codec__lz__hpp
+	CPPLIB__BENCH_RUN( ::bench::lib::codec::impl::Lz );
+#endif // CPPLIB__bench__lib__impl__codec__lz__hpp
+
+#ifdef CPPLIB__bench__lib__impl__stream__fifo__hpp
+	CPPLIB__BENCH_RUN( ::bench::lib::stream::impl::Fifo );
+#endif // CPPLIB__bench__lib__impl__stream__fifo__hpp
+
+#ifdef CPPLIB__bench__lib__impl__stream__spsc__hpp
+	CPPLIB__BENCH_RUN( ::bench::lib::stream::impl::Spsc );
+#endif // CPPLIB__bench__lib__impl__stream__spsc__hpp
+
+#ifdef CPPLIB__bench__lib__impl__stream__streams__hpp
+	CPPLIB__BENCH_RUN( ::bench::lib::stream::impl::Streams );
+#endif // CPPLIB__bench__lib__impl__stream__streams__hpp
+
+	CPPLIB__BENCH_MAIN_END;
+}
@@ -7,52 +7,44 @@
  */
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
-#include <array>
 #include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <lib/types.hpp>
+#include <lib/literals.hpp>
 #include <lib/cstring.hpp>
 #include <lib/data/buffer.hpp>
 #include <lib/debug/hexdump.hpp>
+#include <lib/debug/platform.hpp>
 
 #include <lib/impl/stream/file.hpp>
+#if defined(CPPLIB_PLATFORM_POSIX)
+	#include <lib/impl/stream/mapped_file.hpp>
+#endif // CPPLIB_PLATFORM_POSIX
 
-int main( int argc, const char * argv[] ) {
-	using namespace lib;
+namespace {
 
-	static constexpr usize BLOCK_SIZE = debug::hexdump::COLUMNS * 64;
+using namespace lib;
 
-	if ( argc != 2 or ::std::strcmp( argv[1], "-h" ) == 0 ) {
-		::std::fprintf( stderr, "Usage: %s <filename>\n", argv[0] );
-		return 1;
-	}
+using hexdump = debug::hexdump;
 
-	const cstring filename {argv[1]};
-	const bool read_stdin = filename == cstring {"-"};
+/// @brief Bytes read and rendered per fwrite() call.
+constexpr usize BLOCK_SIZE = hexdump::COLUMNS * 4096;
+/// @brief Min width of offsets when size of the input is unknown (stdin).
+constexpr usize STREAM_DIGITS = 8;
 
-	stream::impl::file file;
-	usize remain_bytes;
-
-	if ( read_stdin ) {
-		file = stdin;
-		remain_bytes = ::std::numeric_limits<decltype(remain_bytes)>::max();
-	} else if ( file.open( filename./*c_str*/data(), "rb" ) ) {
-		const auto & read_size = file.read_size();
-		if ( read_size.failed() ) {
-			::std::fprintf( stderr, "Unable to obtain file size: %s\n", read_size.error().message().c_str() );
-			return 2;
-		}
-		remain_bytes = read_size.value();
-	} else {
-		::std::fprintf( stderr, "Unable to open file \"%s\": %s\n"
-			, filename./*c_str*/data(), file.error().message().c_str() );
-		return 3;
-	}
-
-	const auto file_size = remain_bytes;
-	::std::array< u8, BLOCK_SIZE > block;
+int dump_stream( stream::impl::file & file, usize remain_bytes, usize digits ) {
+	const bool read_stdin = remain_bytes == ::std::numeric_limits<usize>::max();
+	::std::vector<u8> block( BLOCK_SIZE );
+	::std::vector<char> output( hexdump::render_size( BLOCK_SIZE ) );
+	usize offset = 0;
 	while ( remain_bytes > 0 ) {
 		const auto count = ::std::min( remain_bytes, BLOCK_SIZE );
 		const auto & read_bytes = file.read({ block.data(), count });
@@ -61,8 +53,9 @@ int main( int argc, const char * argv[] ) {
 			return 4;
 		}
 
-		const auto offset = file_size - remain_bytes;
-		debug::hexdump( {block.data(), read_bytes.value()}, debug::hexdump::external, offset );
+		const auto size = hexdump::render( {block.data(), read_bytes.value()}, output.data(), hexdump::external, offset, digits );
+		::std::fwrite( output.data(), 1, size, stdout );
+		offset += read_bytes.value();
 		remain_bytes -= count;
 
 		if ( read_bytes != count ) {
@@ -73,6 +66,125 @@ int main( int argc, const char * argv[] ) {
 			return 5;
 		}
 	}
+	return 0;
+}
+
+#if defined(CPPLIB_PLATFORM_POSIX)
+/** @brief Renders chunks of mmap'ed file in `threads_count` worker threads, main thread writes them in order.
+ *  Every chunk has its slot in a ring of output buffers, so workers run at most SLOTS_PER_THREAD
+ *  chunks ahead of the writer.
+ */
+int dump_parallel( const char * filename, usize threads_count ) {
+	static constexpr usize CHUNK_SIZE = hexdump::COLUMNS * 64 * 1024;
+	static constexpr usize SLOTS_PER_THREAD = 2;
+
+	stream::impl::mapped_file file;
+	if ( not file.open( filename, stream::impl::mapped_file::Advice::SEQUENTIAL ) ) {
+		::std::fprintf( stderr, "Unable to open file \"%s\": %s\n", filename, file.error().message().c_str() );
+		return 3;
+	}
+	const auto input = file.mapping();
+	const auto digits = hexdump::offset_digits( input.size() );
+	const auto chunks = ( input.size() + CHUNK_SIZE - 1 ) / CHUNK_SIZE;
+
+	struct slot {
+		usize chunk = 0;
+		bool ready = false;
+		::std::vector<char> output;
+	};
+	::std::vector<slot> slots( threads_count * SLOTS_PER_THREAD );
+	for ( usize i = 0; i < slots.size(); ++i )
+		slots[i].chunk = i;
+	usize next_chunk = 0;
+	::std::mutex mutex;
+	::std::condition_variable changed;
+
+	const auto worker = [&]() {
+		::std::unique_lock lock {mutex};
+		while ( next_chunk < chunks ) {
+			const auto chunk = next_chunk++;
+			auto & slot_ = slots[chunk % slots.size()];
+			changed.wait( lock, [&]() { return slot_.chunk == chunk; } );
+			lock.unlock();
+
+			const auto offset = chunk * CHUNK_SIZE;
+			const auto part = input.subspan( offset, ::std::min( input.size() - offset, CHUNK_SIZE ) );
+			slot_.output.resize( hexdump::render_size( part.size() ) );
+			slot_.output.resize( hexdump::render( part, slot_.output.data(), hexdump::external, offset, digits ) );
+
+			lock.lock();
+			slot_.ready = true;
+			changed.notify_all();
+		}
+	};
+	::std::vector<::std::thread> threads;
+	for ( usize i = 0; i < threads_count; ++i )
+		threads.emplace_back( worker );
+
+	for ( usize chunk = 0; chunk < chunks; ++chunk ) {
+		auto & slot_ = slots[chunk % slots.size()];
+		{
+			::std::unique_lock lock {mutex};
+			changed.wait( lock, [&]() { return slot_.ready; } );
+		}
+		::std::fwrite( slot_.output.data(), 1, slot_.output.size(), stdout );
+		::std::unique_lock lock {mutex};
+		slot_.ready = false;
+		slot_.chunk = chunk + slots.size();
+		changed.notify_all();
+	}
 
+	for ( auto & thread : threads )
+		thread.join();
 	return 0;
 }
+#endif // CPPLIB_PLATFORM_POSIX
+
+} // namespace
+
+int main( int argc, const char * argv[] ) {
+	const auto usage = [&]() {
+		::std::fprintf( stderr, "Usage: %s [-j <threads>] <filename>\n"
+			"  -j  Dump memory mapped file in parallel (0 - one thread per core).\n", argv[0] );
+		return 1;
+	};
+
+	usize threads = 1;
+	int arg = 1;
+	if ( argc == 4 and ::std::strcmp( argv[1], "-j" ) == 0 ) {
+		threads = (usize) ::std::strtoul( argv[2], nullptr, 10 );
+		if ( threads == 0 )
+			threads = ::std::max( 1u, ::std::thread::hardware_concurrency() );
+		arg = 3;
+	} else if ( argc != 2 or ::std::strcmp( argv[1], "-h" ) == 0 )
+		return usage();
+
+	const cstring filename {argv[arg]};
+	const bool read_stdin = filename == cstring {"-"};
+
+	if ( threads > 1 and not read_stdin ) {
+#if defined(CPPLIB_PLATFORM_POSIX)
+		return dump_parallel( filename./*c_str*/data(), threads );
+#else
+		::std::fprintf( stderr, "Parallel mode is not supported on this platform.\n" );
+		return 1;
+#endif // CPPLIB_PLATFORM_POSIX
+	}
+
+	stream::impl::file file;
+	if ( read_stdin ) {
+		file = stdin;
+		return dump_stream( file, ::std::numeric_limits<usize>::max(), STREAM_DIGITS );
+	}
+	if ( not file.open( filename./*c_str*/data(), "rb" ) ) {
+		::std::fprintf( stderr, "Unable to open file \"%s\": %s\n"
+			, filename./*c_str*/data(), file.error().message().c_str() );
+		return 3;
+	}
+	const auto & read_size = file.read_size();
+	if ( read_size.failed() ) {
+		::std::fprintf( stderr, "Unable to obtain file size: %s\n", read_size.error().message().c_str() );
+		return 2;
+	}
+	return dump_stream( file, read_size.value(), hexdump::offset_digits( read_size.value() ) );
+}
@@ -0,0 +1,224 @@
+/* File: /bench/lib/data/serialize.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cpp/lib_debug>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+#include <lib/data/serialize.hpp>
+#include <lib/impl/serialize/std_contiguous_container.hpp>
+#include <lib/impl/serialize/std_tuple.hpp>
+#include <lib/impl/serialize/varint.hpp>
+#include <lib/data/fields.hpp>
+
+#include <lib/impl/stream/data.hpp>
+#include <lib/impl/stream/fifo.hpp>
+#include <lib/impl/stream/metered.hpp>
+
+#include "./serialize.hpp"
+
+namespace bench::lib::data {
+
+namespace {
+
+/// @brief Typical small packet: 10 trivial fields.
+struct Fields {
+	::lib::u32 id = 1;
+	::lib::u32 flags = 2;
+	::lib::u64 timestamp = 3;
+	::lib::f32 x = 4, y = 5, z = 6;
+	::lib::u16 a = 7, b = 8;
+	::lib::u8 c = 9;
+	::lib::i64 d = 10;
+
+	template< class S >
+	::lib::data::result_t serialize( S & stream ) const
+	{ return ::lib::data::serialize( stream, id, flags, timestamp, x, y, z, a, b, c, d ); }
+
+	template< class S >
+	::lib::data::result_t deserialize( S & stream )
+	{ return ::lib::data::deserialize( stream, id, flags, timestamp, x, y, z, a, b, c, d ); }
+};
+
+constexpr ::lib::usize FIELDS_SIZE = 4 + 4 + 8 + 4 * 3 + 2 * 2 + 1 + 8;
+
+/// @brief Trivial value: copied as is.
+struct Point {
+	::lib::f32 x, y, z;
+	::lib::u32 id;
+};
+
+/// @brief Nested tag_serializeable objects.
+struct Item
+	: ::lib::tag_serializeable_fields<Item>
+{
+	::lib::u32 id = 1;
+	::lib::u64 value = 2;
+	static constexpr auto fields = ::std::tuple { &Item::id, &Item::value };
+};
+
+struct Order
+	: ::lib::tag_serializeable_fields<Order>
+{
+	::lib::u32 id = 1;
+	Item item;
+	::std::vector<Item> items = ::std::vector<Item>( 8 );
+	static constexpr auto fields = ::std::tuple { &Order::id, &Order::item, &Order::items };
+};
+
+/// @brief Hides dynamic type of the stream from the optimizer, so calls stay virtual.
+template< class Base, class Stream >
+Base & opaque( Stream & stream ) {
+	Base * base = &stream;
+	::lib::bench::keep( base );
+	return *base;
+}
+
+} // namespace
+
+template< class T >
+void Serialize::bench_object( const char * object, const T & value ) noexcept {
+	using Op = ::lib::stream::impl::metered::Op;
+	static constexpr ::lib::usize OBJECT_BYTES = 64 * 1024 * 1024;
+	static constexpr ::lib::usize MIN_ITERATIONS = 1024;
+	static constexpr ::lib::usize MAX_ITERATIONS = 4 * 1024 * 1024;
+
+	::lib::stream::impl::fifo fifo;
+	const auto size = ::lib::data::serialized_size( fifo, value ).value();
+	const auto iterations = ::std::clamp( OBJECT_BYTES / size, MIN_ITERATIONS, MAX_ITERATIONS );
+	T result {};
+
+	// Calls of a single object as seen by a stream behind the virtual interface.
+	::lib::stream::impl::metered metered {&fifo};
+	CPP_UNUSED( ::lib::data::serialize( metered, value ) );
+	const auto writes = (::lib::usize) metered[Op::WRITE].calls.load();
+	CPP_UNUSED( ::lib::data::deserialize( metered, result ) );
+	const auto reads = (::lib::usize) ( metered[Op::READ].calls.load() + metered[Op::PEEK].calls.load() );
+
+	::std::vector<::lib::u8> storage( size );
+	::lib::stream::impl::data data {::lib::data::buffer_t {storage}};
+	const auto measure = [&]( const char * operation, const char * stream, ::lib::usize calls, auto && fn ) {
+		const auto & name = ::std::string {operation} + "/" + object + "/" + stream;
+		auto sample = bench_time( name.c_str(), size, iterations, size, fn );
+		sample.calls = calls * iterations;
+		bench_report( sample );
+	};
+
+	measure( "serialize", "data", writes, [&]( ::lib::usize ) {
+		CPP_UNUSED( data.write_flush() );
+		::lib::bench::keep( ::lib::data::serialize( data, value ) );
+	});
+	measure( "deserialize", "data", reads, [&]( ::lib::usize ) {
+		CPP_UNUSED( data.read_flush() );
+		::lib::bench::keep( ::lib::data::deserialize( data, result ) );
+	});
+	measure( "roundtrip", "fifo", writes + reads, [&]( ::lib::usize ) {
+		::lib::bench::keep( ::lib::data::serialize( fifo, value ) );
+		::lib::bench::keep( ::lib::data::deserialize( fifo, result ) );
+		CPP_UNUSED( fifo.read_flush() );
+	});
+}
+
+void Serialize::bench_execute() noexcept/* override*/ {
+	static constexpr ::lib::usize ITERATIONS = 4 * 1024 * 1024;
+
+	::std::array<::lib::u8, FIELDS_SIZE> storage {};
+	const Fields fields;
+	Fields result;
+
+	::lib::stream::impl::data data {::lib::data::buffer_t {storage}};
+	auto & wdata = opaque<::lib::data::wstream_t>( data );
+	auto & rdata = opaque<::lib::data::rstream_t>( data );
+
+	bench_measure( "serialize/data/virtual", 10, ITERATIONS, FIELDS_SIZE, [&]( ::lib::usize ) {
+		CPP_UNUSED( data.write_flush() );
+		::lib::bench::keep( fields.serialize( wdata ) );
+	});
+	bench_measure( "serialize/data/static", 10, ITERATIONS, FIELDS_SIZE, [&]( ::lib::usize ) {
+		CPP_UNUSED( data.write_flush() );
+		::lib::bench::keep( fields.serialize( data ) );
+	});
+	bench_measure( "deserialize/data/virtual", 10, ITERATIONS, FIELDS_SIZE, [&]( ::lib::usize ) {
+		CPP_UNUSED( data.read_flush() );
+		::lib::bench::keep( result.deserialize( rdata ) );
+	});
+	bench_measure( "deserialize/data/static", 10, ITERATIONS, FIELDS_SIZE, [&]( ::lib::usize ) {
+		CPP_UNUSED( data.read_flush() );
+		::lib::bench::keep( result.deserialize( data ) );
+	});
+
+	::lib::stream::impl::fifo fifo;
+	auto & wfifo = opaque<::lib::data::wstream_t>( fifo );
+	auto & rfifo = opaque<::lib::data::rstream_t>( fifo );
+
+	bench_measure( "roundtrip/fifo/virtual", 10, ITERATIONS, FIELDS_SIZE, [&]( ::lib::usize ) {
+		::lib::bench::keep( fields.serialize( wfifo ) );
+		::lib::bench::keep( result.deserialize( rfifo ) );
+		CPP_UNUSED( fifo.read_flush() );
+	});
+	bench_measure( "roundtrip/fifo/static", 10, ITERATIONS, FIELDS_SIZE, [&]( ::lib::usize ) {
+		::lib::bench::keep( fields.serialize( fifo ) );
+		::lib::bench::keep( result.deserialize( fifo ) );
+		CPP_UNUSED( fifo.read_flush() );
+	});
+
+	// Suite of object kinds: ns/object, bytes/s and stream calls/object.
+	bench_object( "trivial", Point { 1, 2, 3, 4 } );
+	bench_object( "tuple", ::std::tuple<::lib::u32, ::lib::u64, ::lib::f32, ::lib::u16> { 1, 2, 3, 4 } );
+	bench_object( "vector<u32>", ::std::vector<::lib::u32>( 64, 0xC0FFEE ) );
+	::std::vector<::std::string> strings;
+	for ( ::lib::usize i = 0; i < 16; ++i )
+		strings.emplace_back( 8 + i * 2, (char) ( 'a' + i ) );
+	bench_object( "vector<string>", strings );
+	bench_object( "nested", Order {} );
+
+	// Large payload: copying into a container vs view aliasing the stream memory.
+	static constexpr ::lib::usize PAYLOAD_SIZE = 64 * 1024;
+	::std::vector<::lib::u8> payload_storage( sizeof(::lib::u32) + PAYLOAD_SIZE );
+	::lib::stream::impl::data payload_data {::lib::data::buffer_t {payload_storage}};
+	CPP_UNUSED( ::lib::data::serialize( payload_data, ::std::vector<::lib::u8>( PAYLOAD_SIZE, 0x5A ) ) );
+	::std::vector<::lib::u8> payload;
+	::std::span<const ::lib::u8> payload_view;
+
+	bench_measure( "deserialize/payload/vector", PAYLOAD_SIZE, ITERATIONS / 1024, PAYLOAD_SIZE, [&]( ::lib::usize ) {
+		CPP_UNUSED( payload_data.read_flush() );
+		payload = {};
+		::lib::bench::keep( ::lib::data::deserialize( payload_data, payload ) );
+	});
+	bench_measure( "deserialize/payload/view", PAYLOAD_SIZE, ITERATIONS / 1024, PAYLOAD_SIZE, [&]( ::lib::usize ) {
+		CPP_UNUSED( payload_data.read_flush() );
+		::lib::bench::keep( ::lib::data::deserialize( payload_data, payload_view ) );
+	});
+
+	// Decoding of packed varints, `param` is the size of every value in bytes.
+	static constexpr ::lib::usize VARINTS = 4096;
+	for ( const ::lib::usize varint_size : { 1, 2, 5, 10 } ) {
+		const ::lib::u64 value = varint_size == 1 ? 0 : ( (::lib::u64) 1 << ( 7 * ( varint_size - 1 ) ) );
+		::std::vector<::lib::u8> encoded( VARINTS * varint_size + ::lib::data::leb128::MAX_SIZE );
+		for ( ::lib::usize i = 0; i < VARINTS; ++i )
+			CPP_UNUSED( ::lib::data::leb128::encode( value, &encoded[i * varint_size] ) );
+		bench_measure( "leb128/decode", varint_size, ITERATIONS / VARINTS, VARINTS * varint_size, [&]( ::lib::usize ) {
+			::lib::u64 sum = 0;
+			for ( ::lib::usize offset = 0; offset < VARINTS * varint_size; ) {
+				::lib::u64 decoded = 0;
+				offset += (::lib::usize) ::lib::data::leb128::decode( &encoded[offset], encoded.size() - offset, decoded );
+				sum += decoded;
+			}
+			::lib::bench::keep( sum );
+		});
+	}
+}
+
+} // namespace bench::lib::data
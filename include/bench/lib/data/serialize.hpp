@@ -0,0 +1,30 @@
+/* File: /bench/lib/data/serialize.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__bench__lib__data__serialize__hpp
+#define CPPLIB__bench__lib__data__serialize__hpp
+
+#include <lib/bench/unit.hpp>
+
+namespace bench::lib::data {
+
+class Serialize final
+	: public ::lib::bench::IUnit
+{
+public:
+	Serialize() noexcept : IUnit {"Serialize"} {}
+private:
+	void bench_execute() noexcept override;
+
+	/// @brief Serialization of `value` over stream::impl::data and stream::impl::fifo, `param` is its size.
+	template< class T >
+	void bench_object( const char * object, const T & value ) noexcept;
+};
+
+} // namespace bench::lib::data
+
+#endif // CPPLIB__bench__lib__data__serialize__hpp
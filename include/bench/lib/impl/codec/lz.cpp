@@ -0,0 +1,107 @@
+/* File: /bench/lib/impl/codec/lz.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <cpp/lib_debug>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+
+#include <lib/impl/codec/lz.hpp>
+
+#include "./lz.hpp"
+
+namespace bench::lib::codec::impl {
+
+namespace {
+
+using namespace ::lib;
+
+using bytes = ::std::vector<u8>;
+
+/// @brief Chatty sync traffic: small JSON state updates of a few objects.
+bytes make_json( usize size ) {
+	bytes result;
+	for ( usize i = 0; result.size() < size; ++i ) {
+		const auto line = "{\"type\":\"update\",\"id\":" + ::std::to_string( 1000 + i % 8 )
+			+ ",\"seq\":" + ::std::to_string( i )
+			+ ",\"pos\":{\"x\":" + ::std::to_string( i * 37 % 1000 ) + ",\"y\":" + ::std::to_string( i * 11 % 500 )
+			+ "},\"state\":\"" + ( i % 3 == 0 ? "moving" : "idle" ) + "\"}";
+		result.insert( result.end(), line.begin(), line.end() );
+	}
+	result.resize( size );
+	return result;
+}
+
+/// @brief Serialized records with slowly changing fields.
+bytes make_records( usize size ) {
+	struct Record { u32 id; u32 flags; u64 timestamp; f32 x, y, z; u32 hp; };
+	bytes result( size );
+	for ( usize offset = 0, i = 0; offset + sizeof(Record) <= size; offset += sizeof(Record), ++i ) {
+		const Record record { (u32)( i % 16 ), 0x10, 1700000000000 + i * 16, (f32)( i % 100 ), 1.5f, -3.f, (u32)( 100 - i % 7 ) };
+		::std::memcpy( result.data() + offset, &record, sizeof(record) );
+	}
+	return result;
+}
+
+bytes make_random( usize size ) {
+	bytes result( size );
+	u32 seed = 313373;
+	for ( auto & value : result ) {
+		seed = seed * 1664525u + 1013904223u;
+		value = (u8)( seed >> 24 );
+	}
+	return result;
+}
+
+} // namespace
+
+void Lz::bench_execute() noexcept/* override*/ {
+	static constexpr usize TOTAL_BYTES = 64_sz * 1024 * 1024;
+	const struct { const char * encode; const char * decode; const char * ratio; bytes plain; } PAYLOADS[] =
+		{ { "lz/encode/json:256",		"lz/decode/json:256",		"lz/ratio/json:256",		make_json( 256 )				}
+		, { "lz/encode/records:1K",		"lz/decode/records:1K",		"lz/ratio/records:1K",		make_records( 1024 )			}
+		, { "lz/encode/json:1M",		"lz/decode/json:1M",		"lz/ratio/json:1M",			make_json( 1024_sz * 1024 )		}
+		, { "lz/encode/records:1M",		"lz/decode/records:1M",		"lz/ratio/records:1M",		make_records( 1024_sz * 1024 )	}
+		, { "lz/encode/random:1M",		"lz/decode/random:1M",		"lz/ratio/random:1M",		make_random( 1024_sz * 1024 )	}
+		};
+
+	::lib::codec::impl::lz codec;
+	for ( const auto & payload : PAYLOADS ) {
+		const auto size = payload.plain.size();
+		const auto iterations = ::std::max( TOTAL_BYTES / size, 1_sz );
+
+		CPP_UNUSED( codec.encode( payload.plain ) );
+		const bytes coded = [&]() {
+			const auto & buffer = codec.read_cbuffer( true );
+			return bytes( buffer.begin(), buffer.end() );
+		}();
+		::std::fprintf( stdout, "  %-32s %10zu %10zu %13.2f %%\n"
+			, payload.ratio, size, coded.size(), 100.0 * (f64) coded.size() / (f64) size );
+
+		/// @note Every packet is flushed on its own, as it would be sent to the wire.
+		bench_measure( payload.encode, size, iterations, size, [&]( usize ) {
+			codec.reset( ::lib::data::codec_t::Mode::ENCODE );
+			CPP_UNUSED( codec.encode( payload.plain ) );
+			::lib::bench::keep( codec.read_cbuffer( true ) );
+		});
+		bench_measure( payload.decode, size, iterations, size, [&]( usize ) {
+			codec.reset( ::lib::data::codec_t::Mode::DECODE );
+			CPP_UNUSED( codec.decode( coded ) );
+			::lib::bench::keep( codec.read_cbuffer( true ) );
+		});
+	}
+}
+
+} // namespace bench::lib::codec::impl
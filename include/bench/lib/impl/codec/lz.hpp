@@ -0,0 +1,26 @@
+/* File: /bench/lib/impl/codec/lz.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__bench__lib__impl__codec__lz__hpp
+#define CPPLIB__bench__lib__impl__codec__lz__hpp
+
+#include <lib/bench/unit.hpp>
+
+namespace bench::lib::codec::impl {
+
+class Lz final
+	: public ::lib::bench::IUnit
+{
+public:
+	Lz() noexcept : IUnit {"Lz"} {}
+private:
+	void bench_execute() noexcept override;
+};
+
+} // namespace bench::lib::codec::impl
+
+#endif // CPPLIB__bench__lib__impl__codec__lz__hpp
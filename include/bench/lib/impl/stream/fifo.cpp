@@ -0,0 +1,112 @@
+/* File: /bench/lib/impl/stream/fifo.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <cstring>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <cpp/lib_debug>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+#include <lib/data/stream.hpp>
+
+#include <lib/impl/stream/chain.hpp>
+#include <lib/impl/stream/fifo.hpp>
+
+#include "./fifo.hpp"
+
+namespace bench::lib::stream::impl {
+
+namespace {
+
+using namespace ::lib;
+
+/// @brief Reference ::std::vector<> based fifo (compacts data on every read_flush()).
+class vector_fifo final
+	: public data::rwstream_t
+{
+public:
+	data::result_t read( const data::buffer_t & buffer ) override {
+		const auto count = ::std::min( buffer.size(), buffer_.size() - read_pos_ );
+		::std::memcpy( buffer.data(), &buffer_[read_pos_], count );
+		read_pos_ += count;
+		return count;
+	}
+	bool read_flush() override {
+		buffer_.erase( buffer_.begin(), buffer_.begin() + (isize) read_pos_ );
+		read_pos_ = 0;
+		return true;
+	}
+	data::result_t read_size() override { return buffer_.size() - read_pos_; }
+	::std::error_condition read_error() const override { return {}; }
+
+	data::result_t write( const data::cbuffer_t & buffer ) override {
+		const auto write_pos_ = buffer_.size();
+		buffer_.resize( buffer_.size() + buffer.size() );
+		::std::memcpy( &buffer_[write_pos_], buffer.data(), buffer.size() );
+		return buffer.size();
+	}
+	data::result_t write_size() override { return ::std::numeric_limits<usize>::max() - buffer_.size(); }
+	::std::error_condition write_error() const override { return {}; }
+
+	::std::error_condition error() const override { return {}; }
+private:
+	::std::vector<u8> buffer_;
+	usize read_pos_ = 0;
+};
+
+/// @brief Producer/consumer steady state: `backlog` bytes always stay unread.
+void prefill( data::rwstream_t & stream, usize backlog ) {
+	const ::std::vector<u8> data( backlog );
+	CPP_UNUSED( stream.write( data ) );
+	CPP_UNUSED( stream.read_flush() );
+}
+
+} // namespace
+
+void Fifo::bench_execute() noexcept/* override*/ {
+	static constexpr usize CHUNKS[] = { 64, 4096 };
+	static constexpr struct { usize size; const char * ring; const char * chain; const char * vector; } BACKLOGS[] =
+		{ { 0,				"fifo/ring/backlog:0",		"fifo/chain/backlog:0",		"fifo/vector/backlog:0"		}
+		, { 64_sz * 1024,	"fifo/ring/backlog:64K",	"fifo/chain/backlog:64K",	"fifo/vector/backlog:64K"	}
+		, { 1024_sz * 1024,	"fifo/ring/backlog:1M",		"fifo/chain/backlog:1M",	"fifo/vector/backlog:1M"	}
+		};
+	static constexpr usize TOTAL_BYTES = 256_sz * 1024 * 1024;
+	static constexpr usize TOTAL_MOVED = 4096_sz * 1024 * 1024;
+
+	::std::vector<u8> chunk_data( CHUNKS[::std::size( CHUNKS ) - 1], 0x5A );
+
+	for ( const auto backlog : BACKLOGS ) {
+		for ( const auto chunk_size : CHUNKS ) {
+			const data::buffer_t chunk {chunk_data.data(), chunk_size};
+			/// @note Vector compaction moves the whole backlog per iteration, limit its work.
+			const auto iterations = ::std::min( TOTAL_BYTES / chunk_size, TOTAL_MOVED / ( backlog.size + chunk_size ) );
+
+			const auto run = [&]( const char * name, data::rwstream_t & stream ) {
+				prefill( stream, backlog.size );
+				bench_measure( name, chunk_size, iterations, chunk_size, [&]( usize ) {
+					CPP_UNUSED( stream.write( chunk ) );
+					CPP_UNUSED( stream.read( chunk ) );
+					CPP_UNUSED( stream.read_flush() );
+				});
+			};
+
+			::lib::stream::impl::fifo ring;
+			::lib::stream::impl::chain chain;
+			vector_fifo vector;
+			run( backlog.ring, ring );
+			run( backlog.chain, chain );
+			run( backlog.vector, vector );
+		}
+	}
+}
+
+} // namespace bench::lib::stream::impl
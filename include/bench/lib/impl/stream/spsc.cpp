@@ -0,0 +1,97 @@
+/* File: /bench/lib/impl/stream/spsc.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <thread>
+#include <vector>
+
+#include <cpp/lib_debug>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+#include <lib/data/stream.hpp>
+
+#include <lib/impl/stream/spsc.hpp>
+
+#include "./spsc.hpp"
+
+namespace bench::lib::stream::impl {
+
+namespace {
+
+using namespace ::lib;
+
+/// @brief Writes whole `buffer`, yields while the ring is full.
+void write_all( data::wstream_t & stream, data::cbuffer_t buffer ) {
+	while ( not buffer.empty() ) {
+		const auto count = stream.write( buffer ).value();
+		buffer = buffer.subspan( count );
+		if ( count == 0 )
+			::std::this_thread::yield();
+	}
+}
+
+/// @brief Reads whole `buffer`, yields while the ring is empty.
+void read_all( data::rstream_t & stream, data::buffer_t buffer ) {
+	while ( not buffer.empty() ) {
+		const auto count = stream.read( buffer ).value();
+		buffer = buffer.subspan( count );
+		CPP_UNUSED( stream.read_flush() );
+		if ( count == 0 )
+			::std::this_thread::yield();
+	}
+}
+
+} // namespace
+
+void Spsc::bench_execute() noexcept/* override*/ {
+	static constexpr usize CAPACITY = 64_sz * 1024;
+	static constexpr usize TOTAL_BYTES = 256_sz * 1024 * 1024;
+	static constexpr usize ROUND_TRIPS = 64_sz * 1024;
+	static constexpr struct { usize size; const char * name; } CHUNKS[] =
+		{ { 64,		"spsc/throughput/chunk:64"		}
+		, { 4096,	"spsc/throughput/chunk:4K"		}
+		};
+
+	// Producer thread -> consumer (measuring) thread.
+	for ( const auto chunk : CHUNKS ) {
+		const auto iterations = TOTAL_BYTES / chunk.size;
+		::std::vector<u8> chunk_data( chunk.size, 0x5A );
+		::std::vector<u8> read_data( chunk.size );
+		::lib::stream::impl::spsc ring {CAPACITY};
+		::std::thread producer {[&]() {
+			for ( usize i = 0; i < iterations + iterations / WARMUP_DIVIDER; ++i )
+				write_all( ring, chunk_data );
+		}};
+		bench_measure( chunk.name, chunk.size, iterations, chunk.size, [&]( usize ) {
+			read_all( ring, read_data );
+		});
+		producer.join();
+	}
+
+	// Ping-pong between two threads: one sample is a full round trip of 8 bytes.
+	{
+		::lib::stream::impl::spsc ping {CAPACITY};
+		::lib::stream::impl::spsc pong {CAPACITY};
+		::std::thread echo {[&]() {
+			u64 value;
+			for ( usize i = 0; i < ROUND_TRIPS + ROUND_TRIPS / WARMUP_DIVIDER; ++i ) {
+				read_all( ping, {&value, sizeof(value)} );
+				write_all( pong, {&value, sizeof(value)} );
+			}
+		}};
+		bench_measure( "spsc/round-trip", sizeof(u64), ROUND_TRIPS, 0, [&]( usize i ) {
+			u64 value = i;
+			write_all( ping, {&value, sizeof(value)} );
+			read_all( pong, {&value, sizeof(value)} );
+			::lib::bench::keep( value );
+		});
+		echo.join();
+	}
+}
+
+} // namespace bench::lib::stream::impl
@@ -0,0 +1,26 @@
+/* File: /bench/lib/impl/stream/spsc.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__bench__lib__impl__stream__spsc__hpp
+#define CPPLIB__bench__lib__impl__stream__spsc__hpp
+
+#include <lib/bench/unit.hpp>
+
+namespace bench::lib::stream::impl {
+
+class Spsc final
+	: public ::lib::bench::IUnit
+{
+public:
+	Spsc() noexcept : IUnit {"Spsc"} {}
+private:
+	void bench_execute() noexcept override;
+};
+
+} // namespace bench::lib::stream::impl
+
+#endif // CPPLIB__bench__lib__impl__stream__spsc__hpp
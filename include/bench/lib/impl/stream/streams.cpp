@@ -0,0 +1,261 @@
+/* File: /bench/lib/impl/stream/streams.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <lib/debug/platform.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include <cpp/lib_debug>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+#include <lib/data/stream.hpp>
+
+#include <lib/impl/stream/buffer.hpp>
+#include <lib/impl/stream/data.hpp>
+#include <lib/impl/stream/fifo.hpp>
+
+#if defined(CPPLIB_PLATFORM_POSIX)
+	#include <arpa/inet.h>
+	#include <fcntl.h>
+	#include <netinet/in.h>
+	#include <stdlib.h>
+	#include <sys/socket.h>
+	#include <unistd.h>
+
+	#include <lib/impl/socket/tcp.hpp>
+	#include <lib/impl_posix/socket/unix.hpp>
+
+	#include <lib/impl/stream/file.hpp>
+	#include <lib/impl/stream/mapped_file.hpp>
+	#include <lib/impl/stream/stdio.hpp>
+	#include <lib/impl/stream/uring_file.hpp>
+#endif // CPPLIB_PLATFORM_POSIX
+
+#include "./streams.hpp"
+
+namespace bench::lib::stream::impl {
+
+namespace {
+
+using namespace ::lib;
+
+constexpr usize CHUNKS[] = { 1, 16, 256, 4_sz * 1024, 64_sz * 1024, 1024_sz * 1024 };
+constexpr usize CHUNK_MAX = CHUNKS[::std::size( CHUNKS ) - 1];
+/// @brief Data moved by a single case, limited by calls count for small chunks.
+constexpr usize TOTAL_BYTES = 256_sz * 1024 * 1024;
+constexpr usize MEMORY_CALLS = 4_sz * 1024 * 1024;
+constexpr usize SYSCALL_CALLS = 64_sz * 1024;
+
+constexpr usize iterations( usize chunk, usize max_calls ) {
+	return ::std::clamp( TOTAL_BYTES / chunk, 16_sz, max_calls );
+}
+
+#if defined(CPPLIB_PLATFORM_POSIX)
+
+constexpr usize FILE_SIZE = 16_sz * 1024 * 1024;
+
+/// @brief Temporarily replaces standard descriptor `fd` with `path` (keeps bench output intact).
+class redirect {
+public:
+	redirect( int fd_, const char * path, int flags ) : fd {fd_}, saved {::dup( fd_ )} {
+		::std::fflush( stdout );
+		const int target = ::open( path, flags );
+		CPP_ASSERT( target >= 0 );
+		CPP_UNUSED( ::dup2( target, fd ) );
+		CPP_UNUSED( ::close( target ) );
+	}
+	~redirect() {
+		CPP_UNUSED( ::dup2( saved, fd ) );
+		CPP_UNUSED( ::close( saved ) );
+	}
+private:
+	int fd;
+	int saved;
+};
+
+/// @brief Moves `source` through non-blocking stream pair pumping both ends from a single thread.
+void pump( data::wstream_t & out, data::rstream_t & in, const data::cbuffer_t & source, const data::buffer_t & sink ) {
+	usize written = 0;
+	usize read = 0;
+	while ( read < source.size() ) {
+		if ( written < source.size() ) {
+			const auto & result = out.write( source.subspan( written ) );
+			if ( result.success() )
+				written += result.value();
+		}
+		const auto & result = in.read( sink.subspan( read, written - read ) );
+		if ( result.success() )
+			read += result.value();
+	}
+}
+
+/// @brief Connected loopback sockets, both `fds` are -1 on failure (nothing is left open).
+bool make_tcp_pair( int ( & fds )[2] ) {
+	const int listener = ::socket( AF_INET, SOCK_STREAM, 0 );
+	if ( listener < 0 )
+		return false;
+	::sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = ::htonl( INADDR_LOOPBACK );
+	address.sin_port = 0;
+	::socklen_t length = sizeof( address );
+	fds[0] = fds[1] = -1;
+	const bool ok = ::bind( listener, (::sockaddr*) &address, sizeof( address ) ) == 0
+		and ::listen( listener, 1 ) == 0
+		and ::getsockname( listener, (::sockaddr*) &address, &length ) == 0
+		and ( fds[0] = ::socket( AF_INET, SOCK_STREAM, 0 ) ) >= 0
+		and ::connect( fds[0], (::sockaddr*) &address, sizeof( address ) ) == 0
+		and ( fds[1] = ::accept( listener, nullptr, nullptr ) ) >= 0;
+	CPP_UNUSED( ::close( listener ) );
+	if ( not ok )
+		for ( auto & fd : fds )
+			if ( fd >= 0 ) {
+				CPP_UNUSED( ::close( fd ) );
+				fd = -1;
+			}
+	return ok;
+}
+
+#endif // CPPLIB_PLATFORM_POSIX
+
+} // namespace
+
+void Streams::bench_execute() noexcept/* override*/ {
+	::std::vector<u8> source( CHUNK_MAX, 0x5A );
+	::std::vector<u8> sink( CHUNK_MAX );
+	::std::vector<u8> storage( CHUNK_MAX );
+
+	// In-memory streams: write a chunk and read it back.
+	for ( const auto chunk : CHUNKS ) {
+		const data::cbuffer_t in {source.data(), chunk};
+		const data::buffer_t out {sink.data(), chunk};
+		const auto count = iterations( chunk, MEMORY_CALLS );
+
+		::lib::stream::impl::data data_ {data::buffer_t {storage}};
+		bench_measure( "data/write+read", chunk, count, chunk, [&]( usize ) {
+			CPP_UNUSED( data_.write_flush() );
+			CPP_UNUSED( data_.write( in ) );
+			CPP_UNUSED( data_.read_flush() );
+			CPP_UNUSED( data_.read( out ) );
+		});
+
+		::lib::stream::impl::fifo fifo;
+		bench_measure( "fifo/write+read", chunk, count, chunk, [&]( usize ) {
+			CPP_UNUSED( fifo.write( in ) );
+			CPP_UNUSED( fifo.read( out ) );
+			CPP_UNUSED( fifo.read_flush() );
+		});
+
+		::lib::stream::impl::fifo backend;
+		::lib::stream::impl::buffer buffer {64_sz * 1024};
+		buffer.reset( &backend );
+		bench_measure( "buffer/write+read", chunk, count, chunk, [&]( usize ) {
+			CPP_UNUSED( buffer.write( in ) );
+			CPP_UNUSED( buffer.write_flush() );
+			CPP_UNUSED( buffer.read( out ) );
+			CPP_UNUSED( buffer.read_flush() );
+			/// @note Fifo keeps data read by the buffer until it is flushed.
+			CPP_UNUSED( backend.read_flush() );
+		});
+	}
+
+#if defined(CPPLIB_PLATFORM_POSIX)
+	using namespace ::lib::stream::impl;
+
+	// Files: sequential writes/reads of the FILE_SIZE file (page cache, no fsync).
+	char file_name[] = "/tmp/CPPLIB__bench__lib__impl__stream__streams__XXXXXX";
+	const int file_fd = ::mkstemp( file_name );
+	if ( file_fd < 0 )
+		return;
+	CPP_UNUSED( ::close( file_fd ) );
+
+	for ( const auto chunk : CHUNKS ) {
+		const data::cbuffer_t in {source.data(), chunk};
+		const data::buffer_t out {sink.data(), chunk};
+		const auto count = iterations( chunk, SYSCALL_CALLS );
+
+		{
+			file writer {file_name, "wb"};
+			bench_measure( "file/write", chunk, count, chunk, [&]( usize ) {
+				CPP_UNUSED( writer.write( in ) );
+				if ( writer.pos().value() >= FILE_SIZE )
+					CPP_UNUSED( writer.pos( 0 ) );
+			});
+			while ( writer.pos().value() < FILE_SIZE )
+				CPP_UNUSED( writer.write( source ) );
+		}
+
+		const auto run_read = [&]( const char * name, data::unistream_t & reader ) {
+			bench_measure( name, chunk, count, chunk, [&]( usize ) {
+				if ( reader.read( out ).value() < chunk )
+					CPP_UNUSED( reader.pos( 0 ) );
+			});
+		};
+		file reader {file_name, "rb"};
+		run_read( "file/read", reader );
+		mapped_file mapped {file_name, mapped_file::Advice::SEQUENTIAL};
+		run_read( "mapped_file/read", mapped );
+		uring_file uring {file_name};
+		CPP_UNUSED( uring.register_buffers( 4, 256_sz * 1024 ) );
+		run_read( "uring_file/read", uring );
+	}
+	CPP_UNUSED( ::unlink( file_name ) );
+
+	// Standard streams: stdout goes to /dev/null, stdin comes from /dev/zero.
+	for ( const auto chunk : CHUNKS ) {
+		const data::cbuffer_t in {source.data(), chunk};
+		const data::buffer_t out {sink.data(), chunk};
+		const auto count = iterations( chunk, SYSCALL_CALLS );
+
+		stdio stdio_;
+		::lib::bench::Sample sample {"stdio/write"};
+		{
+			const redirect null {STDOUT_FILENO, "/dev/null", O_WRONLY};
+			sample = bench_time( "stdio/write", chunk, count, chunk, [&]( usize ) {
+				CPP_UNUSED( stdio_.write( in ) );
+			});
+		}
+		bench_report( sample );
+		{
+			const redirect zero {STDIN_FILENO, "/dev/zero", O_RDONLY};
+			sample = bench_time( "stdio/read", chunk, count, chunk, [&]( usize ) {
+				CPP_UNUSED( stdio_.read( out ) );
+			});
+		}
+		bench_report( sample );
+	}
+
+	// Socket pairs: chunk goes from one end to the other.
+	for ( const auto chunk : CHUNKS ) {
+		const data::cbuffer_t in {source.data(), chunk};
+		const data::buffer_t out {sink.data(), chunk};
+		const auto count = iterations( chunk, SYSCALL_CALLS );
+
+		int fds[2] = { -1, -1 };
+		if ( ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ) == 0 ) {
+			::lib::socket::impl::unix::base first {fds[0]}, second {fds[1]};
+			if ( first.set_blocking( false ) and second.set_blocking( false ) )
+				bench_measure( "unix/write+read", chunk, count, chunk, [&]( usize ) {
+					pump( first, second, in, out );
+				});
+		}
+
+		int tcp_fds[2] = { -1, -1 };
+		const bool tcp_ok = make_tcp_pair( tcp_fds );
+		::lib::socket::impl::tcp::base first {tcp_fds[0]}, second {tcp_fds[1]};
+		if ( tcp_ok and first.set_blocking( false ) and second.set_blocking( false ) )
+			bench_measure( "tcp/write+read", chunk, count, chunk, [&]( usize ) {
+				pump( first, second, in, out );
+			});
+	}
+#endif // CPPLIB_PLATFORM_POSIX
+}
+
+} // namespace bench::lib::stream::impl
@@ -0,0 +1,50 @@
+/* File: /lib/bench/main.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__bench__main__hpp
+#define CPPLIB__lib__bench__main__hpp
+
+#include <cstddef>
+#include <cstdio>
+
+#include "../../lib/test/main.hpp"
+#include "./session.hpp"
+
+/// MAIN
+
+#define CPPLIB__BENCH_SYSTEM_INFO						CPPLIB__TEST_SYSTEM_INFO
+
+#define CPPLIB__BENCH_MAIN_BEGIN( argc, argv )			\
+	if ( not ::lib::bench::Session::instance().configure( argc, argv ) )	\
+		return 1;										\
+	::std::size_t samples_count = 0
+
+#define CPPLIB__BENCH_MAIN_END							\
+	::std::fprintf( stdout,								\
+		CPPLIB__TEST_ColGrn "Samples"					\
+		CPPLIB__TEST_ColWht ":  %zu\n"					\
+		CPPLIB__TEST_ColDef								\
+		, samples_count );								\
+	::std::fflush( stdout );							\
+	::lib::bench::Session::instance().close();			\
+	return 0
+
+
+#define CPPLIB__BENCH_RUN( Unit )						\
+	if ( ::lib::bench::Session::instance().selected( #Unit ) ) {	\
+		::std::fprintf( stdout,							\
+			CPPLIB__TEST_ColWht "Benchmark unit <"		\
+			CPPLIB__TEST_ColYlw #Unit					\
+			CPPLIB__TEST_ColWht ">:"					\
+			CPPLIB__TEST_ColDef "\n"					\
+			);											\
+		::std::fflush( stdout );						\
+		Unit unit;										\
+		samples_count += unit.bench_run();				\
+	}
+
+#endif // CPPLIB__lib__bench__main__hpp
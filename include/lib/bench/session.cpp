@@ -0,0 +1,73 @@
+/* File: /lib/bench/session.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <cstring>
+
+#include "./session.hpp"
+
+namespace lib::bench {
+
+// IMPLEMENTATION lib::bench::Session
+
+Session & Session::instance() noexcept {
+	static Session session;
+	return session;
+}
+
+bool Session::configure( int argc, char * argv[] ) noexcept {
+	for ( int i = 1; i < argc; i += 2 ) {
+		const char * option = argv[i];
+		const char * value = i + 1 < argc ? argv[i + 1] : nullptr;
+		const auto is = [option]( const char * name ) { return ::std::strcmp( option, name ) == 0; };
+		if ( value == nullptr or not ( is( "--filter" ) or is( "--csv" ) or is( "--json" ) ) ) {
+			::std::fprintf( stderr, "Usage: %s [--filter TEXT] [--csv FILE] [--json FILE]\n", argv[0] );
+			return false;
+		}
+		if ( is( "--filter" ) ) {
+			filter = value;
+			continue;
+		}
+		auto & file = is( "--csv" ) ? csv : json;
+		if ( file != nullptr )
+			::std::fclose( file );
+		file = ::std::fopen( value, "w" );
+		if ( file == nullptr ) {
+			::std::fprintf( stderr, "Can't open '%s'\n", value );
+			return false;
+		}
+		::std::fputs( &file == &csv ? "unit,name,param,iterations,ns_per_op,mb_per_s,calls_per_op\n" : "[", file );
+	}
+	return true;
+}
+
+bool Session::selected( const char * unit ) const noexcept {
+	return filter == nullptr or ::std::strstr( unit, filter ) != nullptr;
+}
+
+void Session::record( const char * unit, const Sample & sample ) noexcept {
+	if ( csv != nullptr )
+		::std::fprintf( csv, "%s,%s,%zu,%zu,%.3f,%.3f,%.3f\n"
+			, unit, sample.name, sample.param, sample.iterations, sample.ns_per_op(), sample.mb_per_s(), sample.calls_per_op() );
+	if ( json != nullptr )
+		::std::fprintf( json, "%s\n  {\"unit\":\"%s\",\"name\":\"%s\",\"param\":%zu,\"iterations\":%zu,\"ns_per_op\":%.3f,\"mb_per_s\":%.3f,\"calls_per_op\":%.3f}"
+			, json_samples++ == 0 ? "" : ",", unit, sample.name, sample.param, sample.iterations, sample.ns_per_op(), sample.mb_per_s(), sample.calls_per_op() );
+}
+
+void Session::close() noexcept {
+	if ( csv != nullptr ) {
+		::std::fclose( csv );
+		csv = nullptr;
+	}
+	if ( json != nullptr ) {
+		::std::fputs( "\n]\n", json );
+		::std::fclose( json );
+		json = nullptr;
+	}
+}
+
+} // namespace lib::bench
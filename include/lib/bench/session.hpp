@@ -0,0 +1,50 @@
+/* File: /lib/bench/session.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__bench__session__hpp
+#define CPPLIB__lib__bench__session__hpp
+
+#include <cstdio>
+
+#include "../../lib/types.hpp"
+#include "./unit.hpp"
+
+namespace lib::bench {
+
+// DECLARATION lib::bench::Session
+
+/** @brief Benchmark run options and machine-readable copy of all reported samples.
+ *  Command line: `[--filter TEXT] [--csv FILE] [--json FILE]`
+ *  - `--filter` runs units whose name contains TEXT only;
+ *  - `--csv`/`--json` additionally write samples to FILE, one row/object per sample.
+ */
+class Session {
+public:
+	static Session & instance() noexcept;
+
+	Session( const Session & ) = delete;
+	~Session() { close(); }
+
+	Session & operator = ( const Session & ) = delete;
+
+	/// @return false on unknown arguments or if an output file can not be opened.
+	bool configure( int argc, char * argv[] ) noexcept;
+	bool selected( const char * unit ) const noexcept;
+	void record( const char * unit, const Sample & sample ) noexcept;
+	void close() noexcept;
+private:
+	Session() = default;
+
+	const char * filter = nullptr;
+	::std::FILE * csv = nullptr;
+	::std::FILE * json = nullptr;
+	usize json_samples = 0;
+};
+
+} // namespace lib::bench
+
+#endif // CPPLIB__lib__bench__session__hpp
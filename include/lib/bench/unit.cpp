@@ -0,0 +1,36 @@
+/* File: /lib/bench/unit.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <cstdio>
+
+#include "./session.hpp"
+#include "./unit.hpp"
+
+namespace lib::bench {
+
+usize IUnit::bench_run() noexcept {
+	samples_ = 0;
+	bench_reset();
+	bench_execute();
+	return samples_;
+}
+
+void IUnit::bench_report( const Sample & sample ) noexcept {
+	++samples_;
+	::std::fprintf( stdout, "  %-32s %10zu %10zu %14.2f ns/op"
+		, sample.name, sample.param, sample.iterations, sample.ns_per_op() );
+	if ( sample.bytes > 0 )
+		::std::fprintf( stdout, " %12.2f MB/s", sample.mb_per_s() );
+	if ( sample.calls > 0 )
+		::std::fprintf( stdout, " %8.2f calls/op", sample.calls_per_op() );
+	::std::fputc( '\n', stdout );
+	::std::fflush( stdout );
+	Session::instance().record( name_, sample );
+}
+
+} // namespace lib::bench
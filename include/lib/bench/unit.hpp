@@ -0,0 +1,119 @@
+/* File: /lib/bench/unit.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__bench__unit__hpp
+#define CPPLIB__lib__bench__unit__hpp
+
+#include <chrono>
+#include <utility>
+
+#include "../../lib/types.hpp"
+#include "../../lib/debug/compiler.hpp"
+
+namespace lib::bench {
+
+// DECLARATION lib::bench::keep()
+
+/// @brief Prevents compiler from optimizing out computation of the `value`.
+template< class T >
+inline void keep( const T & value ) noexcept {
+#if defined(CPPLIB_COMPILER_MSVC)
+	static const volatile void * sink;
+	sink = &value;
+#else
+	__asm__ __volatile__( "" : : "g"( &value ) : "memory" );
+#endif // CPPLIB_COMPILER_MSVC
+}
+
+// DECLARATION lib::bench::Sample
+
+struct Sample {
+	using clock = ::std::chrono::steady_clock;
+	using duration = ::std::chrono::nanoseconds;
+
+	constexpr Sample( const char * name, usize param = 0 ) noexcept : name {name}, param {param} {}
+
+	constexpr f64 ns_per_op() const noexcept
+		{ return iterations == 0 ? 0.0 : (f64) elapsed.count() / (f64) iterations; }
+	constexpr f64 mb_per_s() const noexcept
+		{ return elapsed.count() == 0 ? 0.0 : (f64) bytes * 1e3 / (f64) elapsed.count(); }
+	constexpr f64 calls_per_op() const noexcept
+		{ return iterations == 0 ? 0.0 : (f64) calls / (f64) iterations; }
+
+	const char * name;
+	usize param;
+	usize iterations = 0;
+	usize bytes = 0;
+	/// @brief Stream calls made by all iterations, 0 if not counted.
+	usize calls = 0;
+	duration elapsed = {};
+};
+
+// DECLARATION lib::bench::IUnit
+
+class IUnit {
+public:
+	static constexpr usize WARMUP_DIVIDER = 16;
+
+	IUnit( const char * name ) noexcept : name_ {name} {}
+	virtual ~IUnit() noexcept {}
+
+	usize bench_run() noexcept;
+
+	const char * name() const noexcept { return name_; }
+
+protected:
+	virtual void bench_execute() noexcept = 0;
+	virtual void bench_reset() noexcept {}
+
+	/** @brief Calls `fn( iteration )` `iterations` times (after a short warm-up) and reports the elapsed time.
+	 *  @param param Case parameter (e.g. chunk size) reported along with the sample.
+	 *  @param bytes_per_iteration Amount of data processed by a single call, 0 if not applicable.
+	 */
+	template< class Fn >
+	Sample bench_measure( const char * name, usize param, usize iterations, usize bytes_per_iteration, Fn && fn ) noexcept;
+	/// @brief Same as bench_measure(), but leaves reporting to the caller (e.g. when stdout is redirected).
+	template< class Fn >
+	Sample bench_time( const char * name, usize param, usize iterations, usize bytes_per_iteration, Fn && fn ) noexcept;
+
+	void bench_report( const Sample & sample ) noexcept;
+private:
+	const char * name_;
+	usize samples_ = 0;
+};
+
+// INLINES lib::bench::IUnit
+
+template< class Fn >
+inline Sample IUnit::bench_measure
+	( const char * name, usize param, usize iterations, usize bytes_per_iteration, Fn && fn ) noexcept
+{
+	const auto & sample = bench_time( name, param, iterations, bytes_per_iteration, ::std::forward<Fn>( fn ) );
+	bench_report( sample );
+	return sample;
+}
+
+template< class Fn >
+inline Sample IUnit::bench_time
+	( const char * name, usize param, usize iterations, usize bytes_per_iteration, Fn && fn ) noexcept
+{
+	Sample sample {name, param};
+	/// @note Warm-up lets lazily allocated storage and caches settle down.
+	for ( usize i = 0; i < iterations / WARMUP_DIVIDER; ++i )
+		fn( i );
+	const auto start = Sample::clock::now();
+	for ( usize i = 0; i < iterations; ++i )
+		fn( i );
+	sample.elapsed = ::std::chrono::duration_cast<Sample::duration>( Sample::clock::now() - start );
+	sample.iterations = iterations;
+	sample.bytes = iterations * bytes_per_iteration;
+	return sample;
+}
+
+} // namespace lib::bench
+
+#endif // CPPLIB__lib__bench__unit__hpp
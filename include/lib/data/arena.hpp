@@ -0,0 +1,147 @@
+/* File: /lib/data/arena.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__data__arena__hpp
+#define CPPLIB__lib__data__arena__hpp
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+#include "../../lib/types.hpp"
+
+namespace lib::data {
+
+namespace detail {
+
+template< class T >
+concept PmrContainer = requires { typename T::allocator_type; typename T::value_type; }
+	and ::std::is_same_v< typename T::allocator_type, ::std::pmr::polymorphic_allocator<typename T::value_type> >;
+
+} // namespace detail
+
+// DECLARATION lib::data::arena_t
+
+/** @brief Monotonic memory for deserialized object graphs.
+ *  @details Passed as `context` of deserialize( void * context, ... ) overloads it is used for
+ *  containers with polymorphic allocator (`::std::pmr::vector`, `::std::pmr::string`, ...) and
+ *  their nested elements, and for pointees of null SPtr:
+ *
+ *      deserialize( arena.context(), stream, packet );
+ *      use( packet );
+ *      arena.reset();	// everything deserialized into the arena is gone, `packet` is empty
+ *
+ *  Allocations come from the initial buffer, then from blocks of the upstream resource, reset()
+ *  releases them all at once. Containers outside of the arena (e.g. fields of a packet) are
+ *  bound to it on deserialization and rebound to the default resource by reset(), so they are
+ *  left empty but valid. Containers living in the arena are abandoned (destructors of their
+ *  elements are not called).
+ *
+ *  @warning Containers bound since the previous reset() must be alive at reset(), reset() the
+ *           arena before destroying it if they outlive it. Pointees of SPtr and anything else
+ *           deserialized into the arena must not be used after reset().
+ */
+class arena_t {
+public:
+	static constexpr usize INITIAL_SIZE = 4096;
+	/// @brief Set in context(), so that a foreign context isn't taken for an arena.
+	static constexpr ::std::uintptr_t CONTEXT_TAG = 1;
+
+	/// @return Arena behind `context` of deserialize(), nullptr if it isn't context() of an arena.
+	static arena_t * from( void * context ) noexcept;
+	/// @brief Memory resource behind `context` of deserialize(), nullptr if it isn't context() of an arena.
+	static ::std::pmr::memory_resource * resource( void * context ) noexcept;
+
+	explicit arena_t( usize initial_size = INITIAL_SIZE
+		, ::std::pmr::memory_resource * upstream = ::std::pmr::get_default_resource() );
+	arena_t( const arena_t & ) = delete;
+
+	arena_t & operator = ( const arena_t & ) = delete;
+
+	::std::pmr::memory_resource * resource() noexcept { return &resource_; }
+	/// @brief Context for deserialize( void * context, ... ) overloads: tagged pointer to the arena.
+	void * context() noexcept { return (void *)( (::std::uintptr_t) this | CONTEXT_TAG ); }
+	/// @brief Rebinds bound containers, frees everything allocated since the previous reset(), keeps the initial buffer.
+	void reset() noexcept;
+
+	/// @brief Makes empty `value` allocating from the arena.
+	template< detail::PmrContainer T >
+	void bind( T & value );
+private:
+	struct bound_t {
+		void * container;
+		void (*unbind)( void * container ) noexcept;
+	};
+
+	template< class T >
+	static void unbind( void * container ) noexcept;
+
+	::std::vector<u8> initial;
+	::std::pmr::monotonic_buffer_resource resource_;
+	::std::vector<bound_t> bound;
+};
+
+namespace detail {
+
+/// @brief Makes empty `value` allocating from the arena of `context`, if any.
+template< PmrContainer T >
+inline void bind_context( void * context, T & value ) {
+	if ( auto * arena = arena_t::from( context ); arena != nullptr )
+		arena->bind( value );
+}
+
+} // namespace detail
+
+// IMPLEMENTATION lib::data::arena_t
+
+inline /*static */arena_t * arena_t::from( void * context ) noexcept {
+	static_assert( alignof(arena_t) > CONTEXT_TAG );
+	const auto address = (::std::uintptr_t) context;
+	return ( address & CONTEXT_TAG ) != 0 ? (arena_t *)( address & ~CONTEXT_TAG ) : nullptr;
+}
+
+inline /*static */::std::pmr::memory_resource * arena_t::resource( void * context ) noexcept {
+	auto * arena = from( context );
+	return arena != nullptr ? arena->resource() : nullptr;
+}
+
+inline arena_t::arena_t( usize initial_size/* = INITIAL_SIZE*/
+	, ::std::pmr::memory_resource * upstream/* = ::std::pmr::get_default_resource()*/ )
+	: initial( initial_size )
+	, resource_ {initial.data(), initial.size(), upstream}
+{}
+
+inline void arena_t::reset() noexcept {
+	for ( const auto & [ container, unbind_ ] : bound )
+		unbind_( container );
+	bound.clear();
+	resource_.release();
+}
+
+template< detail::PmrContainer T >
+inline void arena_t::bind( T & value ) {
+	// Already in the arena (nested element or bound since reset()): its memory is just abandoned.
+	if ( value.get_allocator().resource() == &resource_ ) {
+		::std::construct_at( &value, typename T::allocator_type {&resource_} );
+		return;
+	}
+	::std::destroy_at( &value );
+	::std::construct_at( &value, typename T::allocator_type {&resource_} );
+	bound.push_back({ &value, &unbind<T> });
+}
+
+template< class T >
+inline /*static */void arena_t::unbind( void * container ) noexcept {
+	// Memory of the arena is released right after, so it's just abandoned.
+	::std::construct_at( (T *) container );
+}
+
+} // namespace lib::data
+
+#endif // CPPLIB__lib__data__arena__hpp
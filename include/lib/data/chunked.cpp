@@ -0,0 +1,99 @@
+/* File: /lib/data/chunked.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <algorithm>
+
+#include <cpp/lib_debug>
+
+#include "./chunked.hpp"
+
+namespace lib::data {
+
+// IMPLEMENTATION lib::data::chunked_t
+
+void chunked_t::reset() noexcept {
+	steps.clear();
+	step_ = offset = transferred_ = 0;
+}
+
+result_t chunked_t::write( wstream_t & stream, usize limit/* = CHUNK_SIZE*/ ) {
+	CPP_ASSERT( not reading );
+	usize total = 0;
+	while ( not done() and total < limit ) {
+		auto & current = steps[step_];
+		if ( offset == current.size ) {
+			next_step();
+			continue;
+		}
+		const auto * data = current.prefix ? (const u8 *) &current.length : current.data;
+		const auto count = ::std::min( current.size - offset, limit - total );
+		const auto & written = stream.write({ data + offset, count });
+		if ( written.failed() )
+			return total == 0 ? written : result_t {total};
+		total += written.value();
+		offset += written.value();
+		transferred_ += written.value();
+		if ( written.value() < count )
+			break;
+	}
+	while ( not done() and offset == steps[step_].size )
+		next_step();
+	return total;
+}
+
+result_t chunked_t::read( rstream_t & stream, usize limit/* = CHUNK_SIZE*/, usize budget/* = BUDGET_ANY*/ ) {
+	CPP_ASSERT( reading );
+	const auto bound = budget > BUDGET_ANY - transferred_ ? BUDGET_ANY : transferred_ + budget;
+	usize total = 0;
+	while ( not done() and total < limit ) {
+		auto & current = steps[step_];
+		if ( offset == current.size ) {
+			if ( not next_step( bound ) )
+				return make_error_bad_data();
+			continue;
+		}
+		auto * data = current.prefix ? (u8 *) &current.length : current.data;
+		const auto count = ::std::min( current.size - offset, limit - total );
+		const auto & readen = stream.read({ data + offset, count });
+		if ( readen.failed() )
+			return total == 0 ? readen : result_t {total};
+		total += readen.value();
+		offset += readen.value();
+		transferred_ += readen.value();
+		if ( readen.value() < count )
+			break;
+	}
+	while ( not done() and offset == steps[step_].size )
+		if ( not next_step( bound ) )
+			return make_error_bad_data();
+	return total;
+}
+
+void chunked_t::start( usize fields ) noexcept {
+	reset();
+	steps.reserve( fields * 2 );
+}
+
+bool chunked_t::next_step( usize bound/* = BUDGET_ANY*/ ) noexcept {
+	/// @note Also called for the completed last steps right away (e.g. empty container at the end),
+	///       so done() doesn't wait for the next call.
+	const auto & current = steps[step_];
+	if ( reading and current.resize != nullptr ) {
+		// Length comes from the peer: never allocate more than is left to read.
+		if ( transferred_ > bound or (u64) current.length * current.element_size > bound - transferred_ )
+			return false;
+		const auto & elements = current.resize( current.container, current.length );
+		steps[step_ + 1].data = elements.data();
+		steps[step_ + 1].size = elements.size();
+	}
+	++step_;
+	offset = 0;
+	return true;
+}
+
+} // namespace lib::data
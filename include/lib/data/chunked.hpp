@@ -0,0 +1,154 @@
+/* File: /lib/data/chunked.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__data__chunked__hpp
+#define CPPLIB__lib__data__chunked__hpp
+
+#include <limits>
+#include <vector>
+
+#include <cpp/lib_concepts>
+
+#include "../../lib/types.hpp"
+
+#include "./buffer.hpp"
+#include "./stream.hpp"
+
+namespace lib::data {
+
+// DECLARATION lib::data::ChunkedField
+
+/// @brief Field supported by chunked_t: trivial value or contiguous container of trivial elements.
+template< class T >
+concept ChunkedField = ( ::cpp::Trivial<T> and not ::cpp::Pointer<T> )
+	or ( ::cpp::ContiguousContainer<T>
+	and ::cpp::Trivial<typename T::value_type>
+	and not ::cpp::Pointer<typename T::value_type> );
+
+// DECLARATION lib::data::chunked_t
+
+/** @brief Resumable serialization and deserialization of a list of fields in bounded chunks.
+ *  @details Every write()/read() call transfers at most `limit` bytes and returns, the position
+ *  (field and offset inside of it) is kept between calls, so an object of any size goes through
+ *  the stream without being buffered as a whole:
+ *
+ *      chunked.serialize( id, blob );
+ *      while ( not chunked.done() )
+ *          chunked.write( stream );	// e.g. when the socket becomes writable
+ *
+ *  Wire format is the same as of serialize()/deserialize() of the same fields (container is
+ *  u32 length followed by elements), so the peer may use either of them.
+ *
+ *  @note Fields are referenced: they have to stay valid (and unchanged when serializing) until
+ *        done(). Containers are resized as soon as their length is read.
+ */
+class chunked_t {
+public:
+	static constexpr usize CHUNK_SIZE = 16 * 1024;
+	static constexpr usize BUDGET_ANY = ::std::numeric_limits<usize>::max();
+
+	chunked_t() = default;
+
+	template< ChunkedField...Args >
+	void serialize( const Args &...values );
+	template< ChunkedField...Args >
+	void deserialize( Args &...values );
+	void reset() noexcept;
+
+	/// @return Count of bytes written during this call.
+	result_t write( wstream_t & stream, usize limit = CHUNK_SIZE );
+	/** @param budget Bytes left for the fields (e.g. rest of the payload they are read from).
+	 *  @return Count of bytes read during this call, bad data error if a container length doesn't fit
+	 *          into the budget (the container isn't resized).
+	 */
+	result_t read( rstream_t & stream, usize limit = CHUNK_SIZE, usize budget = BUDGET_ANY );
+
+	bool done() const noexcept { return step_ == steps.size(); }
+	/// @brief Bytes transferred since serialize()/deserialize().
+	usize transferred() const noexcept { return transferred_; }
+private:
+	struct step {
+		u8 * data = nullptr;
+		usize size = 0;
+		/// @brief Length prefix of a container: transferred through `length`.
+		bool prefix = false;
+		u32 length = 0;
+		usize element_size = 0;
+		/// @brief Deserialization: resizes `container` and returns memory of its elements.
+		buffer_t (*resize)( void * container, usize length ) = nullptr;
+		void * container = nullptr;
+	};
+
+	template< class T >
+	static buffer_t resize_container( void * container, usize length );
+
+	template< class T >
+	void plan_write( const T & value );
+	template< class T >
+	void plan_read( T & value );
+	void start( usize fields ) noexcept;
+	/** @brief Moves to the next step, deserialization: resizes container which length has been read.
+	 *  @return false if elements of the container take more than `bound - transferred()` bytes.
+	 */
+	bool next_step( usize bound = BUDGET_ANY ) noexcept;
+
+	::std::vector<step> steps;
+	usize step_ = 0;
+	usize offset = 0;
+	usize transferred_ = 0;
+	bool reading = false;
+};
+
+// IMPLEMENTATION lib::data::chunked_t
+
+template< ChunkedField...Args >
+inline void chunked_t::serialize( const Args &...values ) {
+	start( sizeof...(Args) );
+	reading = false;
+	( plan_write( values ), ... );
+}
+
+template< ChunkedField...Args >
+inline void chunked_t::deserialize( Args &...values ) {
+	start( sizeof...(Args) );
+	reading = true;
+	( plan_read( values ), ... );
+}
+
+template< class T >
+inline /*static */buffer_t chunked_t::resize_container( void * container, usize length ) {
+	auto & value = *(T *) container;
+	value.resize( length );
+	return { value.data(), length * sizeof(typename T::value_type) };
+}
+
+template< class T >
+inline void chunked_t::plan_write( const T & value ) {
+	if constexpr ( ::cpp::Trivial<T> )
+		steps.push_back({ .data = (u8 *) &value, .size = sizeof(value) });
+	else {
+		steps.push_back({ .size = sizeof(u32), .prefix = true, .length = (u32) value.size() });
+		steps.push_back({ .data = (u8 *) value.data(), .size = value.size() * sizeof(typename T::value_type) });
+	}
+}
+
+template< class T >
+inline void chunked_t::plan_read( T & value ) {
+	if constexpr ( ::cpp::Trivial<T> )
+		steps.push_back({ .data = (u8 *) &value, .size = sizeof(value) });
+	else {
+		static_assert( requires { value.resize( 0 ); }, "Container has to be resizable to be deserialized." );
+		steps.push_back({ .size = sizeof(u32), .prefix = true, .element_size = sizeof(typename T::value_type)
+			, .resize = &resize_container<T>, .container = &value });
+		// Elements step is filled once the length is known.
+		steps.push_back({});
+	}
+}
+
+} // namespace lib::data
+
+#endif // CPPLIB__lib__data__chunked__hpp
@@ -0,0 +1,219 @@
+/* File: /lib/data/fields.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__data__fields__hpp
+#define CPPLIB__lib__data__fields__hpp
+
+#include <tuple>
+#include <utility>
+
+#include "../../lib/types.hpp"
+#include "../../lib/literals.hpp"
+
+#include "./serialize.hpp"
+
+namespace lib::data {
+
+// DECLARATION lib::data::*_fields<>
+
+/** @brief Serialization of a field list: adjacent trivial fields are merged into runs.
+ *  @details Every run of trivial fields goes through a single write()/read() (see TrivialPack),
+ *  other fields use their own overloads, so for `u32, u16, vector<u8>, u64, u8` there are
+ *  three calls of serialize() instead of five. Wire format is the same as of serialize( stream, fields... ).
+ *  @note As with serialize(), overloads of non-trivial fields (e.g. impl/serialize/ headers) have to be
+ *        included before this header.
+ */
+
+template< WriteStream S, class...Args >
+constexpr inline result_t serialized_size_fields( S & stream, const Args &...values );
+template< ReadStream S, class...Args >
+constexpr inline bool can_deserialize_fields( S & stream, const Args &...values );
+template< WriteStream S, class...Args >
+constexpr inline result_t serialize_fields( S & stream, const Args &...values );
+template< ReadStream S, class...Args >
+constexpr inline result_t deserialize_fields( S & stream, Args &...values );
+template< ReadStream S, class...Args >
+constexpr inline result_t deserialize_fields( void * context, S & stream, Args &...values );
+
+} // namespace lib::data
+
+// DECLARATION lib::tag_serializeable_fields<>
+
+namespace lib {
+
+/** @brief Implements tag_serializeable for `Derived` from a list of its member pointers:
+ *
+ *      struct Packet : tag_serializeable_fields<Packet> {
+ *          u32 id;
+ *          ::std::vector<u8> payload;
+ *          static constexpr auto fields = ::std::tuple { &Packet::id, &Packet::payload };
+ *      };
+ *
+ *  Fields are (de)serialized in the order of the list, see data::serialize_fields().
+ */
+template< class Derived >
+class tag_serializeable_fields
+	: public tag_serializeable
+{
+public:
+	data::result_t serialized_size( data::wstream_t & stream ) const override;
+	bool can_deserialize( data::rstream_t & stream ) const override;
+	data::result_t serialize( data::wstream_t & stream ) const override;
+	data::result_t deserialize( data::rstream_t & stream ) override;
+	data::result_t deserialize( void * context, data::rstream_t & stream ) override;
+private:
+	constexpr const Derived & self() const noexcept { return static_cast<const Derived &>( *this ); }
+	constexpr Derived & self() noexcept { return static_cast<Derived &>( *this ); }
+};
+
+} // namespace lib
+
+namespace lib::data {
+
+// IMPLEMENTATION lib::data::*_fields<>
+
+namespace detail {
+
+/// @brief Count of trivial fields starting from `offset`.
+template< class...Args >
+constexpr usize trivial_run( usize offset ) noexcept {
+	constexpr bool trivial[] = { TrivialPack<Args>..., false };
+	usize count = 0;
+	while ( offset + count < sizeof...(Args) and trivial[offset + count] )
+		++count;
+	return count;
+}
+
+/// @brief Serialized size of trivial fields [offset, offset + count).
+template< class...Args >
+constexpr usize trivial_run_size( usize offset, usize count ) noexcept {
+	constexpr usize sizes[] = { sizeof(Args)..., 0 };
+	usize size = 0;
+	for ( usize i = offset; i < offset + count; ++i )
+		size += sizes[i];
+	return size;
+}
+
+/// @brief Run of trivial fields goes as a single pack, other field is passed as is.
+template< usize Offset, WriteStream S, class Tuple, usize...I >
+constexpr inline result_t serialize_run( S & stream, const Tuple & values, ::std::index_sequence<I...> )
+{ return ::lib::data::serialize( stream, ::std::get<Offset + I>( values )... ); }
+
+template< usize Offset, bool Context, ReadStream S, class Tuple, usize...I >
+constexpr inline result_t deserialize_run( void * context, S & stream, const Tuple & values, ::std::index_sequence<I...> ) {
+	if constexpr ( Context and sizeof...(I) == 1 )
+		return ::lib::data::deserialize( context, stream, ::std::get<Offset + I>( values )... );
+	else
+		return ::lib::data::deserialize( stream, ::std::get<Offset + I>( values )... );
+}
+
+template< usize Offset, WriteStream S, class...Args >
+constexpr inline result_t serialize_fields( S & stream, const ::std::tuple<const Args &...> & values ) {
+	if constexpr ( Offset == sizeof...(Args) )
+		return 0_sz;
+	else {
+		constexpr auto run = trivial_run<Args...>( Offset );
+		constexpr auto count = run > 0 ? run : 1_sz;
+		const auto & written = serialize_run<Offset>( stream, values, ::std::make_index_sequence<count>{} );
+		if ( written.failed() )
+			return written;
+		if constexpr ( run > 0 )
+			if ( written != trivial_run_size<Args...>( Offset, run ) )
+				return written;
+		const auto & others = serialize_fields<Offset + count>( stream, values );
+		if ( others.failed() )
+			return others;
+		return written.value() + others.value();
+	}
+}
+
+template< usize Offset, bool Context, ReadStream S, class...Args >
+constexpr inline result_t deserialize_fields( void * context, S & stream, const ::std::tuple<Args &...> & values ) {
+	if constexpr ( Offset == sizeof...(Args) )
+		return 0_sz;
+	else {
+		constexpr auto run = trivial_run<Args...>( Offset );
+		constexpr auto count = run > 0 ? run : 1_sz;
+		const auto & readen = deserialize_run<Offset, Context>( context, stream, values, ::std::make_index_sequence<count>{} );
+		if ( readen.failed() )
+			return readen;
+		if constexpr ( run > 0 )
+			if ( readen != trivial_run_size<Args...>( Offset, run ) )
+				return readen;
+		const auto & others = deserialize_fields<Offset + count, Context>( context, stream, values );
+		if ( others.failed() )
+			return others;
+		return readen.value() + others.value();
+	}
+}
+
+} // namespace detail
+
+template< WriteStream S, class...Args >
+constexpr inline result_t serialized_size_fields( S & stream, const Args &...values )
+{ return serialized_size( stream, values... ); }
+
+template< ReadStream S, class...Args >
+constexpr inline bool can_deserialize_fields( S & stream, const Args &...values )
+{ return can_deserialize( stream, values... ); }
+
+template< WriteStream S, class...Args >
+constexpr inline result_t serialize_fields( S & stream, const Args &...values )
+{ return detail::serialize_fields<0>( stream, ::std::tuple<const Args &...> {values...} ); }
+
+template< ReadStream S, class...Args >
+constexpr inline result_t deserialize_fields( S & stream, Args &...values )
+{ return detail::deserialize_fields<0, false>( nullptr, stream, ::std::tuple<Args &...> {values...} ); }
+
+template< ReadStream S, class...Args >
+constexpr inline result_t deserialize_fields( void * context, S & stream, Args &...values )
+{ return detail::deserialize_fields<0, true>( context, stream, ::std::tuple<Args &...> {values...} ); }
+
+} // namespace lib::data
+
+// IMPLEMENTATION lib::tag_serializeable_fields<>
+
+namespace lib {
+
+template< class Derived >
+inline data::result_t tag_serializeable_fields<Derived>::serialized_size( data::wstream_t & stream ) const/* override*/ {
+	return ::std::apply( [&]( auto...fields ) {
+		return data::serialized_size_fields( stream, self().*fields... );
+	}, Derived::fields );
+}
+
+template< class Derived >
+inline bool tag_serializeable_fields<Derived>::can_deserialize( data::rstream_t & stream ) const/* override*/ {
+	return ::std::apply( [&]( auto...fields ) {
+		return data::can_deserialize_fields( stream, self().*fields... );
+	}, Derived::fields );
+}
+
+template< class Derived >
+inline data::result_t tag_serializeable_fields<Derived>::serialize( data::wstream_t & stream ) const/* override*/ {
+	return ::std::apply( [&]( auto...fields ) {
+		return data::serialize_fields( stream, self().*fields... );
+	}, Derived::fields );
+}
+
+template< class Derived >
+inline data::result_t tag_serializeable_fields<Derived>::deserialize( data::rstream_t & stream )/* override*/ {
+	return ::std::apply( [&]( auto...fields ) {
+		return data::deserialize_fields( stream, self().*fields... );
+	}, Derived::fields );
+}
+
+template< class Derived >
+inline data::result_t tag_serializeable_fields<Derived>::deserialize( void * context, data::rstream_t & stream )/* override*/ {
+	return ::std::apply( [&]( auto...fields ) {
+		return data::deserialize_fields( context, stream, self().*fields... );
+	}, Derived::fields );
+}
+
+} // namespace lib
+
+#endif // CPPLIB__lib__data__fields__hpp
@@ -8,6 +8,8 @@
 #ifndef CPPLIB__lib__data__serialize__hpp
 #define CPPLIB__lib__data__serialize__hpp
 
+#include <cstring>
+
 #include <type_traits>
 
 #include <cpp/lib_concepts>
@@ -17,6 +19,10 @@
 
 #include "./stream.hpp"
 
+namespace lib::data {
+class chunked_t;
+} // namespace lib::data
+
 // DECLARATION lib::tag_serializeable
 
 namespace lib {
@@ -30,32 +36,83 @@ public:
 	virtual data::result_t serialize( data::wstream_t & stream ) const = 0;
 	virtual data::result_t deserialize( data::rstream_t & stream ) = 0;
 	virtual data::result_t deserialize( void * /*context*/, data::rstream_t & stream ) { return deserialize( stream ); }
+	/// @brief Optional resumable (de)serialization, see data::chunked_t.
+	/// @return false if not supported.
+	virtual bool serialize_chunked( data::chunked_t & /*chunked*/ ) const { return false; }
+	virtual bool deserialize_chunked( data::chunked_t & /*chunked*/ ) { return false; }
 };
 
 } // namespace lib
 
 namespace lib::data {
 
+/// @note Overloads are templated over stream type: with a final stream implementation (e.g.
+///       stream::impl::data or stream::impl::fifo) calls are resolved and inlined statically,
+///       with rstream_t/wstream_t they go through virtual interface as before.
+
+// DECLARATION lib::data::TrivialPack, lib::data::trivial_size_v
+
+/// @brief Values copied as is: pack of them has serialized size known at compile time.
+template< class...Args >
+concept TrivialPack = ( ( ::cpp::Trivial<Args> and not ::cpp::Pointer<Args> ) and ... );
+
+template< class...Args >requires( TrivialPack<Args...> )
+inline constexpr usize trivial_size_v = ( 0_sz + ... + sizeof(Args) );
+
+/// @brief Trivial packs up to this size are serialized with a single write()/read() through a stack buffer.
+inline constexpr usize TRIVIAL_PACK_MAX = 256;
+
+namespace detail {
+
+template< class...Args >
+concept Packable = sizeof...(Args) > 1 and TrivialPack<Args...> and trivial_size_v<Args...> <= TRIVIAL_PACK_MAX;
+
+template< WriteStream S, class...Args >
+constexpr inline result_t serialize_packed( S & stream, const Args &...values ) {
+	u8 packed[trivial_size_v<Args...>];
+	usize offset = 0;
+	( ( ::std::memcpy( packed + offset, &values, sizeof(values) ), offset += sizeof(values) ), ... );
+	return stream.write({ packed, sizeof(packed) });
+}
+
+/// @note On a short read only values read completely are assigned.
+template< ReadStream S, class...Args >
+constexpr inline result_t deserialize_packed( S & stream, Args &...values ) {
+	u8 packed[trivial_size_v<Args...>];
+	const auto & read_result = stream.read({ packed, sizeof(packed) });
+	if ( read_result.failed() )
+		return read_result;
+	usize offset = 0;
+	( ( offset + sizeof(values) <= read_result.value()
+		? ( ::std::memcpy( &values, packed + offset, sizeof(values) ), offset += sizeof(values) )
+		: offset = sizeof(packed) ), ... );
+	return read_result;
+}
+
+} // namespace detail
+
 // DEFINITION lib::data::serialized_size<>
 
-template< ::cpp::Trivial T >requires( not ::cpp::Pointer<T> )
-constexpr inline result_t serialized_size( wstream_t &/* stream*/, const T & value )
+template< WriteStream S, ::cpp::Trivial T >requires( not ::cpp::Pointer<T> )
+constexpr inline result_t serialized_size( S &/* stream*/, const T & value )
 { return sizeof(value); }
 
 template< ::cpp::Void T >
 constexpr inline result_t serialized_size()
 { return 0_sz; }
 
-template< class T >
-constexpr inline result_t serialized_size( wstream_t & stream, const T * value )
+template< WriteStream S, class T >
+constexpr inline result_t serialized_size( S & stream, const T * value )
 { return value != nullptr ? serialized_size( stream, *value ) : result_t {make_serialize_error_null_data()}; }
 
-template< class T >requires( ::std::is_base_of_v<tag_serializeable, T> )
-constexpr inline result_t serialized_size( wstream_t & stream, const T & value )
+template< WriteStream S, class T >requires( ::std::is_base_of_v<wstream_t, S> and ::std::is_base_of_v<tag_serializeable, T> )
+constexpr inline result_t serialized_size( S & stream, const T & value )
 { return value.serialized_size( stream ); }
 
-template< class T, class...Args >requires( sizeof...(Args) > 0 )
-constexpr inline result_t serialized_size( wstream_t & stream, const T & value, const Args &...others ) {
+template< WriteStream S, class T, class...Args >requires( sizeof...(Args) > 0 )
+constexpr inline result_t serialized_size( S & stream, const T & value, const Args &...others ) {
+	if constexpr ( TrivialPack<T, Args...> )
+		return trivial_size_v<T, Args...>;
 	const auto & value_sz = serialized_size( stream, value );
 	if ( value_sz.failed() ) return value_sz;
 	const auto & others_sz = serialized_size( stream, others... );
@@ -65,8 +122,8 @@ constexpr inline result_t serialized_size( wstream_t & stream, const T & value,
 
 // DEFINITION lib::data::can_deserialize<>
 
-template< ::cpp::Trivial T >requires( not ::cpp::Pointer<T> )
-constexpr inline bool can_deserialize( rstream_t & stream, const T & value ) {
+template< ReadStream S, ::cpp::Trivial T >requires( not ::cpp::Pointer<T> )
+constexpr inline bool can_deserialize( S & stream, const T & value ) {
 	const auto & read_size = stream.read_size();
 	return read_size.success() and read_size >= sizeof(value);
 }
@@ -75,22 +132,27 @@ template< ::cpp::Void T >
 constexpr inline bool can_deserialize()
 { return true; }
 
-template< class T >
-constexpr inline bool can_deserialize( rstream_t & stream, const T * value )
+template< ReadStream S, class T >
+constexpr inline bool can_deserialize( S & stream, const T * value )
 { return value != nullptr ? can_deserialize( stream, *value ) : false; }
 
-template< class T >requires( ::std::is_base_of_v<tag_serializeable, T> )
-constexpr inline bool can_deserialize( rstream_t & stream, const T & value )
+template< ReadStream S, class T >requires( ::std::is_base_of_v<rstream_t, S> and ::std::is_base_of_v<tag_serializeable, T> )
+constexpr inline bool can_deserialize( S & stream, const T & value )
 { return value.can_deserialize( stream ); }
 
-template< class T, class...Args >requires( sizeof...(Args) > 0 )
-constexpr inline bool can_deserialize( rstream_t & stream, const T & value, const Args &...others )
-{ return can_deserialize( stream, value ) and can_deserialize( stream, others... ); }
+template< ReadStream S, class T, class...Args >requires( sizeof...(Args) > 0 )
+constexpr inline bool can_deserialize( S & stream, const T & value, const Args &...others ) {
+	if constexpr ( TrivialPack<T, Args...> ) {
+		const auto & read_size = stream.read_size();
+		return read_size.success() and read_size >= trivial_size_v<T, Args...>;
+	} else
+		return can_deserialize( stream, value ) and can_deserialize( stream, others... );
+}
 
 // DEFINITION lib::data::serialize<>
 
-template< ::cpp::Trivial T >requires( not ::cpp::Pointer<T> )
-constexpr inline result_t serialize( wstream_t & stream, const T & value ) {
+template< WriteStream S, ::cpp::Trivial T >requires( not ::cpp::Pointer<T> )
+constexpr inline result_t serialize( S & stream, const T & value ) {
 	const auto & write_size = serialized_size( stream, value );
 	return write_size.success() ? stream.write({ &value, write_size.value() }) : write_size;
 }
@@ -99,16 +161,18 @@ template< ::cpp::Void T >
 constexpr inline result_t serialize()
 { return 0_sz; }
 
-template< class T >
-constexpr inline result_t serialize( wstream_t & stream, const T * value )
+template< WriteStream S, class T >
+constexpr inline result_t serialize( S & stream, const T * value )
 { return value != nullptr ? serialize( stream, *value ) : result_t {make_serialize_error_null_data()}; }
 
-template< class T >requires( ::std::is_base_of_v<tag_serializeable, T> )
-constexpr inline result_t serialize( wstream_t & stream, const T & value )
+template< WriteStream S, class T >requires( ::std::is_base_of_v<wstream_t, S> and ::std::is_base_of_v<tag_serializeable, T> )
+constexpr inline result_t serialize( S & stream, const T & value )
 { return value.serialize( stream ); }
 
-template< class T, class...Args >requires( sizeof...(Args) > 0 )
-constexpr inline result_t serialize( wstream_t & stream, const T & value, const Args &...others ) {
+template< WriteStream S, class T, class...Args >requires( sizeof...(Args) > 0 )
+constexpr inline result_t serialize( S & stream, const T & value, const Args &...others ) {
+	if constexpr ( detail::Packable<T, Args...> )
+		return detail::serialize_packed( stream, value, others... );
 	const auto & value_sz = serialize( stream, value );
 	if ( value_sz.failed() ) return value_sz;
 	const auto & others_sz = serialize( stream, others... );
@@ -118,24 +182,26 @@ constexpr inline result_t serialize( wstream_t & stream, const T & value, const
 
 // DEFINITION lib::data::deserialize<>
 
-template< ::cpp::Trivial T >requires( not ::cpp::Pointer<T> )
-constexpr inline result_t deserialize( rstream_t & stream, T & value )
+template< ReadStream S, ::cpp::Trivial T >requires( not ::cpp::Pointer<T> )
+constexpr inline result_t deserialize( S & stream, T & value )
 { return stream.read({ &value, sizeof(value) }); }
 
 template< ::cpp::Void T >
 constexpr inline result_t deserialize()
 { return 0_sz; }
 
-template< class T >
-constexpr inline result_t deserialize( rstream_t & stream, T * value )
+template< ReadStream S, class T >
+constexpr inline result_t deserialize( S & stream, T * value )
 { return value != nullptr ? deserialize( stream, *value ) : result_t {make_serialize_error_null_data()}; }
 
-template< class T >requires( ::std::is_base_of_v<tag_serializeable, T> )
-constexpr inline result_t deserialize( rstream_t & stream, T & value )
+template< ReadStream S, class T >requires( ::std::is_base_of_v<rstream_t, S> and ::std::is_base_of_v<tag_serializeable, T> )
+constexpr inline result_t deserialize( S & stream, T & value )
 { return value.deserialize( stream ); }
 
-template< class T, class...Args >requires( sizeof...(Args) > 0 )
-constexpr inline result_t deserialize( rstream_t & stream, T & value, Args &...others ) {
+template< ReadStream S, class T, class...Args >requires( sizeof...(Args) > 0 )
+constexpr inline result_t deserialize( S & stream, T & value, Args &...others ) {
+	if constexpr ( detail::Packable<T, Args...> )
+		return detail::deserialize_packed( stream, value, others... );
 	const auto & value_sz = deserialize( stream, value );
 	if ( value_sz.failed() ) return value_sz;
 	const auto & others_sz = deserialize( stream, others... );
@@ -145,20 +211,25 @@ constexpr inline result_t deserialize( rstream_t & stream, T & value, Args &...o
 
 // DEFINITION lib::data::deserialize<>( context )
 
-template< ::cpp::Trivial T >requires( not ::cpp::Pointer<T> )
-constexpr inline result_t deserialize( void * /*context*/, rstream_t & stream, T & value )
+/// @note Library overloads take memory for deserialized containers with polymorphic allocator and
+///       pointees from `context` if it is data::arena_t::context(), other contexts (and nullptr) are ignored.
+
+template< ReadStream S, ::cpp::Trivial T >requires( not ::cpp::Pointer<T> )
+constexpr inline result_t deserialize( void * /*context*/, S & stream, T & value )
 { return deserialize( stream, value ); }
 
-template< class T >
-constexpr inline result_t deserialize( void * context, rstream_t & stream, T * value )
+template< ReadStream S, class T >
+constexpr inline result_t deserialize( void * context, S & stream, T * value )
 { return value != nullptr ? deserialize( context, stream, *value ) : result_t {make_serialize_error_null_data()}; }
 
-template< class T >requires( ::std::is_base_of_v<tag_serializeable, T> )
-constexpr inline result_t deserialize( void * context, rstream_t & stream, T & value )
+template< ReadStream S, class T >requires( ::std::is_base_of_v<rstream_t, S> and ::std::is_base_of_v<tag_serializeable, T> )
+constexpr inline result_t deserialize( void * context, S & stream, T & value )
 { return value.deserialize( context, stream ); }
 
-template< class T, class...Args >requires( sizeof...(Args) > 0 )
-constexpr inline result_t deserialize( void * context, rstream_t & stream, T & value, Args &...others ) {
+template< ReadStream S, class T, class...Args >requires( sizeof...(Args) > 0 )
+constexpr inline result_t deserialize( void * context, S & stream, T & value, Args &...others ) {
+	if constexpr ( detail::Packable<T, Args...> )
+		return detail::deserialize_packed( stream, value, others... );
 	const auto & value_sz = deserialize( context, stream, value );
 	if ( value_sz.failed() ) return value_sz;
 	const auto & others_sz = deserialize( context, stream, others... );
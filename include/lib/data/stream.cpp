@@ -0,0 +1,113 @@
+/* File: /lib/data/stream.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <algorithm>
+
+#include <cpp/lib_debug>
+
+#include "./stream.hpp"
+
+namespace lib::data {
+
+// IMPLEMENTATION lib::data::rstream_t
+
+/*virtual */result_t rstream_t::readv( ::std::span<const buffer_t> buffers ) {
+	usize total = 0;
+	for ( const auto & buffer : buffers ) {
+		const auto & count = read( buffer );
+		if ( count.failed() )
+			return total == 0 ? count : result_t {total};
+		total += count.value();
+		if ( count.value() < buffer.size() )
+			break;
+	}
+	return total;
+}
+
+// IMPLEMENTATION lib::data::wstream_t
+
+/*virtual */result_t wstream_t::writev( ::std::span<const cbuffer_t> buffers ) {
+	usize total = 0;
+	for ( const auto & buffer : buffers ) {
+		const auto & count = write( buffer );
+		if ( count.failed() )
+			return total == 0 ? count : result_t {total};
+		total += count.value();
+		if ( count.value() < buffer.size() )
+			break;
+	}
+	return total;
+}
+
+/*virtual */result_t wstream_t::transfer_from( rstream_t & source, usize count/* = TRANSFER_ALL*/ ) {
+	/// @brief Size of the stack buffer used when `source` has no contiguous view of its data.
+	static constexpr usize CHUNK_SIZE = 16 * 1024;
+
+	const auto & write_size_ = write_size();
+	if ( write_size_.success() )
+		count = ::std::min( count, write_size_.value() );
+
+	usize total = 0;
+	const auto done = [&total]( const result_t & result ) {
+		return total == 0 and result.failed() ? result : result_t {total};
+	};
+
+	// Zero-copy: write directly from the source's storage, then move its read position.
+	while ( total < count ) {
+		const auto & view = source.read_cbuffer();
+		if ( view.empty() )
+			break;
+		const auto & position = source.read_pos();
+		if ( position.failed() )
+			break;
+		const auto & written = write( view.first( ::std::min( view.size(), count - total ) ) );
+		if ( written.failed() )
+			return done( written );
+		total += written.value();
+		CPP_UNUSED( source.read_pos( position.value() + written.value() ) );
+		if ( written.value() < view.size() )
+			return total;
+	}
+
+	u8 chunk[CHUNK_SIZE];
+	// Copy through peek(): nothing is consumed from the source until it has been written.
+	while ( total < count ) {
+		const auto & peeked = source.peek({ chunk, ::std::min( CHUNK_SIZE, count - total ) });
+		if ( peeked.failed() and peeked.error() == make_error_not_implemented() )
+			break;
+		if ( peeked.failed() or peeked.value() == 0 )
+			return done( peeked );
+		const auto & written = write({ chunk, peeked.value() });
+		if ( written.failed() )
+			return done( written );
+		CPP_UNUSED( source.read({ chunk, written.value() }) );
+		total += written.value();
+		if ( written.value() < peeked.value() )
+			return total;
+	}
+
+	// Copy through read(): bytes read from the source are retried while the stream makes progress,
+	// the rest of them is lost if it doesn't.
+	while ( total < count ) {
+		const auto & received = source.read({ chunk, ::std::min( CHUNK_SIZE, count - total ) });
+		if ( received.failed() or received.value() == 0 )
+			return done( received );
+		for ( usize offset = 0; offset < received.value(); ) {
+			const auto & written = write({ chunk + offset, received.value() - offset });
+			if ( written.failed() or written.value() == 0 ) {
+				total += offset;
+				return done( written );
+			}
+			offset += written.value();
+		}
+		total += received.value();
+	}
+	return total;
+}
+
+} // namespace lib::data
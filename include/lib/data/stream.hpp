@@ -8,8 +8,12 @@
 #ifndef CPPLIB__lib__data__stream__hpp
 #define CPPLIB__lib__data__stream__hpp
 
+#include <limits>
+#include <span>
 #include <system_error>
 
+#include <cpp/lib_concepts>
+
 #include "../../lib/tl/result.hpp"
 #include "../../lib/types.hpp"
 #include "../../lib/system/error.hpp"
@@ -24,6 +28,25 @@ namespace lib::data {
 
 using result_t = tl::result_numeric_t<usize>;
 
+// DECLARATION lib::data::ReadStream, lib::data::WriteStream
+
+/** @brief Statically dispatched stream interfaces.
+ *  Satisfied by rstream_t/wstream_t themselves (virtual calls) and by their final implementations,
+ *  which lets templated code (e.g. serialization) call implementation directly and inline it.
+ */
+template< class S >
+concept ReadStream = requires( S & stream, const buffer_t & buffer ) {
+	{ stream.read( buffer ) } -> ::cpp::SameAs<result_t>;
+	{ stream.peek( buffer ) } -> ::cpp::SameAs<result_t>;
+	{ stream.read_size() } -> ::cpp::SameAs<result_t>;
+};
+
+template< class S >
+concept WriteStream = requires( S & stream, const cbuffer_t & buffer ) {
+	{ stream.write( buffer ) } -> ::cpp::SameAs<result_t>;
+	{ stream.write_size() } -> ::cpp::SameAs<result_t>;
+};
+
 // DECLARATION lib::data::rstream_t
 
 class rstream_t {
@@ -31,6 +54,8 @@ public:
 	virtual ~rstream_t() = default;
 
 	virtual result_t read( const buffer_t & buffer ) = 0;
+	/// @brief Scatter read: fills `buffers` one by one, stops at the first one filled partially.
+	virtual result_t readv( ::std::span<const buffer_t> buffers );
 	virtual result_t peek( const buffer_t &/* buffer*/ ) { return make_error_not_implemented(); }
 	virtual bool read_flush() { return false; }
 
@@ -41,6 +66,8 @@ public:
 	virtual cbuffer_t read_cbuffer( bool/* flush*/ ) { return {}; }
 	buffer_t read_buffer() { return read_buffer( false ); }
 	cbuffer_t read_cbuffer() { return read_cbuffer( false ); }
+	/// @brief POSIX descriptor which data is read from (at read_pos() if seekable), -1 if none.
+	virtual int read_fd() { return -1; }
 
 	virtual ::std::error_condition read_error() const = 0;
 };
@@ -49,9 +76,13 @@ public:
 
 class wstream_t {
 public:
+	static constexpr usize TRANSFER_ALL = ::std::numeric_limits<usize>::max();
+
 	virtual ~wstream_t() = default;
 
 	virtual result_t write( const cbuffer_t & buffer ) = 0;
+	/// @brief Gather write: writes `buffers` one by one, stops at the first one written partially.
+	virtual result_t writev( ::std::span<const cbuffer_t> buffers );
 	/// @todo Add rewrite(pos, buffer) ?
 	virtual bool write_flush() { return false; }
 
@@ -62,6 +93,17 @@ public:
 	virtual cbuffer_t write_cbuffer( bool/* flush*/ ) { return {}; }
 	buffer_t write_buffer() { return write_buffer( false ); }
 	cbuffer_t write_cbuffer() { return write_cbuffer( false ); }
+	/// @brief POSIX descriptor which data is written to, -1 if none.
+	virtual int write_fd() { return -1; }
+
+	/** @brief Moves up to `count` bytes from `source`, stops at the end of `source` or at a short write.
+	 *  Default implementation writes source's read_cbuffer() directly if possible and copies
+	 *  through peek()/read() otherwise, descriptor based streams may override it with
+	 *  kernel side copy (sendfile(), splice()).
+	 *  @note Only transferred bytes are consumed from `source`, except of sources without peek() and
+	 *        contiguous view: bytes read from them which the stream fails to take are lost.
+	 */
+	virtual result_t transfer_from( rstream_t & source, usize count = TRANSFER_ALL );
 
 	virtual ::std::error_condition write_error() const = 0;
 };
@@ -9,8 +9,11 @@
 #define CPPLIB__lib__debug__hexdump__hpp
 
 #include <cstdio>
+#include <cstring>
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <limits>
 
 #include "../../lib/types.hpp"
@@ -26,6 +29,9 @@ namespace lib::debug {
 // DECLARATION lib::debug::hexdump
 
 /** @brief Hexdump printer
+ *  @details Rows are rendered with lookup tables into a local buffer, which is written
+ *  with a single fwrite() per ROWS_BATCH rows. render() can be used directly to format
+ *  parts of a large buffer concurrently (see hexdump.cpp).
  *  @note The idea of using CP437 codepage was taken from [Blinkenlights](https://github.com/jart/blink) project,
  *  developed by Justine Alexandra Roberts Tunney.
  *  @see https://github.com/jart/blink
@@ -33,6 +39,9 @@ namespace lib::debug {
 
 struct hexdump {
 	static constexpr usize COLUMNS = 16;
+	/// @brief Upper bound of a rendered row: address, hex, separators, UTF-8 CP437 chars and '\n'.
+	static constexpr usize ROW_SIZE_MAX = 2 * sizeof(usize) + 3 + COLUMNS * 3 + 3 + COLUMNS * 3 + 1;
+	static constexpr usize ROWS_BATCH = 64;
 
 	enum Options
 		{ NONE		= 0x00
@@ -56,59 +65,124 @@ struct hexdump {
 	hexdump( const hexdump & ) = delete;
 	hexdump( hexdump && ) = delete;
 
+	/// @brief Size of `output` sufficient for render() of `size` bytes.
+	static constexpr usize render_size( usize size ) noexcept { return ( size + COLUMNS - 1 ) / COLUMNS * ROW_SIZE_MAX; }
+	/// @brief Hex digits of the offset column sufficient for offsets up to `last_offset`.
+	static constexpr usize offset_digits( usize last_offset ) noexcept;
+	/** @brief Renders rows of `buffer` to `output` (at least render_size( buffer.size() ) chars).
+	 *  @param offset Offset of the first byte of `buffer`, printed if Options::OFFSET is set.
+	 *  @param digits Min width of the offset column, offset_digits( offset + buffer.size() ) if 0.
+	 *  @return Count of chars written.
+	 */
+	static usize render( const data::cbuffer_t & buffer, char * output, Options options = internal, usize offset = 0, usize digits = 0 ) noexcept;
+
 private:
-	static const char * select_prefix( usize size, const Flag<Options> & options ) noexcept;
+	struct glyph {
+		char data[3];
+		u8 size;
+	};
+
+	static constexpr auto HEX = []() {
+		::std::array<::std::array<char, 2>, 256> table {};
+		for ( usize i = 0; i < table.size(); ++i )
+			table[i] = { hex( (u8) i, true ), hex( (u8) i, false ) };
+		return table;
+	}();
+
+	static constexpr auto GLYPHS = []() {
+		::std::array<glyph, 256> table {};
+		for ( usize i = 0; i < table.size(); ++i ) {
+			const auto value = utils::cp437( (u8) i );
+			for ( usize j = 0; j < value.size(); ++j )
+				table[i].data[j] = value[j];
+			table[i].size = (u8) value.size();
+		}
+		return table;
+	}();
+
+	static char * render_prefix( char * output, usize value, usize digits ) noexcept;
 };
 
 // INLINES lib::debug::hexdump
 
 inline hexdump::hexdump( const data::cbuffer_t & buffer, Options options_/* = internal*/, usize offset/* = 0*/ ) noexcept {
-	Flag<Options> options {options_};
+	static constexpr usize BATCH_BYTES = ROWS_BATCH * COLUMNS;
+	const Flag<Options> options {options_};
 	auto * f = options.check( STDOUT ) ? stdout : stderr;
-	const char * prefix = select_prefix( buffer.size(), options );
+	const auto digits = offset_digits( offset + buffer.size() );
+	char output[render_size( BATCH_BYTES )];
+	for ( auto i = 0_sz; i < buffer.size(); i += BATCH_BYTES ) {
+		const auto batch = buffer.subspan( i, ::std::min( buffer.size() - i, BATCH_BYTES ) );
+		const auto size = render( batch, output, options_, offset + i, digits );
+		::std::fwrite( output, 1, size, f );
+	}
+}
+
+/*static */inline constexpr usize hexdump::offset_digits( usize last_offset ) noexcept {
+	if ( last_offset <= ::std::numeric_limits<u8>::max() )		return 2;
+	if ( last_offset <= ::std::numeric_limits<u16>::max() )	return 4;
+	if ( last_offset <= ::std::numeric_limits<u32>::max() )	return 8;
+	return 16;
+}
+
+/*static */inline usize hexdump::render
+	( const data::cbuffer_t & buffer, char * output, Options options_/* = internal*/, usize offset/* = 0*/, usize digits/* = 0*/ ) noexcept
+{
+	const Flag<Options> options {options_};
+	const bool address = options.check( ADDRESS );
+	const bool prefix = address or options.check( OFFSET );
+	const bool ascii = options.check( ASCII );
+	const bool text = ascii or options.check( CP437 );
+	if ( address )
+		digits = 2 * sizeof(usize);
+	else if ( digits == 0 )
+		digits = offset_digits( offset + buffer.size() );
+
+	char * out = output;
 	for ( auto i = 0_sz; i < buffer.size(); i += COLUMNS ) {
-		const auto prefix_value = options.check( ADDRESS ) ? (usize) &buffer[i] : i + offset;
-		::std::fprintf( f, prefix, prefix_value );
+		const auto * row = &buffer[i];
 		const auto count = ::std::min( buffer.size() - i, COLUMNS );
-		const auto & dump = hex( { &buffer[i], count }, " " );
-		::std::fprintf( f, "%s", dump.c_str() );
-		if ( not options.check( ASCII ) and not options.check( CP437 ) ) {
-			::std::fputc( '\n', f );
+		if ( prefix )
+			out = render_prefix( out, address ? (usize) row : offset + i, digits );
+
+		for ( auto j = 0_sz; j < count; ++j ) {
+			const auto & pair = HEX[row[j]];
+			out[0] = pair[0];
+			out[1] = pair[1];
+			out[2] = ' ';
+			out += 3;
+		}
+		if ( not text ) {
+			out[-1] = '\n';
 			continue;
 		}
-		for ( auto j = count; j < COLUMNS; ++j )
-			::std::fputs( "   "/*hex + space*/, f );
-		::std::fputs( " | ", f );
+		for ( auto j = count; j < COLUMNS; ++j, out += 3 )
+			::std::memcpy( out, "   "/*hex + space*/, 3 );
+		::std::memcpy( out - 1, " | ", 3 );
+		out += 2;
 		for ( auto j = 0_sz; j < count; ++j ) {
-			if ( options.check( ASCII ) ) {
-				const char c = (char) buffer[ i + j ];
-				::std::fputc( is_ascii_graphical( c ) ? c : ' ', f );
-			} else/* if ( options.check( CP437 ) )*/ {
-				const auto s = utils::cp437( buffer[ i + j ] );
-				::std::fputs( s./*c_str*/data(), f );
+			if ( ascii ) {
+				const auto c = row[j];
+				*out++ = c > ' ' and c < 0x7F ? (char) c : ' ';
+			} else {
+				const auto & value = GLYPHS[row[j]];
+				::std::memcpy( out, value.data, sizeof(value.data) );
+				out += value.size;
 			}
 		}
-		for ( auto j = count; j < COLUMNS; ++j )
-			::std::fputs( "  "/*char + space*/, f );
-		::std::fputc( '\n', f );
+		for ( auto j = count; j < COLUMNS; ++j, out += 2 )
+			::std::memcpy( out, "  "/*char + space*/, 2 );
+		*out++ = '\n';
 	}
+	return (usize)( out - output );
 }
 
-/*static */inline const char * hexdump::select_prefix( usize size, const Flag<Options> & options ) noexcept {
-	if ( options.check( ADDRESS ) ) {
-		switch ( sizeof(usize) ) {
-		case sizeof(u32):		return "%08x | ";
-		case sizeof(u64):		return "%016x | ";
-		default:				return "ERROR | ";
-		}
-	}
-	if ( not options.check( OFFSET ) )
-		return "";
-	if ( size <= ::std::numeric_limits<u8>::max() )		return "%02x | ";
-	if ( size <= ::std::numeric_limits<u16>::max() )	return "%04x | ";
-	if ( size <= ::std::numeric_limits<u32>::max() )	return "%08x | ";
-	if ( size <= ::std::numeric_limits<u64>::max() )	return "%016x | ";
-	return "ERROR | ";
+/*static */inline char * hexdump::render_prefix( char * output, usize value, usize digits ) noexcept {
+	const auto width = ::std::max( digits, ( (usize) ::std::bit_width( value ) + 3 ) / 4 );
+	for ( auto i = width; i > 0; --i, value >>= 4 )
+		output[i - 1] = hex( (u8) value, false );
+	::std::memcpy( output + width, " | ", 3 );
+	return output + width + 3;
 }
 
 } // namespace lib::debug
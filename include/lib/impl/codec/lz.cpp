@@ -0,0 +1,370 @@
+/* File: /lib/impl/codec/lz.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+
+#include <cpp/lib_debug>
+
+#include "../../../lib/system/error.hpp"
+
+#include "./lz.hpp"
+
+namespace lib::codec::impl {
+
+namespace {
+
+/// @brief LZ4 block format: last match starts at least MF_LIMIT bytes before the end of the block.
+constexpr usize MF_LIMIT = 12;
+/// @brief LZ4 block format: last LAST_LITERALS bytes of the block are always literals.
+constexpr usize LAST_LITERALS = 5;
+/// @brief Every 2^SKIP_TRIGGER failed probes in a row increase search step by one.
+constexpr usize SKIP_TRIGGER = 6;
+constexpr usize RUN_MASK = 0x0F;
+constexpr usize VARINT_MAX = 10;
+
+inline u32 load32( const u8 * data ) noexcept {
+	u32 value;
+	::std::memcpy( &value, data, sizeof(value) );
+	return value;
+}
+
+inline u64 load64( const u8 * data ) noexcept {
+	u64 value;
+	::std::memcpy( &value, data, sizeof(value) );
+	return value;
+}
+
+inline usize hash( u32 value ) noexcept {
+	return ( value * 2654435761u ) >> ( 32 - lz::HASH_BITS );
+}
+
+/// @brief Count of equal bytes at `data` and `match`, `data` is compared up to `limit`.
+inline usize match_length( const u8 * data, const u8 * match, const u8 * limit ) noexcept {
+	const auto * const start = data;
+	if constexpr ( ::std::endian::native == ::std::endian::little ) {
+		while ( data + sizeof(u64) <= limit ) {
+			const auto diff = load64( data ) ^ load64( match );
+			if ( diff != 0 )
+				return (usize)( data - start ) + (usize) ::std::countr_zero( diff ) / 8;
+			data += sizeof(u64);
+			match += sizeof(u64);
+		}
+	}
+	while ( data < limit and *data == *match ) {
+		++data;
+		++match;
+	}
+	return (usize)( data - start );
+}
+
+inline u8 * write_length( u8 * out, usize length ) noexcept {
+	if ( length < RUN_MASK )
+		return out;
+	length -= RUN_MASK;
+	for ( ; length >= 0xFF; length -= 0xFF )
+		*out++ = 0xFF;
+	*out++ = (u8) length;
+	return out;
+}
+
+inline bool read_length( const u8 *& in, const u8 * end, usize & length ) noexcept {
+	if ( length != RUN_MASK )
+		return true;
+	u8 value;
+	do {
+		if ( in == end )
+			return false;
+		value = *in++;
+		length += value;
+	} while ( value == 0xFF );
+	return true;
+}
+
+inline u8 * write_literals( u8 * out, const u8 * literals, usize count, usize match_length_ ) noexcept {
+	*out++ = (u8)( ::std::min( count, RUN_MASK ) << 4 bitor ::std::min( match_length_, RUN_MASK ) );
+	out = write_length( out, count );
+	::std::memcpy( out, literals, count );
+	return out + count;
+}
+
+inline usize write_varint( u8 * out, usize value ) noexcept {
+	usize size = 0;
+	for ( ; value >= 0x80; value >>= 7 )
+		out[size++] = (u8)( value bitor 0x80 );
+	out[size++] = (u8) value;
+	return size;
+}
+
+enum class Varint { OK, INCOMPLETE, BAD };
+
+inline Varint read_varint( const data::cbuffer_t & in, usize & pos, usize & value ) noexcept {
+	value = 0;
+	for ( usize shift = 0; shift < VARINT_MAX * 7; shift += 7 ) {
+		if ( pos == in.size() )
+			return Varint::INCOMPLETE;
+		const u8 byte = in[pos++];
+		value |= (usize)( byte bitand 0x7F ) << shift;
+		if ( ( byte bitand 0x80 ) == 0 )
+			return Varint::OK;
+	}
+	return Varint::BAD;
+}
+
+} // namespace
+
+// IMPLEMENTATION lib::codec::impl::lz
+
+usize lz::CompressBlock( const data::cbuffer_t & plain, const data::buffer_t & coded, u32 * table ) {
+	CPP_ASSERT( plain.size() <= BLOCK_SIZE );
+	CPP_ASSERT( coded.size() >= Bound( plain.size() ) );
+
+	const u8 * const src = plain.data();
+	const usize size = plain.size();
+	u8 * out = coded.data();
+	usize anchor = 0;
+
+	if ( size > MF_LIMIT ) {
+		::std::fill_n( table, 1_sz << HASH_BITS, 0u );
+		const usize match_limit = size - MF_LIMIT;
+		const u8 * const extend_limit = src + size - LAST_LITERALS;
+		usize pos = 1;
+		usize misses = 0;
+		while ( pos < match_limit ) {
+			const auto key = hash( load32( src + pos ) );
+			usize match = table[key];
+			table[key] = (u32) pos;
+			if ( pos - match > MAX_OFFSET or load32( src + match ) != load32( src + pos ) ) {
+				pos += 1 + ( misses++ >> SKIP_TRIGGER );
+				continue;
+			}
+			misses = 0;
+
+			while ( pos > anchor and match > 0 and src[pos - 1] == src[match - 1] ) {
+				--pos;
+				--match;
+			}
+			const auto length = MIN_MATCH
+				+ match_length( src + pos + MIN_MATCH, src + match + MIN_MATCH, extend_limit );
+			const auto offset = pos - match;
+
+			out = write_literals( out, src + anchor, pos - anchor, length - MIN_MATCH );
+			*out++ = (u8) offset;
+			*out++ = (u8)( offset >> 8 );
+			out = write_length( out, length - MIN_MATCH );
+
+			pos += length;
+			anchor = pos;
+			if ( pos < match_limit )
+				table[hash( load32( src + pos - 2 ) )] = (u32)( pos - 2 );
+		}
+	}
+
+	out = write_literals( out, src + anchor, size - anchor, 0 );
+	return (usize)( out - coded.data() );
+}
+
+bool lz::DecompressBlock( const data::cbuffer_t & coded, const data::buffer_t & plain ) {
+	const u8 * in = coded.data();
+	const u8 * const in_end = in + coded.size();
+	u8 * out = plain.data();
+	u8 * const out_end = out + plain.size();
+
+	while ( in < in_end ) {
+		const auto token = *in++;
+
+		usize literals = token >> 4;
+		if ( not read_length( in, in_end, literals )
+		or literals > (usize)( in_end - in )
+		or literals > (usize)( out_end - out ) )
+			return false;
+		::std::memcpy( out, in, literals );
+		in += literals;
+		out += literals;
+		if ( in == in_end )
+			break;
+
+		if ( in_end - in < 2 )
+			return false;
+		const usize offset = (usize) in[0] bitor (usize) in[1] << 8;
+		in += 2;
+		usize length = token bitand RUN_MASK;
+		if ( offset == 0
+		or offset > (usize)( out - plain.data() )
+		or not read_length( in, in_end, length ) )
+			return false;
+		length += MIN_MATCH;
+		if ( length > (usize)( out_end - out ) )
+			return false;
+
+		/// @note Overlapping match repeats the last `offset` bytes, copy them in growing chunks.
+		const u8 * const match = out - offset;
+		while ( length > 0 ) {
+			const auto count = ::std::min( length, (usize)( out - match ) );
+			::std::memcpy( out, match, count );
+			out += count;
+			length -= count;
+		}
+	}
+	return out == out_end;
+}
+
+lz::lz( const data::cbuffer_t & buffer, Mode mode_/* = Mode::ENCODE*/ )
+	: mode_{ mode_ }
+{
+	CPP_ASSERT( mode_ != Mode::UNDEFINED );
+	if ( mode_ == Mode::ENCODE ) {
+		CPP_UNUSED( encode( buffer ) );
+		CPP_UNUSED( read_flush() );
+	} else if ( mode_ == Mode::DECODE )
+		CPP_UNUSED( decode( buffer ) );
+}
+
+void lz::encode_block( const data::cbuffer_t & plain ) {
+	CPP_ASSERT( not plain.empty() );
+	const auto offset = buffer_.size();
+	buffer_.resize( offset + 2 * VARINT_MAX + Bound( plain.size() ) );
+	u8 * const header = buffer_.data() + offset;
+	u8 * const payload = header + 2 * VARINT_MAX;
+
+	auto coded_size = CompressBlock( plain, {payload, Bound( plain.size() )}, table_.data() );
+	const bool stored = coded_size >= plain.size();
+	if ( stored )
+		coded_size = plain.size();
+
+	usize header_size = write_varint( header, plain.size() );
+	header_size += write_varint( header + header_size, coded_size << 1 bitor ( stored ? 1 : 0 ) );
+	if ( stored )
+		::std::memcpy( header + header_size, plain.data(), coded_size );
+	else
+		::std::memmove( header + header_size, payload, coded_size );
+	buffer_.resize( offset + header_size + coded_size );
+}
+
+data::result_t lz::decode_blocks( const data::cbuffer_t & coded ) {
+	usize consumed = 0;
+	while ( consumed < coded.size() ) {
+		usize pos = consumed;
+		usize plain_size = 0;
+		usize coded_word = 0;
+		auto status = read_varint( coded, pos, plain_size );
+		if ( status == Varint::OK )
+			status = read_varint( coded, pos, coded_word );
+		if ( status == Varint::INCOMPLETE )
+			break;
+
+		const auto coded_size = coded_word >> 1;
+		const bool stored = ( coded_word bitand 1 ) != 0;
+		if ( status == Varint::BAD
+		or plain_size > BLOCK_SIZE
+		or coded_size > Bound( plain_size )
+		or ( stored and coded_size != plain_size ) )
+			return make_error_bad_data();
+		if ( coded.size() - pos < coded_size )
+			break;
+
+		const auto block = coded.subspan( pos, coded_size );
+		const auto offset = buffer_.size();
+		buffer_.resize( offset + plain_size );
+		if ( stored )
+			::std::memcpy( buffer_.data() + offset, block.data(), plain_size );
+		else if ( not DecompressBlock( block, {buffer_.data() + offset, plain_size} ) ) {
+			buffer_.resize( offset );
+			return make_error_bad_data();
+		}
+		consumed = pos + coded_size;
+	}
+	return consumed;
+}
+
+// IMPLEMENTATION lib::codec::impl::lz: lib::data::codec_t
+
+void lz::reset( Mode mode/* = Mode::UNDEFINED*/ )/* override*/ {
+	error_.clear();
+	mode_ = mode;
+	pending_.clear();
+	buffer_.clear();
+}
+
+// IMPLEMENTATION lib::codec::impl::lz: lib::data::encoder_t, lib::data::decoder_t
+
+data::result_t lz::encode( const data::cbuffer_t & plain )/* override*/ {
+	if ( mode_ != Mode::ENCODE )
+		reset( Mode::ENCODE );
+
+	auto rest = plain;
+	while ( not rest.empty() ) {
+		// Whole blocks are compressed right from the input.
+		if ( pending_.empty() and rest.size() >= BLOCK_SIZE ) {
+			encode_block( rest.first( BLOCK_SIZE ) );
+			rest = rest.subspan( BLOCK_SIZE );
+			continue;
+		}
+		const auto count = ::std::min( rest.size(), BLOCK_SIZE - pending_.size() );
+		pending_.insert( pending_.end(), rest.begin(), rest.begin() + (isize) count );
+		rest = rest.subspan( count );
+		if ( pending_.size() == BLOCK_SIZE ) {
+			encode_block( pending_ );
+			pending_.clear();
+		}
+	}
+	return plain.size();
+}
+
+data::result_t lz::decode( const data::cbuffer_t & coded )/* override*/ {
+	if ( mode_ != Mode::DECODE )
+		reset( Mode::DECODE );
+	if ( error_ )
+		return error_;
+	if ( coded.empty() )
+		return 0_sz;
+
+	// Complete blocks are decoded right from the input, only the incomplete tail is copied.
+	if ( not pending_.empty() )
+		pending_.insert( pending_.end(), coded.begin(), coded.end() );
+	const data::cbuffer_t input = pending_.empty() ? coded : data::cbuffer_t {pending_};
+
+	const auto & consumed = decode_blocks( input );
+	if ( consumed.failed() )
+		return error_ = consumed.error();
+	if ( pending_.empty() )
+		pending_.assign( input.begin() + (isize) consumed.value(), input.end() );
+	else
+		pending_.erase( pending_.begin(), pending_.begin() + (isize) consumed.value() );
+	return coded.size();
+}
+
+// IMPLEMENTATION lib::codec::impl::lz: lib::data::rstream_t, lib::data::wstream_t
+
+data::result_t lz::read( const data::buffer_t & buffer )/* override*/ {
+	const auto count = ::std::min( buffer.size(), buffer_.size() );
+	::std::memcpy( buffer.data(), buffer_.data(), count );
+	return count;
+}
+
+data::cbuffer_t lz::read_cbuffer( bool flush )/* override*/ {
+	if ( flush and not read_flush() )
+		return {};
+	return buffer_;
+}
+
+bool lz::read_flush()/* override*/ {
+	if ( mode_ == Mode::DECODE )
+		return not error_ and pending_.empty();
+	if ( mode_ != Mode::ENCODE )
+		return false;
+	if ( not pending_.empty() ) {
+		encode_block( pending_ );
+		pending_.clear();
+	}
+	return true;
+}
+
+} // namespace lib::codec::impl
@@ -0,0 +1,94 @@
+/* File: /lib/impl/codec/lz.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__impl__codec__lz__hpp
+#define CPPLIB__lib__impl__codec__lz__hpp
+
+#include <array>
+#include <vector>
+
+#include "../../../lib/types.hpp"
+#include "../../../lib/literals.hpp"
+
+#include "../../../lib/data/codec.hpp"
+
+// DECLARATION lib::codec::impl::lz
+
+namespace lib::codec::impl {
+
+/** @brief LZ77 family compression codec (LZ4 block format).
+ *  @details Plain data is split into independent blocks of up to BLOCK_SIZE bytes, every block is
+ *  compressed with a greedy single-probe hash matcher and written as:
+ *
+ *      varint( plain size ) varint( coded size << 1 | stored ) coded bytes
+ *
+ *  where coded bytes are an LZ4 block (sequences of literals and back references), or the plain
+ *  bytes themselves if `stored` bit is set (block didn't compress).
+ *
+ *  Encoding is streamed block by block: encode() emits every completed block, encode_flush()
+ *  emits the partial one (so packets should be flushed individually). Decoding accepts coded data
+ *  split at any byte, incomplete blocks are kept until the rest arrives.
+ *
+ *  @see https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+ */
+class lz
+	: public data::codec_t
+{
+public:
+	static constexpr usize BLOCK_SIZE = 64_sz * 1024;
+	static constexpr usize MIN_MATCH = 4;
+	static constexpr usize MAX_OFFSET = 0xFFFF;
+	static constexpr usize HASH_BITS = 12;
+
+	/// @brief Max size of LZ4 block coded from `size` plain bytes.
+	static constexpr usize Bound( usize size ) noexcept { return size + size / 255 + 16; }
+	/// @brief Compresses `plain` (at most BLOCK_SIZE bytes) into `coded` of at least Bound() bytes.
+	/// @return Size of the coded block.
+	static usize CompressBlock( const data::cbuffer_t & plain, const data::buffer_t & coded, u32 * table );
+	/// @brief Decompresses LZ4 block `coded` into `plain` which has to be exactly the size of plain data.
+	static bool DecompressBlock( const data::cbuffer_t & coded, const data::buffer_t & plain );
+
+	lz() = default;
+	lz( const data::cbuffer_t & buffer, Mode mode_ = Mode::ENCODE );
+	virtual ~lz() = default;
+
+	// IMPLEMENTATION lib::data::codec_t
+
+	Mode mode() const override { return mode_; }
+	void reset( Mode mode = Mode::UNDEFINED ) override;
+
+	// IMPLEMENTATION lib::data::encoder_t, lib::data::decoder_t
+
+	data::result_t encode( const data::cbuffer_t & plain ) override;
+	data::result_t decode( const data::cbuffer_t & coded ) override;
+
+	// IMPLEMENTATION lib::data::rstream_t, lib::data::wstream_t
+
+	data::result_t read( const data::buffer_t & buffer ) override;
+	/// @brief Encoder: emits the pending partial block. Decoder: checks no incomplete block is pending.
+	bool read_flush() override;
+	data::result_t read_size() override { return buffer_.size(); }
+	data::cbuffer_t read_cbuffer( bool flush ) override;
+	using data::rstream_t::read_cbuffer;
+
+	::std::error_condition write_error() const override { return error_; }
+private:
+	void encode_block( const data::cbuffer_t & plain );
+	/// @return Count of consumed bytes of `coded` (complete blocks only).
+	data::result_t decode_blocks( const data::cbuffer_t & coded );
+
+	::std::error_condition error_;
+	Mode mode_ = Mode::UNDEFINED;
+	/// @brief Encoder: plain bytes of the block being filled. Decoder: bytes of the incomplete block.
+	::std::vector<u8> pending_;
+	::std::vector<u8> buffer_;
+	::std::array<u32, 1_sz << HASH_BITS> table_;
+};
+
+} // namespace lib::codec::impl
+
+#endif // CPPLIB__lib__impl__codec__lz__hpp
@@ -64,22 +64,4 @@ bool PingCounter::onPong( const tag_serializeable & ) noexcept {
 	return true;
 }
 
-// IMPLEMENTATION lib::packets::impl::PingCounter::Packet
-
-data::result_t PingCounter::Packet::serialized_size( data::wstream_t & stream ) const/* override*/ {
-	return data::serialized_size( stream, counter );
-}
-
-bool PingCounter::Packet::can_deserialize( data::rstream_t & stream ) const/* override*/ {
-	return data::can_deserialize( stream, counter );
-}
-
-data::result_t PingCounter::Packet::serialize( data::wstream_t & stream ) const/* override*/ {
-	return data::serialize( stream, counter );
-}
-
-data::result_t PingCounter::Packet::deserialize( data::rstream_t & stream )/* override*/ {
-	return data::deserialize( stream, counter );
-}
-
 } // namespace lib::packets::impl
@@ -15,6 +15,7 @@
 #include "../../../lib/tl/listener.hpp"
 #include "../../../lib/types.hpp"
 #include "../../../lib/data/serialize.hpp"
+#include "../../../lib/data/fields.hpp"
 
 #include "../../../lib/packets/handler.hpp"
 
@@ -44,15 +45,11 @@ private:
 	bool onPing( const tag_serializeable & ) noexcept;
 	bool onPong( const tag_serializeable & ) noexcept;
 
-	struct Packet : tag_serializeable {
+	struct Packet : tag_serializeable_fields<Packet> {
 		constexpr Packet() noexcept = default;
 		constexpr Packet( counter_type counter ) noexcept : counter{ counter } {}
 		counter_type counter;
-		data::result_t serialized_size( data::wstream_t & stream ) const override;
-		bool can_deserialize( data::rstream_t & stream ) const override;
-		data::result_t serialize( data::wstream_t & stream ) const override;
-		data::result_t deserialize( data::rstream_t & stream ) override;
-		using tag_serializeable::deserialize;
+		static constexpr auto fields = ::std::tuple { &Packet::counter };
 	};
 
 	const id_type ping_id;
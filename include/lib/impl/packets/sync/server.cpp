@@ -6,6 +6,8 @@
  * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
  */
 
+#include <cpp/lib_debug>
+
 #include "./server_client.hpp"
 
 #include "./server.hpp"
@@ -33,9 +35,8 @@ void Server::sync() noexcept {
 	for ( auto & client : clients ) {
 		new_lower_quant = ::std::min( new_lower_quant, client.get().quant() );
 		lower_timestamp_ = ::std::min( lower_timestamp_, client.get().timestamp() );
-
-		client.get().sync();
 	}
+	CPP_UNUSED( broadcaster.send( Packet{ quant_, timestamp_ } ) );
 
 	if ( new_lower_quant != lower_quant_ ) {
 		lower_quant_ = new_lower_quant;
@@ -12,6 +12,7 @@
 
 #include "../../../../lib/tl/listener.hpp"
 #include "../../../../lib/ref.hpp"
+#include "../../../../lib/packets/broadcaster.hpp"
 
 #include "./types.hpp"
 
@@ -46,6 +47,8 @@ private:
 	Timestamp lower_timestamp_ = {};
 
 	::std::vector< Ref<Client> > clients;
+	/// @brief Sync packet is serialized once for all clients, except those aggregating it (see Broadcaster).
+	Broadcaster broadcaster;
 };
 
 } // namespace lib::packets::impl::sync
@@ -23,10 +23,12 @@ Server::Client::Client( Server & server, Handler::id_type packet_id, ReadHandler
 {
 	handler.listen( packet_id, &packet, {*this,&Client::onSync} );
 	server.addClient( *this );
+	server.broadcaster.attach( handler, packet_id );
 	sync();
 }
 
 Server::Client::~Client() noexcept {
+	server.broadcaster.detach( handler );
 	server.removeClient( *this );
 	handler.unlisten( packet_id );
 }
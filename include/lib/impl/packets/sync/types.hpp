@@ -12,6 +12,7 @@
 
 #include "../../../../lib/types.hpp"
 #include "../../../../lib/data/serialize.hpp"
+#include "../../../../lib/data/fields.hpp"
 
 namespace lib::packets::impl::sync {
 
@@ -22,7 +23,7 @@ using Timestamp = ::std::chrono::milliseconds;
 // DECLARATION lib::packets::impl::sync::Packet
 
 struct Packet
-	: tag_serializeable
+	: tag_serializeable_fields<Packet>
 {
 	usize quant;
 	Timestamp timestamp;
@@ -30,11 +31,7 @@ struct Packet
 	constexpr Packet() = default;
 	constexpr Packet( usize quant, Timestamp timestamp  ) : quant{ quant }, timestamp{ timestamp } {}
 
-	data::result_t serialized_size( data::wstream_t & stream ) const override { return data::serialized_size( stream, quant, timestamp ); }
-	bool can_deserialize( data::rstream_t & stream ) const override { return data::can_deserialize( stream, quant, timestamp ); }
-	data::result_t serialize( data::wstream_t & stream ) const override { return data::serialize( stream, quant, timestamp ); }
-	data::result_t deserialize( data::rstream_t & stream ) override { return data::deserialize( stream, quant, timestamp ); }
-	using tag_serializeable::deserialize;
+	static constexpr auto fields = ::std::tuple { &Packet::quant, &Packet::timestamp };
 };
 
 } // namespace lib::packets::impl::sync
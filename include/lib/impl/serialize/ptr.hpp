@@ -10,6 +10,7 @@
 
 #include "../../../lib/types.hpp"
 #include "../../../lib/data/stream.hpp"
+#include "../../../lib/data/arena.hpp"
 
 #include "../../../lib/ptr.hpp"
 
@@ -17,76 +18,84 @@ namespace lib::data {
 
 // IMPLEMENTATION lib::data::serialized_size<>
 
-template< class T >
-constexpr inline result_t serialized_size( wstream_t & stream, const Ptr<T> & value )
+template< WriteStream S, class T >
+constexpr inline result_t serialized_size( S & stream, const Ptr<T> & value )
 { return serialized_size( stream, value.get() ); }
 
-template< class T >
-constexpr inline result_t serialized_size( wstream_t & stream, const SPtr<T> & value )
+template< WriteStream S, class T >
+constexpr inline result_t serialized_size( S & stream, const SPtr<T> & value )
 { return serialized_size( stream, value.get() ); }
 
-template< class T >
-constexpr inline result_t serialized_size( wstream_t & stream, const WPtr<T> & value )
+template< WriteStream S, class T >
+constexpr inline result_t serialized_size( S & stream, const WPtr<T> & value )
 { return serialized_size( stream, value.lock() ); }
 
 // IMPLEMENTATION lib::data::can_deserialize<>
 
-template< class T >
-constexpr inline bool can_deserialize( rstream_t & stream, const Ptr<T> & value )
+template< ReadStream S, class T >
+constexpr inline bool can_deserialize( S & stream, const Ptr<T> & value )
 { return can_deserialize( stream, value.get() ); }
 
-template< class T >
-constexpr inline bool can_deserialize( rstream_t & stream, const SPtr<T> & value )
+template< ReadStream S, class T >
+constexpr inline bool can_deserialize( S & stream, const SPtr<T> & value )
 { return can_deserialize( stream, value.get() ); }
 
-template< class T >
-constexpr inline bool can_deserialize( rstream_t & stream, const WPtr<T> & value )
+template< ReadStream S, class T >
+constexpr inline bool can_deserialize( S & stream, const WPtr<T> & value )
 { return can_deserialize( stream, value.lock() ); }
 
 // IMPLEMENTATION lib::data::serialize<>
 
-template< class T >
-constexpr inline result_t serialize( wstream_t & stream, const Ptr<T> & value )
+template< WriteStream S, class T >
+constexpr inline result_t serialize( S & stream, const Ptr<T> & value )
 { return serialize( stream, value.get() ); }
 
-template< class T >
-constexpr inline result_t serialize( wstream_t & stream, const SPtr<T> & value )
+template< WriteStream S, class T >
+constexpr inline result_t serialize( S & stream, const SPtr<T> & value )
 { return serialize( stream, value.get() ); }
 
-template< class T >
-constexpr inline result_t serialize( wstream_t & stream, const WPtr<T> & value )
+template< WriteStream S, class T >
+constexpr inline result_t serialize( S & stream, const WPtr<T> & value )
 { return serialize( stream, value.lock() ); }
 
 // IMPLEMENTATION lib::data::deserialize<>
 
-template< class T >
-constexpr inline result_t deserialize( rstream_t & stream, const Ptr<T> & value )
+template< ReadStream S, class T >
+constexpr inline result_t deserialize( S & stream, const Ptr<T> & value )
 { return deserialize( stream, value.get() ); }
 
-template< class T >
-constexpr inline result_t deserialize( rstream_t & stream, const SPtr<T> & value )
+template< ReadStream S, class T >
+constexpr inline result_t deserialize( S & stream, const SPtr<T> & value )
 { return deserialize( stream, value.get() ); }
 
-template< class T >
-constexpr inline result_t deserialize( rstream_t & stream, const WPtr<T> & value )
+template< ReadStream S, class T >
+constexpr inline result_t deserialize( S & stream, const WPtr<T> & value )
 { return deserialize( stream, value.lock() ); }
 
 // IMPLEMENTATION lib::data::deserialize<>( context )
 
-template< class T >
-constexpr inline result_t deserialize( void * context, rstream_t & stream, const Ptr<T> & value )
+template< ReadStream S, class T >
+constexpr inline result_t deserialize( void * context, S & stream, const Ptr<T> & value )
 { return deserialize( context, stream, value.get() ); }
 
-template< class T >
-constexpr inline result_t deserialize( void * context, rstream_t & stream, const SPtr<T> & value )
+template< ReadStream S, class T >
+constexpr inline result_t deserialize( void * context, S & stream, const SPtr<T> & value )
 { return deserialize( context, stream, value.get() ); }
 
-template< class T >
-constexpr inline result_t deserialize( void * context, rstream_t & stream, const WPtr<T> & value )
+/// @brief Null pointee is allocated from memory resource of `context` (see data::arena_t).
+template< ReadStream S, class T >
+constexpr inline result_t deserialize( void * context, S & stream, SPtr<T> & value ) {
+	if ( auto * resource = arena_t::resource( context ); not value and resource != nullptr )
+		value = ::std::allocate_shared<T>( ::std::pmr::polymorphic_allocator<T> {resource} );
+	return deserialize( context, stream, value.get() );
+}
+
+template< ReadStream S, class T >
+constexpr inline result_t deserialize( void * context, S & stream, const WPtr<T> & value )
 { return deserialize( context, stream, value.lock() ); }
 
-template< class T >
-constexpr inline result_t deserialize( void * context, rstream_t & stream, WPtr<T> & value ) {
+template< ReadStream S, class T >
+constexpr inline result_t deserialize( void * context, S & stream, WPtr<T> & value ) {
 	SPtr<T> sptr_value;
 	const auto & value_bytes = deserialize( context, stream, sptr_value );
 	if ( not sptr_value or value_bytes.failed() )
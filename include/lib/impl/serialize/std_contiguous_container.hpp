@@ -8,27 +8,50 @@
 #ifndef CPPLIB__lib__impl__serialize__std_contiguous_container__hpp
 #define CPPLIB__lib__impl__serialize__std_contiguous_container__hpp
 
+#include <cstring>
+#include <type_traits>
+
 #include <cpp/lib_concepts>
 #include <cpp/lib_debug>
 
 #include "../../../lib/types.hpp"
 #include "../../../lib/literals.hpp"
 #include "../../../lib/data/stream.hpp"
+#include "../../../lib/data/arena.hpp"
 
 namespace lib::data {
 
+// DECLARATION lib::data::ContiguousStorage, lib::data::ContiguousView
+
+/// @brief Container owning its elements, deserialized by resize() and copying from the stream.
+template< class T >
+concept ContiguousStorage = ::cpp::ContiguousContainer<T> and requires( T & t ) { t.resize( 0 ); };
+
+/** @brief Read-only view of contiguous memory (e.g. `::std::span<const u8>`, `cstring`).
+ *  @details Serialized the same way as containers. Deserialized without copying: the view aliases
+ *  memory of the stream exposed by read_cbuffer() (e.g. stream::impl::data, buffer, fifo) and
+ *  elements are skipped with read_pos().
+ *  @warning View is valid until the next read_flush() or any write to the stream.
+ *  @note Streams without read_cbuffer() fail with "not implemented" error, as well as elements
+ *  not aligned in stream memory. Whole payload has to fit in the stream buffer.
+ */
+template< class T >
+concept ContiguousView = ::cpp::ContiguousContainer<T>
+	and not ContiguousStorage<T>
+	and ::std::is_const_v< ::std::remove_pointer_t< decltype( ::std::declval<T &>().data() ) > >;
+
 // IMPLEMENTATION lib::data::serialized_size<>
 
-template< ::cpp::ContiguousContainer T >
+template< WriteStream S, ::cpp::ContiguousContainer T >
 	requires( ::cpp::Trivial< typename T::value_type >
 	and not ::cpp::Pointer< typename T::value_type > )
-constexpr inline result_t serialized_size( wstream_t &/* stream*/, const T & value )
+constexpr inline result_t serialized_size( S &/* stream*/, const T & value )
 { return sizeof(u32/*data_length*/) + value.size() * sizeof(typename T::value_type); }
 
-template< ::cpp::ContiguousContainer T >
+template< WriteStream S, ::cpp::ContiguousContainer T >
 	requires( ::cpp::Pointer< typename T::value_type >
 	or not ::cpp::Trivial< typename T::value_type > )
-constexpr inline result_t serialized_size( wstream_t & stream, const T & value ) {
+constexpr inline result_t serialized_size( S & stream, const T & value ) {
 	auto size = sizeof(u32/*data_length*/);
 	for ( const auto & element : value ) {
 		const auto & element_size = serialized_size( stream, element );
@@ -41,10 +64,10 @@ constexpr inline result_t serialized_size( wstream_t & stream, const T & value )
 
 // IMPLEMENTATION lib::data::can_deserialize<>
 
-template< ::cpp::ContiguousContainer T >
+template< ReadStream S, ::cpp::ContiguousContainer T >
 	requires( ::cpp::Trivial< typename T::value_type >
 	and not ::cpp::Pointer< typename T::value_type > )
-constexpr inline bool can_deserialize( rstream_t & stream, const T & ) {
+constexpr inline bool can_deserialize( S & stream, const T & ) {
 	u32 data_length;
 	const auto & peek_result = stream.peek({ &data_length, sizeof(data_length) });
 	if ( peek_result.failed() or peek_result != sizeof(data_length) )
@@ -53,20 +76,20 @@ constexpr inline bool can_deserialize( rstream_t & stream, const T & ) {
 	return read_size.success() and read_size >= sizeof(data_length) + data_length * sizeof(typename T::value_type);
 }
 
-template< ::cpp::ContiguousContainer T >
+template< ReadStream S, ::cpp::ContiguousContainer T >
 	requires( ::cpp::Pointer< typename T::value_type >
 	or not ::cpp::Trivial< typename T::value_type > )
-constexpr inline bool can_deserialize( rstream_t & stream, const T &/* value*/ ) {
+constexpr inline bool can_deserialize( S & stream, const T &/* value*/ ) {
 	const auto & read_size = stream.read_size();
 	return read_size.success() and read_size >= sizeof(u32/*data_length*/);
 }
 
 // IMPLEMENTATION lib::data::serialize<>
 
-template< ::cpp::ContiguousContainer T >
+template< WriteStream S, ::cpp::ContiguousContainer T >
 	requires( ::cpp::Trivial< typename T::value_type >
 	and not ::cpp::Pointer< typename T::value_type > )
-constexpr inline result_t serialize( wstream_t & stream, const T & value ) {
+constexpr inline result_t serialize( S & stream, const T & value ) {
 	const u32 data_length = (u32) value.size();
 	auto written_bytes = stream.write({ &data_length, sizeof(data_length) });
 	if ( written_bytes != sizeof(data_length) )
@@ -79,10 +102,10 @@ constexpr inline result_t serialize( wstream_t & stream, const T & value ) {
 	return written_bytes;
 }
 
-template< ::cpp::ContiguousContainer T >
+template< WriteStream S, ::cpp::ContiguousContainer T >
 	requires( ::cpp::Pointer< typename T::value_type >
 	or not ::cpp::Trivial< typename T::value_type > )
-constexpr inline result_t serialize( wstream_t & stream, const T & value ) {
+constexpr inline result_t serialize( S & stream, const T & value ) {
 	const u32 data_length = (u32) value.size();
 	auto written_bytes = stream.write({ &data_length, sizeof(data_length) });
 	if ( written_bytes != sizeof(data_length) )
@@ -93,17 +116,17 @@ constexpr inline result_t serialize( wstream_t & stream, const T & value ) {
 			/** @note Can't be zero, because elements counting is
 			 * required to support container serialization. */
 			return element_written;
-		written_bytes += element_written;
+		written_bytes += element_written.value();
 	}
 	return written_bytes;
 }
 
 // IMPLEMENTATION lib::data::deserialize<>
 
-template< ::cpp::ContiguousContainer T >
+template< ReadStream S, ContiguousStorage T >
 	requires( ::cpp::Trivial< typename T::value_type >
 	and not ::cpp::Pointer< typename T::value_type > )
-constexpr inline result_t deserialize( rstream_t & stream, T & value ) {
+constexpr inline result_t deserialize( S & stream, T & value ) {
 	u32 data_length;
 	auto readen_bytes = stream.read({ &data_length, sizeof(data_length) });
 	if ( readen_bytes != sizeof(data_length) )
@@ -115,10 +138,10 @@ constexpr inline result_t deserialize( rstream_t & stream, T & value ) {
 	return sizeof(data_length) + readen_bytes;
 }
 
-template< ::cpp::ContiguousContainer T >
+template< ReadStream S, ContiguousStorage T >
 	requires( ::cpp::Pointer< typename T::value_type >
 	or not ::cpp::Trivial< typename T::value_type > )
-constexpr inline result_t deserialize( rstream_t & stream, T & value ) {
+constexpr inline result_t deserialize( S & stream, T & value ) {
 	u32 data_length;
 	auto readen_bytes = stream.read({ &data_length, sizeof(data_length) });
 	if ( readen_bytes != sizeof(data_length) )
@@ -130,15 +153,15 @@ constexpr inline result_t deserialize( rstream_t & stream, T & value ) {
 			/** @note Can't be zero, because elements counting is
 			 * required to support container deserialization. */
 			return element_readen;
-		readen_bytes += element_readen;
+		readen_bytes += element_readen.value();
 	}
 	return readen_bytes;
 }
 
-template< ::cpp::ContiguousContainer T, /*::cpp::Invocable*/class Fn >
-requires requires ( rstream_t & s, T & v, const Fn & fn )
+template< ReadStream S, ContiguousStorage T, /*::cpp::Invocable*/class Fn >
+requires requires ( S & s, T & v, const Fn & fn )
 	{ {fn( s, v[0] )} -> ::cpp::SameAs<result_t>; }
-constexpr inline result_t deserialize( rstream_t & stream, T & value, Fn fn ) {
+constexpr inline result_t deserialize( S & stream, T & value, Fn fn ) {
 	u32 data_length;
 	auto readen_bytes = stream.read({ &data_length, sizeof(data_length) });
 	if ( readen_bytes != sizeof(data_length) )
@@ -150,28 +173,64 @@ constexpr inline result_t deserialize( rstream_t & stream, T & value, Fn fn ) {
 			/** @note Can't be zero, because elements counting is
 			 * required to support container deserialization. */
 			return element_readen;
-		readen_bytes += element_readen;
+		readen_bytes += element_readen.value();
 	}
 	return readen_bytes;
 }
 
+template< ReadStream S, ContiguousView T >
+	requires( ::cpp::Trivial< typename T::value_type >
+	and not ::cpp::Pointer< typename T::value_type > )
+constexpr inline result_t deserialize( S & stream, T & value ) {
+	using value_type = typename T::value_type;
+	const auto & memory = stream.read_cbuffer( false );
+	u32 data_length = 0;
+	if ( memory.size() >= sizeof(data_length) )
+		::std::memcpy( &data_length, memory.data(), sizeof(data_length) );
+	const auto total_size = sizeof(data_length) + data_length * sizeof(value_type);
+	if ( memory.size() < total_size ) {
+		const auto & read_size = stream.read_size();
+		if ( read_size.failed() )
+			return read_size;
+		return read_size > memory.size()
+			? result_t {make_error_not_implemented()}
+			: result_t {0_sz};
+	}
+	const auto * elements = memory.data() + sizeof(data_length);
+	if ( (usize) elements % alignof(value_type) != 0 )
+		return make_error_not_implemented();
+	const auto & position = stream.read_pos();
+	if ( position.failed() )
+		return position;
+	const auto & skipped = stream.read_pos( position.value() + total_size );
+	if ( skipped.failed() )
+		return skipped;
+	value = T ( (const value_type *) elements, (usize) data_length );
+	return total_size;
+}
+
 // IMPLEMENTATION lib::data::deserialize<>( context )
 
-template< ::cpp::ContiguousContainer T >
-	requires( ::cpp::Trivial< typename T::value_type >
+template< ReadStream S, class T >
+	requires( ( ContiguousStorage<T> or ContiguousView<T> )
+	and ::cpp::Trivial< typename T::value_type >
 	and not ::cpp::Pointer< typename T::value_type > )
-constexpr inline result_t deserialize( void * /*context*/, rstream_t & stream, T & value ) {
+constexpr inline result_t deserialize( void * context, S & stream, T & value ) {
+	if constexpr ( detail::PmrContainer<T> )
+		detail::bind_context( context, value );
 	return deserialize( stream, value );
 }
 
-template< ::cpp::ContiguousContainer T >
+template< ReadStream S, ContiguousStorage T >
 	requires( ::cpp::Pointer< typename T::value_type >
 	or not ::cpp::Trivial< typename T::value_type > )
-constexpr inline result_t deserialize( void * context, rstream_t & stream, T & value ) {
+constexpr inline result_t deserialize( void * context, S & stream, T & value ) {
 	u32 data_length;
 	auto readen_bytes = stream.read({ &data_length, sizeof(data_length) });
 	if ( readen_bytes != sizeof(data_length) )
 		return readen_bytes;
+	if constexpr ( detail::PmrContainer<T> )
+		detail::bind_context( context, value );
 	value.resize( data_length );
 	for ( auto & element : value ) {
 		const auto & element_readen = deserialize( context, stream, element );
@@ -179,19 +238,21 @@ constexpr inline result_t deserialize( void * context, rstream_t & stream, T & v
 			/** @note Can't be zero, because elements counting is
 			 * required to support container deserialization. */
 			return element_readen;
-		readen_bytes += element_readen;
+		readen_bytes += element_readen.value();
 	}
 	return readen_bytes;
 }
 
-template< ::cpp::ContiguousContainer T, /*::cpp::Invocable*/class Fn >
-requires requires ( void * c, rstream_t & s, T & v, const Fn & fn )
+template< ReadStream S, ContiguousStorage T, /*::cpp::Invocable*/class Fn >
+requires requires ( void * c, S & s, T & v, const Fn & fn )
 	{ {fn( c, s, v[0] )} -> ::cpp::SameAs<result_t>; }
-constexpr inline result_t deserialize( void * context, rstream_t & stream, T & value, Fn fn ) {
+constexpr inline result_t deserialize( void * context, S & stream, T & value, Fn fn ) {
 	u32 data_length;
 	auto readen_bytes = stream.read({ &data_length, sizeof(data_length) });
 	if ( readen_bytes != sizeof(data_length) )
 		return readen_bytes;
+	if constexpr ( detail::PmrContainer<T> )
+		detail::bind_context( context, value );
 	value.resize( data_length );
 	for ( auto & element : value ) {
 		const auto & element_readen = fn( context, stream, element );
@@ -199,7 +260,7 @@ constexpr inline result_t deserialize( void * context, rstream_t & stream, T & v
 			/** @note Can't be zero, because elements counting is
 			 * required to support container deserialization. */
 			return element_readen;
-		readen_bytes += element_readen;
+		readen_bytes += element_readen.value();
 	}
 	return readen_bytes;
 }
@@ -19,80 +19,80 @@ namespace lib::data {
 // IMPLEMENTATION lib::data::serialized_size<>
 
 namespace detail {
-template< class...Args, ::std::size_t...I >
+template< WriteStream S, class...Args, ::std::size_t...I >
 constexpr inline result_t serialized_size
-( wstream_t & stream, const ::std::tuple<Args...> & value, ::std::index_sequence<I...> ) {
+( S & stream, const ::std::tuple<Args...> & value, ::std::index_sequence<I...> ) {
 	return serialized_size( stream, ::std::get<I>( value )... );
 }
 } // namespace detail
 
-template< class...Args >
+template< WriteStream S, class...Args >
 constexpr inline result_t serialized_size
-( wstream_t & stream, const ::std::tuple<Args...> & value ) {
+( S & stream, const ::std::tuple<Args...> & value ) {
 	return detail::serialized_size( stream, value, ::std::index_sequence_for<Args...>{} );
 }
 
 // IMPLEMENTATION lib::data::can_deserialize<>
 
 namespace detail {
-template< class...Args, ::std::size_t...I >
+template< ReadStream S, class...Args, ::std::size_t...I >
 constexpr inline bool can_deserialize
-( rstream_t & stream, const ::std::tuple<Args...> & value, ::std::index_sequence<I...> ) {
+( S & stream, const ::std::tuple<Args...> & value, ::std::index_sequence<I...> ) {
 	return can_deserialize( stream, ::std::get<I>( value )... );
 }
 } // namespace detail
 
-template< class...Args >
+template< ReadStream S, class...Args >
 constexpr inline bool can_deserialize
-( rstream_t & stream, const ::std::tuple<Args...> & value ) {
+( S & stream, const ::std::tuple<Args...> & value ) {
 	return detail::can_deserialize( stream, value, ::std::index_sequence_for<Args...>{} );
 }
 
 // IMPLEMENTATION lib::data::serialize<>
 
 namespace detail {
-template< class...Args, ::std::size_t...I >
+template< WriteStream S, class...Args, ::std::size_t...I >
 constexpr inline result_t serialize
-( wstream_t & stream, const ::std::tuple<Args...> & value, ::std::index_sequence<I...> ) {
+( S & stream, const ::std::tuple<Args...> & value, ::std::index_sequence<I...> ) {
 	return serialize( stream, ::std::get<I>( value )... );
 }
 } // namespace detail
 
-template< class...Args >
+template< WriteStream S, class...Args >
 constexpr inline result_t serialize
-( wstream_t & stream, const ::std::tuple<Args...> & value ) {
+( S & stream, const ::std::tuple<Args...> & value ) {
 	return detail::serialize( stream, value, ::std::index_sequence_for<Args...>{} );
 }
 
 // IMPLEMENTATION lib::data::deserialize<>
 
 namespace detail {
-template< class...Args, ::std::size_t...I >
+template< ReadStream S, class...Args, ::std::size_t...I >
 constexpr inline result_t deserialize
-( rstream_t & stream, ::std::tuple<Args...> & value, ::std::index_sequence<I...> ) {
+( S & stream, ::std::tuple<Args...> & value, ::std::index_sequence<I...> ) {
 	return deserialize( stream, ::std::get<I>( value )... );
 }
 } // namespace detail
 
-template< class...Args >
+template< ReadStream S, class...Args >
 constexpr inline result_t deserialize
-( rstream_t & stream, ::std::tuple<Args...> & value ) {
+( S & stream, ::std::tuple<Args...> & value ) {
 	return detail::deserialize( stream, value, ::std::index_sequence_for<Args...>{} );
 }
 
 // IMPLEMENTATION lib::data::deserialize<>( context )
 
 namespace detail {
-template< class...Args, ::std::size_t...I >
+template< ReadStream S, class...Args, ::std::size_t...I >
 constexpr inline result_t deserialize
-( void * context, rstream_t & stream, const ::std::tuple<Args...> & value, ::std::index_sequence<I...> ) {
+( void * context, S & stream, const ::std::tuple<Args...> & value, ::std::index_sequence<I...> ) {
 	return deserialize( context, stream, ::std::get<I>( value )... );
 }
 } // namespace detail
 
-template< class...Args >
+template< ReadStream S, class...Args >
 constexpr inline result_t deserialize
-( void * context, rstream_t & stream, const ::std::tuple<Args...> & value ) {
+( void * context, S & stream, const ::std::tuple<Args...> & value ) {
 	return detail::deserialize( context, stream, value, ::std::index_sequence_for<Args...>{} );
 }
 
@@ -0,0 +1,392 @@
+/* File: /lib/impl/serialize/varint.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__impl__serialize__varint__hpp
+#define CPPLIB__lib__impl__serialize__varint__hpp
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <cpp/lib_concepts>
+
+#include "../../../lib/types.hpp"
+#include "../../../lib/literals.hpp"
+#include "../../../lib/data/stream.hpp"
+
+namespace lib::data {
+
+// DECLARATION lib::data::leb128
+
+/** @brief LEB128 variable length encoding of u64 values.
+ *  @details Value is written by 7 bits per byte, least significant group first, high bit of
+ *  every byte except the last one is set. Values below 128 take a single byte.
+ */
+struct leb128 {
+	static constexpr usize MAX_SIZE = 10;
+
+	static constexpr usize size( u64 value ) noexcept
+	{ return ( (usize) ::std::bit_width( value | 1 ) + 6 ) / 7; }
+
+	/// @brief Writes at most MAX_SIZE bytes into `out`.
+	/// @return Size of encoded value.
+	static constexpr usize encode( u64 value, u8 * out ) noexcept;
+
+	/** @brief Decodes value from `in`, which may contain bytes after the varint.
+	 *  @details Decoder loads 8 bytes at once and finds the last byte of varint by its clear
+	 *  high bit, so values up to 56 bits are decoded without branching on every byte.
+	 *  @return Size of decoded varint, 0 if `in` ends before the last byte, -1 if malformed.
+	 */
+	static isize decode( const u8 * in, usize size, u64 & value ) noexcept;
+
+	/// @brief Maps signed integers to unsigned ones (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...).
+	static constexpr u64 zigzag( i64 value ) noexcept
+	{ return ( (u64) value << 1 ) ^ (u64)( value >> 63 ); }
+	static constexpr i64 unzigzag( u64 value ) noexcept
+	{ return (i64)( ( value >> 1 ) ^ ( 0 - ( value & 1 ) ) ); }
+
+	template< ::cpp::Integral T >
+	static constexpr u64 pack( T value ) noexcept;
+	/// @return false if `wire` is out of range of T.
+	template< ::cpp::Integral T >
+	static constexpr bool unpack( u64 wire, T & value ) noexcept;
+};
+
+// DECLARATION lib::data::varint<>
+
+/** @brief Wrapper selecting compact (varint) wire encoding of the wrapped value.
+ *  @details Integers are written as LEB128, signed ones are zigzag mapped first, so small
+ *  magnitudes of both signs take a single byte. Contiguous containers get a varint length prefix
+ *  instead of u32, elements are serialized as usual.
+ *
+ *      serialize( stream, data::varint{id}, data::varint{name} );
+ *      deserialize( stream, data::varint{id} );
+ *
+ *  @note Both sides have to agree on the encoding, it is not marked on the wire.
+ */
+template< class T >
+struct varint {
+	constexpr explicit varint( T & value_ ) noexcept : value {value_} {}
+
+	T & value;
+};
+
+template< class T >
+varint( T & ) -> varint<T>;
+
+namespace detail {
+
+template< class T >
+concept VarintContainer = ::cpp::ContiguousContainer<::std::remove_const_t<T>>;
+
+template< class T >
+concept VarintTrivialContainer = VarintContainer<T>
+	and ::cpp::Trivial<typename ::std::remove_const_t<T>::value_type>
+	and not ::cpp::Pointer<typename ::std::remove_const_t<T>::value_type>;
+
+template< WriteStream S >
+constexpr inline result_t write_varint( S & stream, u64 value ) {
+	u8 bytes[leb128::MAX_SIZE];
+	return stream.write({ bytes, leb128::encode( value, bytes ) });
+}
+
+/// @return Size of the varint in the stream, 0 if stream doesn't contain all its bytes yet.
+template< ReadStream S >
+constexpr inline result_t peek_varint( S & stream, u64 & value ) {
+	u8 bytes[leb128::MAX_SIZE];
+	const auto & peeked = stream.peek({ bytes, sizeof(bytes) });
+	if ( peeked.failed() )
+		return peeked;
+	const auto size = leb128::decode( bytes, peeked.value(), value );
+	if ( size < 0 )
+		return make_error_bad_data();
+	return (usize) size;
+}
+
+/** @brief Consumes varint from the stream. Nothing is consumed if it is incomplete (0 is returned).
+ *  @note Streams without peek() are read byte by byte: nothing is consumed if the stream is empty,
+ *        but a varint cut by the end of the stream is consumed and reported as empty data error.
+ */
+template< ReadStream S >
+constexpr inline result_t read_varint( S & stream, u64 & value ) {
+	const auto & peeked = peek_varint( stream, value );
+	if ( peeked.success() ) {
+		if ( peeked == 0_sz )
+			return peeked;
+		u8 bytes[leb128::MAX_SIZE];
+		return stream.read({ bytes, peeked.value() });
+	}
+	if ( peeked.error() != make_error_not_implemented() )
+		return peeked;
+	// Stream can't peek: read byte by byte.
+	u8 bytes[leb128::MAX_SIZE];
+	usize size = 0;
+	while ( size < leb128::MAX_SIZE ) {
+		const auto & readen = stream.read({ &bytes[size], 1 });
+		if ( readen.failed() )
+			return readen;
+		if ( readen == 0_sz )
+			return size == 0 ? result_t {0_sz} : result_t {make_error_empty_data()};
+		if ( ( bytes[size++] & 0x80 ) == 0 )
+			break;
+	}
+	const auto decoded = leb128::decode( bytes, size, value );
+	if ( decoded <= 0 )
+		return make_error_bad_data();
+	return (usize) decoded;
+}
+
+/// @brief Reads varint length prefix of container, limited to u32 as in fixed encoding.
+template< ReadStream S >
+constexpr inline result_t read_length( S & stream, usize & length ) {
+	u64 wire;
+	const auto & readen = read_varint( stream, wire );
+	if ( readen.failed() or readen == 0_sz )
+		return readen;
+	if ( wire > ::std::numeric_limits<u32>::max() )
+		return make_error_bad_data();
+	length = (usize) wire;
+	return readen;
+}
+
+} // namespace detail
+
+// IMPLEMENTATION lib::data::serialized_size<>
+
+template< WriteStream S, ::cpp::Integral T >
+constexpr inline result_t serialized_size( S &/* stream*/, const varint<T> & value )
+{ return leb128::size( leb128::pack( value.value ) ); }
+
+template< WriteStream S, detail::VarintTrivialContainer T >
+constexpr inline result_t serialized_size( S &/* stream*/, const varint<T> & value ) {
+	return leb128::size( value.value.size() )
+		+ value.value.size() * sizeof(typename ::std::remove_const_t<T>::value_type);
+}
+
+template< WriteStream S, detail::VarintContainer T >
+	requires( not detail::VarintTrivialContainer<T> )
+constexpr inline result_t serialized_size( S & stream, const varint<T> & value ) {
+	auto size = leb128::size( value.value.size() );
+	for ( const auto & element : value.value ) {
+		const auto & element_size = serialized_size( stream, element );
+		if ( element_size.failed() )
+			return element_size;
+		size += element_size.value();
+	}
+	return size;
+}
+
+// IMPLEMENTATION lib::data::can_deserialize<>
+
+template< ReadStream S, ::cpp::Integral T >
+constexpr inline bool can_deserialize( S & stream, const varint<T> &/* value*/ ) {
+	u64 wire;
+	const auto & peeked = detail::peek_varint( stream, wire );
+	return peeked.success() and peeked > 0_sz;
+}
+
+template< ReadStream S, detail::VarintTrivialContainer T >
+constexpr inline bool can_deserialize( S & stream, const varint<T> &/* value*/ ) {
+	u64 data_length;
+	const auto & peeked = detail::peek_varint( stream, data_length );
+	if ( peeked.failed() or peeked == 0_sz )
+		return false;
+	const auto & read_size = stream.read_size();
+	return read_size.success()
+		and read_size >= peeked.value() + data_length * sizeof(typename ::std::remove_const_t<T>::value_type);
+}
+
+template< ReadStream S, detail::VarintContainer T >
+	requires( not detail::VarintTrivialContainer<T> )
+constexpr inline bool can_deserialize( S & stream, const varint<T> &/* value*/ ) {
+	u64 data_length;
+	const auto & peeked = detail::peek_varint( stream, data_length );
+	return peeked.success() and peeked > 0_sz;
+}
+
+// IMPLEMENTATION lib::data::serialize<>
+
+template< WriteStream S, ::cpp::Integral T >
+constexpr inline result_t serialize( S & stream, const varint<T> & value )
+{ return detail::write_varint( stream, leb128::pack( value.value ) ); }
+
+template< WriteStream S, detail::VarintTrivialContainer T >
+constexpr inline result_t serialize( S & stream, const varint<T> & value ) {
+	u8 length[leb128::MAX_SIZE];
+	const cbuffer_t buffers[] = {
+		{ length, leb128::encode( value.value.size(), length ) },
+		{ value.value.data(), value.value.size() * sizeof(typename ::std::remove_const_t<T>::value_type) },
+	};
+	/// @note Length and elements go to the stream with a single (vectored) write.
+	return stream.writev( buffers );
+}
+
+template< WriteStream S, detail::VarintContainer T >
+	requires( not detail::VarintTrivialContainer<T> )
+constexpr inline result_t serialize( S & stream, const varint<T> & value ) {
+	auto written_bytes = detail::write_varint( stream, value.value.size() );
+	if ( written_bytes != leb128::size( value.value.size() ) )
+		return written_bytes;
+	for ( const auto & element : value.value ) {
+		const auto & element_written = serialize( stream, element );
+		if ( element_written.failed() or element_written == 0_sz )
+			/** @note Can't be zero, because elements counting is
+			 * required to support container serialization. */
+			return element_written;
+		written_bytes += element_written.value();
+	}
+	return written_bytes;
+}
+
+// IMPLEMENTATION lib::data::deserialize<>
+
+template< ReadStream S, ::cpp::Integral T >
+constexpr inline result_t deserialize( S & stream, const varint<T> & value ) {
+	u64 wire;
+	const auto & readen = detail::read_varint( stream, wire );
+	if ( readen.failed() or readen == 0_sz )
+		return readen;
+	if ( not leb128::unpack( wire, value.value ) )
+		return make_error_bad_data();
+	return readen;
+}
+
+template< ReadStream S, detail::VarintTrivialContainer T >
+constexpr inline result_t deserialize( S & stream, const varint<T> & value ) {
+	usize data_length = 0;
+	const auto & length_readen = detail::read_length( stream, data_length );
+	if ( length_readen.failed() or length_readen == 0_sz )
+		return length_readen;
+	value.value.resize( data_length );
+	const auto data_size = data_length * sizeof(typename T::value_type);
+	const auto & readen_bytes = stream.read({ value.value.data(), data_size });
+	if ( readen_bytes != data_size )
+		return readen_bytes;
+	return length_readen + readen_bytes;
+}
+
+template< ReadStream S, detail::VarintContainer T >
+	requires( not detail::VarintTrivialContainer<T> )
+constexpr inline result_t deserialize( S & stream, const varint<T> & value ) {
+	usize data_length = 0;
+	auto readen_bytes = detail::read_length( stream, data_length );
+	if ( readen_bytes.failed() or readen_bytes == 0_sz )
+		return readen_bytes;
+	value.value.resize( data_length );
+	for ( auto & element : value.value ) {
+		const auto & element_readen = deserialize( stream, element );
+		if ( element_readen.failed() or element_readen == 0_sz )
+			/** @note Can't be zero, because elements counting is
+			 * required to support container deserialization. */
+			return element_readen;
+		readen_bytes += element_readen.value();
+	}
+	return readen_bytes;
+}
+
+// IMPLEMENTATION lib::data::deserialize<>( context )
+
+template< ReadStream S, class T >
+	requires( ::cpp::Integral<T> or detail::VarintTrivialContainer<T> )
+constexpr inline result_t deserialize( void * /*context*/, S & stream, const varint<T> & value ) {
+	return deserialize( stream, value );
+}
+
+template< ReadStream S, detail::VarintContainer T >
+	requires( not detail::VarintTrivialContainer<T> )
+constexpr inline result_t deserialize( void * context, S & stream, const varint<T> & value ) {
+	usize data_length = 0;
+	auto readen_bytes = detail::read_length( stream, data_length );
+	if ( readen_bytes.failed() or readen_bytes == 0_sz )
+		return readen_bytes;
+	value.value.resize( data_length );
+	for ( auto & element : value.value ) {
+		const auto & element_readen = deserialize( context, stream, element );
+		if ( element_readen.failed() or element_readen == 0_sz )
+			/** @note Can't be zero, because elements counting is
+			 * required to support container deserialization. */
+			return element_readen;
+		readen_bytes += element_readen.value();
+	}
+	return readen_bytes;
+}
+
+// INLINES lib::data::leb128
+
+inline constexpr usize leb128::encode( u64 value, u8 * out ) noexcept {
+	usize size = 0;
+	for ( ; value >= 0x80; value >>= 7 )
+		out[size++] = (u8)( value | 0x80 );
+	out[size++] = (u8) value;
+	return size;
+}
+
+inline isize leb128::decode( const u8 * in, usize size, u64 & value ) noexcept {
+	// Most of lengths and ids.
+	if ( size > 0 and in[0] < 0x80 ) {
+		value = in[0];
+		return 1;
+	}
+	if ( size >= sizeof(u64) ) {
+		u64 word;
+		::std::memcpy( &word, in, sizeof(word) );
+		if constexpr ( ::std::endian::native == ::std::endian::big )
+			word = ::std::byteswap( word );
+		const u64 stops = ~word & 0x8080808080808080_u64;
+		if ( stops != 0 ) {
+			// Keep bytes up to the first stop bit, then squeeze 7 bit groups together.
+			word &= ( stops ^ ( stops - 1 ) ) & 0x7F7F7F7F7F7F7F7F_u64;
+			word = ( word & 0x007F007F007F007F_u64 ) | ( ( word & 0x7F007F007F007F00_u64 ) >> 1 );
+			word = ( word & 0x00003FFF00003FFF_u64 ) | ( ( word & 0x3FFF00003FFF0000_u64 ) >> 2 );
+			word = ( word & 0x000000000FFFFFFF_u64 ) | ( ( word & 0x0FFFFFFF00000000_u64 ) >> 4 );
+			value = word;
+			return ::std::countr_zero( stops ) / 8 + 1;
+		}
+	}
+	u64 result = 0;
+	const auto count = ::std::min( size, MAX_SIZE );
+	for ( usize i = 0; i < count; ++i ) {
+		result |= (u64)( in[i] & 0x7F ) << ( 7 * i );
+		if ( ( in[i] & 0x80 ) != 0 )
+			continue;
+		// 10th byte holds the single highest bit of u64.
+		if ( i == MAX_SIZE - 1 and in[i] > 1 )
+			return -1;
+		value = result;
+		return (isize)( i + 1 );
+	}
+	return size < MAX_SIZE ? 0 : -1;
+}
+
+template< ::cpp::Integral T >
+inline constexpr u64 leb128::pack( T value ) noexcept {
+	if constexpr ( ::std::is_signed_v<T> )
+		return zigzag( value );
+	else
+		return value;
+}
+
+template< ::cpp::Integral T >
+inline constexpr bool leb128::unpack( u64 wire, T & value ) noexcept {
+	if constexpr ( ::std::is_signed_v<T> ) {
+		const auto signed_ = unzigzag( wire );
+		if ( signed_ < ::std::numeric_limits<T>::min() or signed_ > ::std::numeric_limits<T>::max() )
+			return false;
+		value = (T) signed_;
+	} else {
+		if ( wire > ::std::numeric_limits<T>::max() )
+			return false;
+		value = (T) wire;
+	}
+	return true;
+}
+
+} // namespace lib::data
+
+#endif // CPPLIB__lib__impl__serialize__varint__hpp
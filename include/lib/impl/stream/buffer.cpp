@@ -6,8 +6,6 @@
  * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
  */
 
-#include <cstring>
-
 #include <algorithm>
 #include <utility>
 
@@ -23,15 +21,17 @@ namespace lib::stream::impl {
 
 buffer::buffer( usize size )
 	: stream {nullptr}
+	, capacity_ {size}
 	, read_pos_ {0}
-{
-	read_buff.reserve( size );
-	write_buff.reserve( size );
-}
+	, bypassed {0}
+	, read_buff {size}
+	, write_buff {size}
+{}
 
 void buffer::reset( data::rwstream_t * stream_/* = nullptr*/ ) {
 	stream = stream_;
 	read_pos_ = 0;
+	bypassed = 0;
 	read_buff.clear();
 	write_buff.clear();
 }
@@ -40,41 +40,64 @@ bool buffer::empty() const {
 	return stream == nullptr;
 }
 
+data::result_t buffer::stage( const data::cbuffer_t & buffer ) {
+	const auto & write_size_ = write_size();
+	CPP_ASSERT( write_size_.success() );
+	const auto count = ::std::min( buffer.size(), write_size_.value() );
+	write_buff.append( buffer.first( count ) );
+	return count;
+}
+
 // IMPLEMENTATION lib::stream::impl::buffer: lib::data::rstream_t
 
 data::result_t buffer::read( const data::buffer_t & buffer )/* override*/ {
 	const auto & peek_count = peek( buffer );
-	if ( peek_count.success() )
-		read_pos_ += peek_count;
-	return peek_count;
+	if ( peek_count.failed() )
+		return peek_count;
+	read_pos_ += peek_count.value();
+	const auto & rest = buffer.subspan( peek_count.value() );
+	if ( empty() or rest.empty() or rest.size() < capacity_ )
+		return peek_count;
+	/// @note Buffered data is drained at this point, so a large read goes straight to the stream.
+	///       Bytes read this way are counted by read_pos(), but can not be rewound.
+	const auto & read_size_ = stream->read_size();
+	if ( read_size_.failed() or read_size_.value() == 0 )
+		return peek_count;
+	const auto & direct_count = stream->read( rest.first( ::std::min( rest.size(), read_size_.value() ) ) );
+	if ( direct_count.failed() )
+		return peek_count.value() == 0 ? direct_count : peek_count;
+	bypassed += direct_count.value();
+	return peek_count.value() + direct_count.value();
 }
 
 data::result_t buffer::peek( const data::buffer_t & buffer )/* override*/ {
 	const auto & read_size_ = read_size();
 	CPP_ASSERT( read_size_.success() );
 	const auto count = ::std::min( buffer.size(), read_size_.value() );
-	::memcpy( buffer.data(), &read_buff[read_pos_], count );
-	return count;
+	return read_buff.copy( buffer.first( count ), read_pos_ );
 }
 
 bool buffer::read_flush()/* override*/ {
 	if ( empty() )
 		return true;
-	read_buff.erase( read_buff.begin(), read_buff.begin() + (isize) read_pos_ );
+	read_buff.consume( read_pos_ );
 	read_pos_ = 0;
-	const auto current_size = read_buff.size();
-	const auto available_size = read_buff.capacity() - current_size;
-	auto read_size_ = stream->read_size();
+	bypassed = 0;
+	const auto & read_size_ = stream->read_size();
 	if ( read_size_.failed() )
 		return false;
-	const auto count = ::std::min( read_size_.value(), available_size );
-	if ( count == 0 )
-		return true;
-	read_buff.resize( read_buff.capacity() );
-	read_size_ = stream->read({ &read_buff[current_size], count });
-	if ( read_size_.failed() )
-		return false;
-	read_buff.resize( current_size + read_size_.value() );
+	auto count = ::std::min( read_size_.value(), capacity_ - read_buff.size() );
+	while ( count > 0 ) {
+		const auto & spare = read_buff.spare_segment();
+		const auto chunk = ::std::min( count, spare.size() );
+		const auto & read_count = stream->read( spare.first( chunk ) );
+		if ( read_count.failed() )
+			return false;
+		read_buff.commit( read_count.value() );
+		if ( read_count.value() < chunk )
+			break;
+		count -= chunk;
+	}
 	return true;
 }
 
@@ -83,52 +106,67 @@ data::result_t buffer::read_size()/* override*/ {
 }
 
 data::result_t buffer::read_pos( usize position )/* override*/ {
+	// Bypassed bytes follow the whole read_buff, they can't be read once again.
+	if ( bypassed > 0 )
+		return position == read_pos_ + bypassed
+			? data::result_t {position}
+			: data::result_t {make_error_not_implemented()};
 	return read_pos_ = ::std::min( position, read_buff.size() );
 }
 
 data::result_t buffer::read_pos()/* override*/ {
-	return read_pos_;
+	return read_pos_ + bypassed;
 }
 
 data::cbuffer_t buffer::read_cbuffer( bool flush )/* override*/ {
 	if ( flush and not read_flush() )
 		return {};
-	const auto & read_size_ = read_size();
-	CPP_ASSERT( read_size_.success() );
-	return {&read_buff[read_pos_], read_size_.value()};
+	return read_buff.linearize().subspan( read_pos_ );
 }
 
 // IMPLEMENTATION lib::stream::impl::buffer: lib::data::wstream_t
 
 data::result_t buffer::write( const data::cbuffer_t & buffer )/* override*/ {
-	const auto & write_size_ = write_size();
-	CPP_ASSERT( write_size_.success() );
-	const auto count = ::std::min( buffer.size(), write_size_.value() );
-	const auto write_pos_ = write_buff.size();
-	write_buff.resize( write_buff.size() + count );
-	::memcpy( &write_buff[write_pos_], buffer.data(), count );
-	return count;
+	if ( empty() or buffer.empty() or buffer.size() < capacity_ )
+		return stage( buffer );
+	if ( not write_flush() ) {
+		const auto & error_ = stream->write_error();
+		return data::result_t {error_ ? error_ : make_error_logic_broken()};
+	}
+	if ( not write_buff.empty() )
+		return stage( buffer );
+	/// @note Nothing is buffered at this point, so a large write goes straight to the stream.
+	const auto & direct_count = stream->write( buffer );
+	if ( direct_count.failed() and stream->write_error() )
+		return direct_count;
+	const auto count = direct_count.success() ? direct_count.value() : 0;
+	return count + stage( buffer.subspan( count ) ).value();
 }
 
 bool buffer::write_flush()/* override*/ {
-	if ( empty() or write_buff.empty() )
+	if ( empty() )
 		return true;
-	const auto & write_size_ = stream->write( write_buff );
-	if ( write_size_.failed() )
-		return false;
-	write_buff.erase( write_buff.begin(), write_buff.begin() + (isize) write_size_.value() );
+	while ( not write_buff.empty() ) {
+		const auto & segment = write_buff.segment();
+		const auto & write_size_ = stream->write( segment );
+		if ( write_size_.failed() )
+			return false;
+		write_buff.consume( write_size_.value() );
+		if ( write_size_.value() < segment.size() )
+			break;
+	}
 	return true;
 }
 
 data::result_t buffer::write_size()/* override*/ {
-	return write_buff.capacity() - write_buff.size();
+	return capacity_ - write_buff.size();
 }
 
 data::result_t buffer::write_pos( usize position ) {
 	if ( empty() )
 		return make_error_not_configured();
-	write_buff.resize( position );
-	return position;
+	write_buff.resize( ::std::min( position, capacity_ ) );
+	return write_buff.size();
 }
 
 data::result_t buffer::write_pos() {
@@ -138,7 +176,7 @@ data::result_t buffer::write_pos() {
 data::buffer_t buffer::write_buffer( bool flush ) {
 	if ( flush and not write_flush() )
 		return {};
-	return write_buff;
+	return write_buff.linearize();
 }
 
 // IMPLEMENTATION lib::stream::impl::buffer: lib::data::rwstream_t
@@ -8,10 +8,9 @@
 #ifndef CPPLIB__lib__impl__stream__buffer__hpp
 #define CPPLIB__lib__impl__stream__buffer__hpp
 
-#include <vector>
-
 #include "../../../lib/types.hpp"
 #include "../../../lib/data/stream.hpp"
+#include "../../../lib/tl/ringfifo.hpp"
 
 // DECLARATION lib::stream::impl::buffer
 
@@ -27,12 +26,17 @@ namespace lib::stream::impl {
  *     /       ,--- write_flush() ---, ,-- write_size() --,
  * write_buff [.....write_buffer()....] . . . . . . . . . .]
  *                                   /                      \
- *                        write_buff.size()         write_buff.capacity()
+ *                        write_buff.size()              capacity()
  *                            write_pos()
+ *
+ * Both buffers are rings: flushes consume data in O(1) instead of compacting storage.
+ * Reads and writes of at least capacity() bytes bypass an empty buffer and go straight
+ * to/from the underlying stream (one copy instead of two).
+ * @note Bypassed reads advance read_pos(), but it can't be rewound until read_flush().
  */
 
 class buffer final
-	: public data::rwstream_t
+	: public lib::data::rwstream_t
 {
 public:
 	/// @todo buffer( rwstream_t, size )
@@ -40,28 +44,29 @@ public:
 	virtual ~buffer() = default;
 
 	/// @todo reset( rwstream_t, size )
-	void reset( data::rwstream_t * stream_ = nullptr );
+	void reset( lib::data::rwstream_t * stream_ = nullptr );
 	bool empty() const;
+	usize capacity() const { return capacity_; }
 
 	// IMPLEMENTATION lib::data::rstream_t
 
-	data::result_t read( const data::buffer_t & buffer ) override;
-	data::result_t peek( const data::buffer_t & buffer ) override;
+	lib::data::result_t read( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t peek( const lib::data::buffer_t & buffer ) override;
 	bool read_flush() override;
-	data::result_t read_size() override;
-	data::result_t read_pos( usize position ) override;
-	data::result_t read_pos() override;
-	data::cbuffer_t read_cbuffer( bool flush ) override;
+	lib::data::result_t read_size() override;
+	lib::data::result_t read_pos( usize position ) override;
+	lib::data::result_t read_pos() override;
+	lib::data::cbuffer_t read_cbuffer( bool flush ) override;
 	::std::error_condition read_error() const override { return error(); }
 
 	// IMPLEMENTATION lib::data::wstream_t
 
-	data::result_t write( const data::cbuffer_t & buffer ) override;
+	lib::data::result_t write( const lib::data::cbuffer_t & buffer ) override;
 	bool write_flush() override;
-	data::result_t write_size() override;
-	data::result_t write_pos( usize position ) override;
-	data::result_t write_pos() override;
-	data::buffer_t write_buffer( bool flush ) override;
+	lib::data::result_t write_size() override;
+	lib::data::result_t write_pos( usize position ) override;
+	lib::data::result_t write_pos() override;
+	lib::data::buffer_t write_buffer( bool flush ) override;
 	::std::error_condition write_error() const override { return error(); }
 
 	// IMPLEMENTATION lib::data::rwstream_t
@@ -69,13 +74,16 @@ public:
 	bool flush() override { return read_flush() and write_flush(); }
 	::std::error_condition error() const override;
 private:
-	/// @todo Implement ::lib::ringbuffer<> with interface like ::std::vector<>.
+	lib::data::result_t stage( const lib::data::cbuffer_t & buffer );
 
-	data::rwstream_t * stream;
+	lib::data::rwstream_t * stream;
 
+	usize capacity_;
 	usize read_pos_;
-	::std::vector<u8> read_buff;
-	::std::vector<u8> write_buff;
+	/// @brief Bytes read past read_buff since the last read_flush().
+	usize bypassed;
+	tl::ringfifo<u8> read_buff;
+	tl::ringfifo<u8> write_buff;
 };
 
 } // namespace lib::stream::impl
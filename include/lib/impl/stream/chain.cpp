@@ -0,0 +1,220 @@
+/* File: /lib/impl/stream/chain.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <cstring>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include <cpp/lib_debug>
+
+#include "./chain.hpp"
+
+namespace lib::stream::impl {
+
+// DECLARATION lib::stream::impl::chain::block
+
+struct chain::block {
+	block * next = nullptr;
+	::std::unique_ptr<u8[]> data;
+};
+
+// IMPLEMENTATION lib::stream::impl::chain::pool
+
+chain::pool::pool( usize block_size, usize max_free/* = UNLIMITED*/ )
+	: block_size_ {block_size}
+	, max_free {max_free}
+{
+	CPP_ASSERT( block_size_ > 0 );
+}
+
+chain::pool::~pool() {
+	CPP_ASSERT( free_count_ == allocated_count_ );
+	shrink_to_fit();
+}
+
+void chain::pool::reserve( usize count ) {
+	while ( free_count_ < count ) {
+		auto * block_ = new block {free_list, ::std::make_unique_for_overwrite<u8[]>( block_size_ )};
+		free_list = block_;
+		++free_count_;
+		++allocated_count_;
+	}
+}
+
+void chain::pool::shrink_to_fit() noexcept {
+	while ( free_list != nullptr ) {
+		delete ::std::exchange( free_list, free_list->next );
+		--free_count_;
+		--allocated_count_;
+	}
+}
+
+chain::block * chain::pool::acquire() {
+	reserve( 1 );
+	auto * block_ = ::std::exchange( free_list, free_list->next );
+	--free_count_;
+	block_->next = nullptr;
+	return block_;
+}
+
+void chain::pool::release( block * block_ ) noexcept {
+	CPP_ASSERT( block_ != nullptr );
+	if ( free_count_ >= max_free ) {
+		delete block_;
+		--allocated_count_;
+		return;
+	}
+	block_->next = free_list;
+	free_list = block_;
+	++free_count_;
+}
+
+// IMPLEMENTATION lib::stream::impl::chain
+
+chain::chain( usize block_size/* = DEFAULT_BLOCK_SIZE*/ )
+	: own_pool {::std::make_unique<pool>( block_size )}
+	, pool_ {own_pool.get()}
+{}
+
+chain::chain( pool & shared_pool )
+	: pool_ {&shared_pool}
+{}
+
+chain::~chain() {
+	clear();
+}
+
+void chain::clear() noexcept {
+	while ( head != nullptr )
+		pool_->release( ::std::exchange( head, head->next ) );
+	tail = read_block = nullptr;
+	head_offset = tail_size = size_ = read_offset = read_pos_ = 0;
+}
+
+usize chain::block_size() const noexcept {
+	return pool_->block_size();
+}
+
+void chain::append_block() {
+	auto * block_ = pool_->acquire();
+	if ( tail == nullptr ) {
+		head = read_block = block_;
+		head_offset = read_offset = 0;
+	} else
+		tail->next = block_;
+	tail = block_;
+	tail_size = 0;
+}
+
+usize chain::block_end( const block * block_ ) const noexcept {
+	return block_ == tail ? tail_size : block_size();
+}
+
+usize chain::copy( block *& block_, usize & offset, const data::buffer_t & buffer ) const noexcept {
+	usize count = 0;
+	while ( count < buffer.size() and block_ != nullptr ) {
+		const auto end = block_end( block_ );
+		if ( offset == end ) {
+			if ( block_->next == nullptr )
+				break;
+			block_ = block_->next;
+			offset = 0;
+			continue;
+		}
+		const auto chunk = ::std::min( buffer.size() - count, end - offset );
+		::std::memcpy( buffer.data() + count, block_->data.get() + offset, chunk );
+		offset += chunk;
+		count += chunk;
+	}
+	return count;
+}
+
+// IMPLEMENTATION lib::stream::impl::chain: lib::data::rstream_t
+
+data::result_t chain::read( const data::buffer_t & buffer )/* override*/ {
+	const auto count = copy( read_block, read_offset, buffer );
+	read_pos_ += count;
+	return count;
+}
+
+data::result_t chain::peek( const data::buffer_t & buffer )/* override*/ {
+	auto * block_ = read_block;
+	auto offset = read_offset;
+	return copy( block_, offset, buffer );
+}
+
+bool chain::read_flush()/* override*/ {
+	while ( head != read_block )
+		pool_->release( ::std::exchange( head, head->next ) );
+	head_offset = read_offset;
+	size_ -= read_pos_;
+	read_pos_ = 0;
+	/// @note Fully consumed chain gives its last block back too.
+	if ( size_ == 0 )
+		clear();
+	return true;
+}
+
+data::result_t chain::read_size()/* override*/ {
+	return size_ - read_pos_;
+}
+
+data::result_t chain::read_pos( usize position )/* override*/ {
+	read_pos_ = ::std::min( position, size_ );
+	read_block = head;
+	read_offset = head_offset;
+	for ( auto rest = read_pos_; rest > 0; ) {
+		const auto chunk = ::std::min( rest, block_end( read_block ) - read_offset );
+		read_offset += chunk;
+		rest -= chunk;
+		if ( rest > 0 ) {
+			read_block = read_block->next;
+			read_offset = 0;
+		}
+	}
+	return read_pos_;
+}
+
+data::result_t chain::read_pos()/* override*/ {
+	return read_pos_;
+}
+
+data::cbuffer_t chain::read_cbuffer( bool flush )/* override*/ {
+	if ( flush and not read_flush() )
+		return {};
+	if ( read_block == nullptr )
+		return {};
+	if ( read_offset == block_end( read_block ) and read_block->next != nullptr ) {
+		read_block = read_block->next;
+		read_offset = 0;
+	}
+	return { read_block->data.get() + read_offset, block_end( read_block ) - read_offset };
+}
+
+// IMPLEMENTATION lib::stream::impl::chain: lib::data::wstream_t
+
+data::result_t chain::write( const data::cbuffer_t & buffer )/* override*/ {
+	for ( auto rest = buffer; not rest.empty(); ) {
+		if ( tail == nullptr or tail_size == block_size() )
+			append_block();
+		const auto chunk = ::std::min( rest.size(), block_size() - tail_size );
+		::std::memcpy( tail->data.get() + tail_size, rest.data(), chunk );
+		tail_size += chunk;
+		size_ += chunk;
+		rest = rest.subspan( chunk );
+	}
+	return buffer.size();
+}
+
+data::result_t chain::write_size()/* override*/ {
+	return ::std::numeric_limits<usize>::max() - size_;
+}
+
+} // namespace lib::stream::impl
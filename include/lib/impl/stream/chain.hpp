@@ -0,0 +1,131 @@
+/* File: /lib/impl/stream/chain.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__impl__stream__chain__hpp
+#define CPPLIB__lib__impl__stream__chain__hpp
+
+#include <limits>
+#include <memory>
+
+#include "../../../lib/types.hpp"
+#include "../../../lib/data/stream.hpp"
+
+// DECLARATION lib::stream::impl::chain
+
+namespace lib::stream::impl {
+
+/**
+ * Fifo stream stored as a list of fixed size blocks taken from a (shareable) block pool.
+ * Writes never move stored bytes, read_flush() returns consumed blocks back to the pool.
+ *
+ *          ,-- read_flush() --, ,------------ read_size() -------------,
+ * blocks  [. . . . . . ][. . . |. . . . .][. . . . . . . . .][. . . . .]. . . .]
+ *          \                  read_pos()                               \
+ *        head_offset                                             tail_size
+ *
+ * @note read_cbuffer() returns contiguous data of the current block only.
+ */
+
+class chain final
+	: public lib::data::rwstream_t
+{
+public:
+	static constexpr usize DEFAULT_BLOCK_SIZE = 4096;
+
+	class pool;
+
+	/// @brief Uses own block pool.
+	chain( usize block_size = DEFAULT_BLOCK_SIZE );
+	/// @brief Uses shared block pool, which must outlive the chain.
+	chain( pool & shared_pool );
+	chain( const chain & ) = delete;
+	virtual ~chain();
+
+	chain & operator = ( const chain & ) = delete;
+
+	void clear() noexcept;
+	usize block_size() const noexcept;
+
+	// IMPLEMENTATION lib::data::rstream_t
+
+	lib::data::result_t read( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t peek( const lib::data::buffer_t & buffer ) override;
+	bool read_flush() override;
+	lib::data::result_t read_size() override;
+	lib::data::result_t read_pos( usize position ) override;
+	lib::data::result_t read_pos() override;
+	lib::data::cbuffer_t read_cbuffer( bool flush ) override;
+	::std::error_condition read_error() const override { return error(); }
+
+	// IMPLEMENTATION lib::data::wstream_t
+
+	lib::data::result_t write( const lib::data::cbuffer_t & buffer ) override;
+	bool write_flush() override { return true; }
+	lib::data::result_t write_size() override;
+	::std::error_condition write_error() const override { return error(); }
+
+	// IMPLEMENTATION lib::data::rwstream_t
+
+	bool flush() override { return read_flush() and write_flush(); }
+	lib::data::result_t size() override { return read_size(); }
+	::std::error_condition error() const override { return {}; }
+private:
+	struct block;
+
+	void append_block();
+	usize block_end( const block * block_ ) const noexcept;
+	usize copy( block *& block_, usize & offset, const lib::data::buffer_t & buffer ) const noexcept;
+
+	::std::unique_ptr<pool> own_pool;
+	pool * pool_;
+
+	block * head = nullptr;
+	block * tail = nullptr;
+	usize head_offset = 0;
+	usize tail_size = 0;
+	usize size_ = 0;
+
+	block * read_block = nullptr;
+	usize read_offset = 0;
+	usize read_pos_ = 0;
+};
+
+// DECLARATION lib::stream::impl::chain::pool
+
+class chain::pool {
+public:
+	static constexpr usize UNLIMITED = ::std::numeric_limits<usize>::max();
+
+	/// @param max_free Released blocks above this count are deallocated.
+	explicit pool( usize block_size = DEFAULT_BLOCK_SIZE, usize max_free = UNLIMITED );
+	pool( const pool & ) = delete;
+	~pool();
+
+	pool & operator = ( const pool & ) = delete;
+
+	usize block_size() const noexcept { return block_size_; }
+	usize free_count() const noexcept { return free_count_; }
+	usize allocated_count() const noexcept { return allocated_count_; }
+
+	void reserve( usize count );
+	void shrink_to_fit() noexcept;
+private:
+	friend class chain;
+
+	block * acquire();
+	void release( block * block_ ) noexcept;
+
+	usize block_size_;
+	usize max_free;
+	block * free_list = nullptr;
+	usize free_count_ = 0;
+	usize allocated_count_ = 0;
+};
+
+} // namespace lib::stream::impl
+
+#endif // CPPLIB__lib__impl__stream__chain__hpp
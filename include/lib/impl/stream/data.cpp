@@ -6,8 +6,6 @@
  * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
  */
 
-#include <cstring>
-
 #include <algorithm>
 
 #include <cpp/lib_debug>
@@ -41,30 +39,11 @@ void data::reset( const lib::data::buffer_t & write_buff_ ) {
 
 // IMPLEMENTATION lib::stream::impl::data: lib::data::rstream_t
 
-lib::data::result_t data::read( const lib::data::buffer_t & buffer )/* override*/ {
-	const auto & peek_count = peek( buffer );
-	CPP_ASSERT( peek_count.success() );
-	read_pos_ += peek_count;
-	return peek_count;
-}
-
-lib::data::result_t data::peek( const lib::data::buffer_t & buffer )/* override*/ {
-	const auto & read_size_ = read_size();
-	CPP_ASSERT( read_size_.success() );
-	const auto count = ::std::min( buffer.size(), read_size_.value() );
-	::std::memcpy( buffer.data(), &read_buff[read_pos_], count );
-	return count;
-}
-
 bool data::read_flush()/* override*/ {
 	read_pos_ = 0;
 	return true;
 }
 
-lib::data::result_t data::read_size()/* override*/ {
-	return read_buff.size() - read_pos_;
-}
-
 lib::data::result_t data::read_pos( usize position )/* override*/ {
 	return read_pos_ = ::std::min( position, read_buff.size() );
 }
@@ -83,24 +62,11 @@ lib::data::cbuffer_t data::read_cbuffer( bool flush )/* override*/ {
 
 // IMPLEMENTATION lib::stream::impl::data: lib::data::wstream_t
 
-lib::data::result_t data::write( const lib::data::cbuffer_t & buffer )/* override*/ {
-	const auto & write_size_ = write_size();
-	CPP_ASSERT( write_size_.success() );
-	const auto count = ::std::min( buffer.size(), write_size_.value() );
-	::std::memcpy( &write_buff[write_pos_], buffer.data(), count );
-	write_pos_ += count;
-	return count;
-}
-
 bool data::write_flush()/* override*/ {
 	write_pos_ = 0;
 	return true;
 }
 
-lib::data::result_t data::write_size()/* override*/ {
-	return write_buff.size() - write_pos_;
-}
-
 lib::data::result_t data::write_pos( usize position )/* override*/ {
 	return write_pos_ = ::std::min( position, write_buff.size() );
 }
@@ -8,6 +8,12 @@
 #ifndef CPPLIB__lib__impl__stream__data__hpp
 #define CPPLIB__lib__impl__stream__data__hpp
 
+#include <cstring>
+
+#include <algorithm>
+
+#include <cpp/lib_debug>
+
 #include "../../../lib/types.hpp"
 #include "../../../lib/data/stream.hpp"
 
@@ -78,6 +84,40 @@ private:
 	usize write_pos_ = 0;
 };
 
+// INLINES lib::stream::impl::data
+
+inline lib::data::result_t data::read( const lib::data::buffer_t & buffer )/* override*/ {
+	const auto & peek_count = peek( buffer );
+	CPP_ASSERT( peek_count.success() );
+	read_pos_ += peek_count;
+	return peek_count;
+}
+
+inline lib::data::result_t data::peek( const lib::data::buffer_t & buffer )/* override*/ {
+	const auto & read_size_ = read_size();
+	CPP_ASSERT( read_size_.success() );
+	const auto count = ::std::min( buffer.size(), read_size_.value() );
+	::std::memcpy( buffer.data(), &read_buff[read_pos_], count );
+	return count;
+}
+
+inline lib::data::result_t data::read_size()/* override*/ {
+	return read_buff.size() - read_pos_;
+}
+
+inline lib::data::result_t data::write( const lib::data::cbuffer_t & buffer )/* override*/ {
+	const auto & write_size_ = write_size();
+	CPP_ASSERT( write_size_.success() );
+	const auto count = ::std::min( buffer.size(), write_size_.value() );
+	::std::memcpy( &write_buff[write_pos_], buffer.data(), count );
+	write_pos_ += count;
+	return count;
+}
+
+inline lib::data::result_t data::write_size()/* override*/ {
+	return write_buff.size() - write_pos_;
+}
+
 } // namespace lib::stream::impl
 
 #endif // CPPLIB__lib__impl__stream__data__hpp
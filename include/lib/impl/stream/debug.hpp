@@ -18,39 +18,39 @@
 namespace lib::stream::impl {
 
 class debug final
-	: public data::rwstream_t
+	: public lib::data::rwstream_t
 {
 public:
 	debug();
-	debug( data::rwstream_t * stream, usize min_rw, usize max_rw );
+	debug( lib::data::rwstream_t * stream, usize min_rw, usize max_rw );
 	virtual ~debug() = default;
 
 	void reset();
-	void reset( data::rwstream_t * stream, usize min_rw, usize max_rw );
+	void reset( lib::data::rwstream_t * stream, usize min_rw, usize max_rw );
 	void shuffle();
 
 	// IMPLEMENTATION lib::data::rstream_t
 
-	data::result_t read( const data::buffer_t & buffer ) override;
-	data::result_t peek( const data::buffer_t & buffer ) override;
+	lib::data::result_t read( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t peek( const lib::data::buffer_t & buffer ) override;
 	bool read_flush() override;
-	data::result_t read_size() override;
+	lib::data::result_t read_size() override;
 	::std::error_condition read_error() const override;
 
 	// IMPLEMENTATION lib::data::wstream_t
 
-	data::result_t write( const data::cbuffer_t & buffer ) override;
+	lib::data::result_t write( const lib::data::cbuffer_t & buffer ) override;
 	bool write_flush() override;
-	data::result_t write_size() override;
+	lib::data::result_t write_size() override;
 	::std::error_condition write_error() const override;
 
 	// IMPLEMENTATION lib::data::rwstream_t
 
 	bool flush() override;
-	data::result_t size() override;
+	lib::data::result_t size() override;
 	::std::error_condition error() const override;
 private:
-	data::rwstream_t * stream;
+	lib::data::rwstream_t * stream;
 	usize min_rw;
 	usize max_rw;
 	usize next_read;
@@ -8,9 +8,13 @@
 #ifndef CPPLIB__lib__impl__stream__fifo__hpp
 #define CPPLIB__lib__impl__stream__fifo__hpp
 
-#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include <cpp/lib_debug>
 
 #include "../../../lib/types.hpp"
+#include "../../../lib/tl/ringfifo.hpp"
 #include "../../../lib/data/stream.hpp"
 
 // DECLARATION lib::stream::impl::fifo
@@ -29,10 +33,13 @@ namespace lib::stream::impl {
  *                                   /                       \
  *                        write_buff.size()              RAM limit
  *                            write_pos()
+ *
+ * @note Data is stored in a ring, so read_flush() is O(1). The ring is linearized on
+ * demand by read_cbuffer() and write_buffer() only if the data wraps the storage end.
  */
 
 class fifo final
-	: public data::rwstream_t
+	: public lib::data::rwstream_t
 {
 public:
 	fifo() = default;
@@ -40,37 +47,67 @@ public:
 
 	// IMPLEMENTATION lib::data::rstream_t
 
-	data::result_t read( const data::buffer_t & buffer ) override;
-	data::result_t peek( const data::buffer_t & buffer ) override;
+	lib::data::result_t read( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t peek( const lib::data::buffer_t & buffer ) override;
 	bool read_flush() override;
-	data::result_t read_size() override;
-	data::result_t read_pos( usize position ) override;
-	data::result_t read_pos() override;
-	data::cbuffer_t read_cbuffer( bool flush ) override;
+	lib::data::result_t read_size() override;
+	lib::data::result_t read_pos( usize position ) override;
+	lib::data::result_t read_pos() override;
+	lib::data::cbuffer_t read_cbuffer( bool flush ) override;
 	::std::error_condition read_error() const override { return error(); }
 
 	// IMPLEMENTATION lib::data::wstream_t
 
-	data::result_t write( const data::cbuffer_t & buffer ) override;
+	lib::data::result_t write( const lib::data::cbuffer_t & buffer ) override;
 	bool write_flush() override;
-	data::result_t write_size() override;
-	data::result_t write_pos( usize position ) override;
-	data::result_t write_pos() override;
-	data::buffer_t write_buffer( bool flush ) override;
+	lib::data::result_t write_size() override;
+	lib::data::result_t write_pos( usize position ) override;
+	lib::data::result_t write_pos() override;
+	lib::data::buffer_t write_buffer( bool flush ) override;
 	::std::error_condition write_error() const override { return error(); }
 
 	// IMPLEMENTATION lib::data::rwstream_t
 
 	bool flush() override;
-	data::result_t size() override;
+	lib::data::result_t size() override;
 	::std::error_condition error() const override { return {}; }
 private:
-	/// @todo Implement ::lib::ringfifo<> with interface like ::std::vector<>.
-
-	::std::vector<u8> buffer_;
+	tl::ringfifo<u8> buffer_;
 	usize read_pos_ = 0;
 };
 
+// INLINES lib::stream::impl::fifo
+
+inline lib::data::result_t fifo::read( const lib::data::buffer_t & buffer )/* override*/ {
+	const auto & peek_count = peek( buffer );
+	CPP_ASSERT( peek_count.success() );
+	read_pos_ += peek_count;
+	return peek_count;
+}
+
+inline lib::data::result_t fifo::peek( const lib::data::buffer_t & buffer )/* override*/ {
+	const auto & read_size_ = read_size();
+	CPP_ASSERT( read_size_.success() );
+	const auto count = ::std::min( buffer.size(), read_size_.value() );
+	return buffer_.copy( buffer.first( count ), read_pos_ );
+}
+
+inline lib::data::result_t fifo::read_size()/* override*/ {
+	return buffer_.size() - read_pos_;
+}
+
+inline lib::data::result_t fifo::write( const lib::data::cbuffer_t & buffer )/* override*/ {
+	const auto & write_size_ = write_size();
+	CPP_ASSERT( write_size_.success() );
+	const auto count = ::std::min( buffer.size(), write_size_.value() );
+	buffer_.append( buffer.first( count ) );
+	return count;
+}
+
+inline lib::data::result_t fifo::write_size()/* override*/ {
+	return ::std::numeric_limits<usize>::max() - buffer_.size();
+}
+
 } // namespace lib::stream::impl
 
 #endif // CPPLIB__lib__impl__stream__fifo__hpp
@@ -10,6 +10,11 @@
 
 #include <cpp/lib_debug>
 
+#include "../../../lib/debug/platform.hpp"
+#if defined(CPPLIB_PLATFORM_POSIX)
+	#include <stdio.h>
+#endif // CPPLIB_PLATFORM_POSIX
+
 #include "./file.hpp"
 
 namespace lib::stream::impl {
@@ -91,6 +96,16 @@ data::result_t file::write( const data::cbuffer_t & buffer )/* override*/ {
 	return result;
 }
 
+int file::read_fd()/* override*/ {
+#if defined(CPPLIB_PLATFORM_POSIX)
+	if ( file_ == nullptr or not flush() )
+		return -1;
+	return ::fileno( file_ );
+#else
+	return -1;
+#endif // CPPLIB_PLATFORM_POSIX
+}
+
 // IMPLEMENTATION lib::stream::impl::file: lib::data::unistream_t
 
 bool file::flush()/* override*/ {
@@ -19,7 +19,7 @@
 namespace lib::stream::impl {
 
 class file final
-	: public data::unistream_t
+	: public lib::data::unistream_t
 {
 public:
 	/// @todo Add open mode constants/enum?
@@ -40,19 +40,21 @@ public:
 
 	// IMPLEMENTATION lib::data::rstream_t, lib::data::wstream_t
 
-	data::result_t read( const data::buffer_t & buffer ) override;
-	data::result_t peek( const data::buffer_t & buffer ) override;
-	data::result_t write( const data::cbuffer_t & buffer ) override;
+	lib::data::result_t read( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t peek( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t write( const lib::data::cbuffer_t & buffer ) override;
+	/// @note Flushes stdio buffers, so descriptor offset matches pos().
+	int read_fd() override;
 
 	// IMPLEMENTATION lib::data::unistream_t
 
 	bool flush() override;
-	data::result_t size() override;
+	lib::data::result_t size() override;
 
 	// IMPLEMENTATION lib::data::rwstream_t
 
-	data::result_t pos( usize position ) override;
-	data::result_t pos() override;
+	lib::data::result_t pos( usize position ) override;
+	lib::data::result_t pos() override;
 	::std::error_condition error() const override { return error_; }
 private:
 	const ::std::error_condition & set_error_from_errno();
@@ -0,0 +1,283 @@
+/* File: /lib/impl/stream/metered.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "../../../lib/system/error.hpp"
+
+#include "./metered.hpp"
+
+namespace lib::stream::impl {
+
+namespace {
+
+/// @note Single writer: plain load/store keeps updates cheap and snapshots race-free.
+inline void add( ::std::atomic<u64> & counter, u64 value ) noexcept {
+	counter.store( counter.load( ::std::memory_order_relaxed ) + value, ::std::memory_order_relaxed );
+}
+
+inline void copy( ::std::atomic<u64> & to, const ::std::atomic<u64> & from ) noexcept {
+	to.store( from.load( ::std::memory_order_relaxed ), ::std::memory_order_relaxed );
+}
+
+template< class...Args >
+void append( ::std::string & out, const char * format, Args...args ) {
+	char line[256];
+	const auto count = ::std::snprintf( line, sizeof( line ), format, args... );
+	out.append( line, (usize) ::std::clamp( count, 0, (int) sizeof( line ) - 1 ) );
+}
+
+using clock = ::std::chrono::steady_clock;
+
+inline u64 elapsed_ns( const clock::time_point & start ) noexcept {
+	return (u64) ::std::chrono::duration_cast<::std::chrono::nanoseconds>( clock::now() - start ).count();
+}
+
+} // namespace
+
+// IMPLEMENTATION lib::stream::impl::metered::stats
+
+metered::stats & metered::stats::operator = ( const stats & other ) noexcept {
+	copy( calls, other.calls );
+	copy( bytes, other.bytes );
+	copy( shorts, other.shorts );
+	copy( errors, other.errors );
+	latency = other.latency;
+	return *this;
+}
+
+void metered::stats::clear() noexcept {
+	calls.store( 0, ::std::memory_order_relaxed );
+	bytes.store( 0, ::std::memory_order_relaxed );
+	shorts.store( 0, ::std::memory_order_relaxed );
+	errors.store( 0, ::std::memory_order_relaxed );
+	latency.clear();
+}
+
+// IMPLEMENTATION lib::stream::impl::metered::snapshot_t
+
+const char * metered::snapshot_t::name( Op op ) noexcept {
+	switch ( op ) {
+	case Op::READ:	return "read";
+	case Op::PEEK:	return "peek";
+	case Op::WRITE:	return "write";
+	case Op::FLUSH:	return "flush";
+	case Op::COUNT:	break;
+	}
+	return "unknown";
+}
+
+::std::string metered::snapshot_t::text() const {
+	::std::string out;
+	append( out, "%-6s %12s %16s %10s %8s %10s %10s %10s %10s %10s %10s %10s\n"
+		, "op", "calls", "bytes", "short", "errors", "min", "mean", "p50", "p90", "p99", "p999", "max" );
+	for ( usize i = 0; i < ops.size(); ++i ) {
+		const auto & op = ops[i];
+		const auto & latency = op.latency;
+		append( out, "%-6s %12" PRIu64 " %16" PRIu64 " %10" PRIu64 " %8" PRIu64 " %10" PRIu64 " %10.0f"
+			, name( (Op) i ), op.calls.load(), op.bytes.load(), op.shorts.load(), op.errors.load()
+			, latency.min(), latency.mean() );
+		for ( const auto & percentile : histogram::PERCENTILES )
+			append( out, " %10" PRIu64, latency.percentile( percentile.quantile ) );
+		append( out, " %10" PRIu64 "\n", latency.max() );
+	}
+	return out;
+}
+
+::std::string metered::snapshot_t::json() const {
+	::std::string out = "{";
+	for ( usize i = 0; i < ops.size(); ++i ) {
+		const auto & op = ops[i];
+		append( out, "%s\"%s\":{\"calls\":%" PRIu64 ",\"bytes\":%" PRIu64 ",\"short\":%" PRIu64 ",\"errors\":%" PRIu64
+			, i == 0 ? "" : ",", name( (Op) i ), op.calls.load(), op.bytes.load(), op.shorts.load(), op.errors.load() );
+		out += ",\"latency_ns\":";
+		out += op.latency.json();
+		out += "}";
+	}
+	out += "}";
+	return out;
+}
+
+// IMPLEMENTATION lib::stream::impl::metered
+
+metered::metered()
+{ reset(); }
+
+metered::metered( data::rwstream_t * stream )
+{ reset( stream ); }
+
+void metered::reset() {
+	reset( nullptr );
+}
+
+void metered::reset( data::rwstream_t * stream_ ) {
+	stream = stream_;
+	clear();
+}
+
+void metered::clear() noexcept {
+	for ( auto & op : snapshot_.ops )
+		op.clear();
+}
+
+template< class Fn >
+inline data::result_t metered::measure( Op op, usize requested, Fn && fn ) {
+	if ( stream == nullptr )
+		return make_error_not_configured();
+	const auto start = clock::now();
+	const auto result = fn();
+	auto & stats_ = snapshot_.ops[(usize) op];
+	stats_.latency.record( elapsed_ns( start ) );
+	add( stats_.calls, 1 );
+	if ( result.failed() ) {
+		add( stats_.errors, 1 );
+		return result;
+	}
+	add( stats_.bytes, result.value() );
+	if ( result.value() < requested )
+		add( stats_.shorts, 1 );
+	return result;
+}
+
+template< class Fn >
+inline bool metered::measure_flush( Fn && fn ) {
+	if ( stream == nullptr )
+		return false;
+	const auto start = clock::now();
+	const bool result = fn();
+	auto & stats_ = snapshot_.ops[(usize) Op::FLUSH];
+	stats_.latency.record( elapsed_ns( start ) );
+	add( stats_.calls, 1 );
+	if ( not result )
+		add( stats_.errors, 1 );
+	return result;
+}
+
+// IMPLEMENTATION lib::stream::impl::metered: lib::data::rstream_t
+
+data::result_t metered::read( const data::buffer_t & buffer )/* override*/ {
+	return measure( Op::READ, buffer.size(), [&]() { return stream->read( buffer ); } );
+}
+
+data::result_t metered::readv( ::std::span<const data::buffer_t> buffers )/* override*/ {
+	usize requested = 0;
+	for ( const auto & buffer : buffers )
+		requested += buffer.size();
+	return measure( Op::READ, requested, [&]() { return stream->readv( buffers ); } );
+}
+
+data::result_t metered::peek( const data::buffer_t & buffer )/* override*/ {
+	return measure( Op::PEEK, buffer.size(), [&]() { return stream->peek( buffer ); } );
+}
+
+bool metered::read_flush()/* override*/ {
+	return measure_flush( [&]() { return stream->read_flush(); } );
+}
+
+data::result_t metered::read_size()/* override*/ {
+	return stream != nullptr ? stream->read_size() : make_error_not_configured();
+}
+
+data::result_t metered::read_pos( usize position )/* override*/ {
+	return stream != nullptr ? stream->read_pos( position ) : make_error_not_configured();
+}
+
+data::result_t metered::read_pos()/* override*/ {
+	return stream != nullptr ? stream->read_pos() : make_error_not_configured();
+}
+
+data::buffer_t metered::read_buffer( bool flush )/* override*/ {
+	return stream != nullptr ? stream->read_buffer( flush ) : data::buffer_t {};
+}
+
+data::cbuffer_t metered::read_cbuffer( bool flush )/* override*/ {
+	return stream != nullptr ? stream->read_cbuffer( flush ) : data::cbuffer_t {};
+}
+
+int metered::read_fd()/* override*/ {
+	return stream != nullptr ? stream->read_fd() : -1;
+}
+
+::std::error_condition metered::read_error() const/* override*/ {
+	return stream != nullptr ? stream->read_error() : make_error_no_error();
+}
+
+// IMPLEMENTATION lib::stream::impl::metered: lib::data::wstream_t
+
+data::result_t metered::write( const data::cbuffer_t & buffer )/* override*/ {
+	return measure( Op::WRITE, buffer.size(), [&]() { return stream->write( buffer ); } );
+}
+
+data::result_t metered::writev( ::std::span<const data::cbuffer_t> buffers )/* override*/ {
+	usize requested = 0;
+	for ( const auto & buffer : buffers )
+		requested += buffer.size();
+	return measure( Op::WRITE, requested, [&]() { return stream->writev( buffers ); } );
+}
+
+bool metered::write_flush()/* override*/ {
+	return measure_flush( [&]() { return stream->write_flush(); } );
+}
+
+data::result_t metered::write_size()/* override*/ {
+	return stream != nullptr ? stream->write_size() : make_error_not_configured();
+}
+
+data::result_t metered::write_pos( usize position )/* override*/ {
+	return stream != nullptr ? stream->write_pos( position ) : make_error_not_configured();
+}
+
+data::result_t metered::write_pos()/* override*/ {
+	return stream != nullptr ? stream->write_pos() : make_error_not_configured();
+}
+
+data::buffer_t metered::write_buffer( bool flush )/* override*/ {
+	return stream != nullptr ? stream->write_buffer( flush ) : data::buffer_t {};
+}
+
+data::cbuffer_t metered::write_cbuffer( bool flush )/* override*/ {
+	return stream != nullptr ? stream->write_cbuffer( flush ) : data::cbuffer_t {};
+}
+
+int metered::write_fd()/* override*/ {
+	return stream != nullptr ? stream->write_fd() : -1;
+}
+
+::std::error_condition metered::write_error() const/* override*/ {
+	return stream != nullptr ? stream->write_error() : make_error_no_error();
+}
+
+// IMPLEMENTATION lib::stream::impl::metered: lib::data::rwstream_t
+
+bool metered::flush()/* override*/ {
+	return measure_flush( [&]() { return stream->flush(); } );
+}
+
+data::result_t metered::size()/* override*/ {
+	return stream != nullptr ? stream->size() : make_error_not_configured();
+}
+
+data::result_t metered::pos( usize position )/* override*/ {
+	return stream != nullptr ? stream->pos( position ) : make_error_not_configured();
+}
+
+data::result_t metered::pos()/* override*/ {
+	return stream != nullptr ? stream->pos() : make_error_not_configured();
+}
+
+::std::error_condition metered::error() const/* override*/ {
+	return stream != nullptr ? stream->error() : make_error_no_error();
+}
+
+} // namespace lib::stream::impl
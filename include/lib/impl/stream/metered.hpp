@@ -0,0 +1,138 @@
+/* File: /lib/impl/stream/metered.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__impl__stream__metered__hpp
+#define CPPLIB__lib__impl__stream__metered__hpp
+
+#include <array>
+#include <atomic>
+#include <string>
+
+#include "../../../lib/types.hpp"
+#include "../../../lib/literals.hpp"
+#include "../../../lib/data/stream.hpp"
+#include "../../../lib/utils/histogram.hpp"
+
+// DECLARATION lib::stream::impl::metered
+
+namespace lib::stream::impl {
+
+/**
+ * Decorator which measures calls of the wrapped stream: calls, bytes, short transfers,
+ * errors and per-call latency.
+ *
+ * @note Descriptors of the wrapped stream are exposed, so kernel transfers (sendfile/splice)
+ *       keep their fast path, but bytes moved that way aren't counted.
+ * @note Statistics have a single writer (thread using the stream), but snapshot() may be taken
+ *       from any other thread: counters are relaxed atomics updated without read-modify-write.
+ */
+
+class metered final
+	: public lib::data::rwstream_t
+{
+public:
+	enum class Op : u8 {
+		READ,	///< read(), readv()
+		PEEK,	///< peek()
+		WRITE,	///< write(), writev()
+		FLUSH,	///< flush(), read_flush(), write_flush()
+		COUNT,
+	};
+
+	using histogram = utils::histogram;
+
+	struct stats {
+		stats() noexcept = default;
+		stats( const stats & other ) noexcept { *this = other; }
+		stats & operator = ( const stats & other ) noexcept;
+
+		void clear() noexcept;
+
+		::std::atomic<u64> calls {0};
+		::std::atomic<u64> bytes {0};
+		/// @brief Successful calls which transferred less than requested.
+		::std::atomic<u64> shorts {0};
+		::std::atomic<u64> errors {0};
+		histogram latency;
+	};
+
+	struct snapshot_t {
+		static const char * name( Op op ) noexcept;
+
+		const stats & operator [] ( Op op ) const noexcept { return ops[(usize) op]; }
+
+		/// @brief Human readable table, latencies are in nanoseconds.
+		::std::string text() const;
+		/// @brief `{"read":{"calls":..,"latency_ns":{..,"buckets":[[min,count],..]}},..}`
+		::std::string json() const;
+
+		::std::array<stats, (usize) Op::COUNT> ops;
+	};
+
+	metered();
+	explicit metered( lib::data::rwstream_t * stream );
+	virtual ~metered() = default;
+
+	void reset();
+	void reset( lib::data::rwstream_t * stream );
+	/// @note Not synchronized with the thread using the stream.
+	void clear() noexcept;
+
+	const stats & operator [] ( Op op ) const noexcept { return snapshot_.ops[(usize) op]; }
+	snapshot_t snapshot() const noexcept { return snapshot_; }
+
+	// IMPLEMENTATION lib::data::rstream_t
+
+	lib::data::result_t read( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t readv( ::std::span<const lib::data::buffer_t> buffers ) override;
+	lib::data::result_t peek( const lib::data::buffer_t & buffer ) override;
+	bool read_flush() override;
+	lib::data::result_t read_size() override;
+	lib::data::result_t read_pos( usize position ) override;
+	lib::data::result_t read_pos() override;
+	lib::data::buffer_t read_buffer( bool flush ) override;
+	lib::data::cbuffer_t read_cbuffer( bool flush ) override;
+	using rstream_t::read_buffer;
+	using rstream_t::read_cbuffer;
+	int read_fd() override;
+	::std::error_condition read_error() const override;
+
+	// IMPLEMENTATION lib::data::wstream_t
+
+	lib::data::result_t write( const lib::data::cbuffer_t & buffer ) override;
+	lib::data::result_t writev( ::std::span<const lib::data::cbuffer_t> buffers ) override;
+	bool write_flush() override;
+	lib::data::result_t write_size() override;
+	lib::data::result_t write_pos( usize position ) override;
+	lib::data::result_t write_pos() override;
+	lib::data::buffer_t write_buffer( bool flush ) override;
+	lib::data::cbuffer_t write_cbuffer( bool flush ) override;
+	using wstream_t::write_buffer;
+	using wstream_t::write_cbuffer;
+	int write_fd() override;
+	::std::error_condition write_error() const override;
+
+	// IMPLEMENTATION lib::data::rwstream_t
+
+	bool flush() override;
+	lib::data::result_t size() override;
+	lib::data::result_t pos( usize position ) override;
+	lib::data::result_t pos() override;
+	::std::error_condition error() const override;
+private:
+	template< class Fn >
+	lib::data::result_t measure( Op op, usize requested, Fn && fn );
+	template< class Fn >
+	bool measure_flush( Fn && fn );
+
+	lib::data::rwstream_t * stream;
+	snapshot_t snapshot_;
+};
+
+} // namespace lib::stream::impl
+
+#endif // CPPLIB__lib__impl__stream__metered__hpp
@@ -0,0 +1,105 @@
+/* File: /lib/impl/stream/spsc.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+
+#include <cpp/lib_debug>
+
+#include "./spsc.hpp"
+
+namespace lib::stream::impl {
+
+// IMPLEMENTATION lib::stream::impl::spsc
+
+spsc::spsc( usize capacity )
+	: storage( ::std::bit_ceil( ::std::max<usize>( capacity, 1 ) ) )
+	, mask {storage.size() - 1}
+{}
+
+// IMPLEMENTATION lib::stream::impl::spsc: lib::data::rstream_t
+
+data::result_t spsc::read( const data::buffer_t & buffer )/* override*/ {
+	const auto & peek_count = peek( buffer );
+	if ( peek_count.success() )
+		read_pos_ += peek_count.value();
+	return peek_count;
+}
+
+data::result_t spsc::peek( const data::buffer_t & buffer )/* override*/ {
+	/// @note Producer's tail is re-read only if cached value is not enough.
+	if ( buffer.size() > cached_tail - read_head - read_pos_ )
+		cached_tail = tail.load( ::std::memory_order_acquire );
+	const auto count = ::std::min( buffer.size(), cached_tail - read_head - read_pos_ );
+	if ( count == 0 )
+		return count;
+	const auto first = ( read_head + read_pos_ ) & mask;
+	const auto chunk = ::std::min( count, capacity() - first );
+	::std::memcpy( buffer.data(), &storage[first], chunk );
+	::std::memcpy( buffer.data() + chunk, &storage[0], count - chunk );
+	return count;
+}
+
+bool spsc::read_flush()/* override*/ {
+	if ( read_pos_ == 0 )
+		return true;
+	read_head += read_pos_;
+	read_pos_ = 0;
+	head.store( read_head, ::std::memory_order_release );
+	return true;
+}
+
+data::result_t spsc::read_size()/* override*/ {
+	cached_tail = tail.load( ::std::memory_order_acquire );
+	return cached_tail - read_head - read_pos_;
+}
+
+data::result_t spsc::read_pos( usize position )/* override*/ {
+	cached_tail = tail.load( ::std::memory_order_acquire );
+	return read_pos_ = ::std::min( position, cached_tail - read_head );
+}
+
+data::result_t spsc::read_pos()/* override*/ {
+	return read_pos_;
+}
+
+data::cbuffer_t spsc::read_cbuffer( bool flush )/* override*/ {
+	if ( flush and not read_flush() )
+		return {};
+	const auto & read_size_ = read_size();
+	CPP_ASSERT( read_size_.success() );
+	const auto first = ( read_head + read_pos_ ) & mask;
+	return { &storage[first], ::std::min( read_size_.value(), capacity() - first ) };
+}
+
+// IMPLEMENTATION lib::stream::impl::spsc: lib::data::wstream_t
+
+data::result_t spsc::write( const data::cbuffer_t & buffer )/* override*/ {
+	/// @note Consumer's head is re-read only if cached value is not enough.
+	if ( buffer.size() > capacity() - ( write_tail - cached_head ) )
+		cached_head = head.load( ::std::memory_order_acquire );
+	const auto count = ::std::min( buffer.size(), capacity() - ( write_tail - cached_head ) );
+	if ( count == 0 )
+		return count;
+	const auto first = write_tail & mask;
+	const auto chunk = ::std::min( count, capacity() - first );
+	::std::memcpy( &storage[first], buffer.data(), chunk );
+	::std::memcpy( &storage[0], buffer.data() + chunk, count - chunk );
+	write_tail += count;
+	tail.store( write_tail, ::std::memory_order_release );
+	return count;
+}
+
+data::result_t spsc::write_size()/* override*/ {
+	cached_head = head.load( ::std::memory_order_acquire );
+	return capacity() - ( write_tail - cached_head );
+}
+
+} // namespace lib::stream::impl
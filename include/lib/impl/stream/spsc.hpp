@@ -0,0 +1,96 @@
+/* File: /lib/impl/stream/spsc.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__impl__stream__spsc__hpp
+#define CPPLIB__lib__impl__stream__spsc__hpp
+
+#include <atomic>
+#include <vector>
+
+#include "../../../lib/types.hpp"
+#include "../../../lib/data/stream.hpp"
+
+// DECLARATION lib::stream::impl::spsc
+
+namespace lib::stream::impl {
+
+/**
+ * Wait-free single-producer/single-consumer byte ring with fixed capacity.
+ * Write side (producer thread) and read side (consumer thread) may be used concurrently.
+ *
+ *                      ,-- read_flush() --, ,--- read_size() ---,
+ * ring  . . .[ free ][ . . . . . . . . . . |. . . . . . . . . . .][ free ] . . .
+ *                    |                    read_pos()             |
+ *                  head                                        tail
+ *             (published by consumer)                 (published by producer)
+ *
+ * @note write() publishes data immediately, read_flush() releases consumed space.
+ * @note read_cbuffer() returns data up to the storage end only, so data wrapping it can't be
+ *       viewed in place (see data::ContiguousView, packets::Handler::listen_payload()).
+ * @note flush(), size() and error() touch both sides and are not thread-safe.
+ */
+
+class spsc final
+	: public lib::data::rwstream_t
+{
+public:
+	/// @brief Assumed cache line size, keeps producer and consumer data apart.
+	static constexpr usize CACHE_LINE_SIZE = 64;
+
+	/// @param capacity Rounded up to a power of two.
+	explicit spsc( usize capacity );
+	virtual ~spsc() = default;
+
+	usize capacity() const noexcept { return storage.size(); }
+
+	// IMPLEMENTATION lib::data::rstream_t (consumer thread)
+
+	lib::data::result_t read( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t peek( const lib::data::buffer_t & buffer ) override;
+	bool read_flush() override;
+	lib::data::result_t read_size() override;
+	lib::data::result_t read_pos( usize position ) override;
+	lib::data::result_t read_pos() override;
+	lib::data::cbuffer_t read_cbuffer( bool flush ) override;
+	::std::error_condition read_error() const override { return {}; }
+
+	// IMPLEMENTATION lib::data::wstream_t (producer thread)
+
+	lib::data::result_t write( const lib::data::cbuffer_t & buffer ) override;
+	bool write_flush() override { return true; }
+	lib::data::result_t write_size() override;
+	::std::error_condition write_error() const override { return {}; }
+
+	// IMPLEMENTATION lib::data::rwstream_t
+
+	bool flush() override { return read_flush() and write_flush(); }
+	lib::data::result_t size() override { return read_size(); }
+	::std::error_condition error() const override { return {}; }
+private:
+	::std::vector<u8> storage;
+	usize mask;
+
+	alignas(CACHE_LINE_SIZE) ::std::atomic<usize> head {0};
+	alignas(CACHE_LINE_SIZE) ::std::atomic<usize> tail {0};
+
+	/// @name Consumer side
+	/// @{
+	alignas(CACHE_LINE_SIZE) usize read_head = 0;
+	usize read_pos_ = 0;
+	usize cached_tail = 0;
+	/// @}
+
+	/// @name Producer side
+	/// @{
+	alignas(CACHE_LINE_SIZE) usize write_tail = 0;
+	usize cached_head = 0;
+	/// @}
+};
+
+} // namespace lib::stream::impl
+
+#endif // CPPLIB__lib__impl__stream__spsc__hpp
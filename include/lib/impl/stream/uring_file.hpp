@@ -0,0 +1,20 @@
+/* File: /lib/impl/stream/uring_file.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__impl__stream__uring_file__hpp
+#define CPPLIB__lib__impl__stream__uring_file__hpp
+
+#include "../../../lib/debug/os.hpp"
+#include "../../../lib/debug/platform.hpp"
+
+#if defined(CPPLIB_PLATFORM_POSIX)
+	#include "../../../lib/impl_posix/stream/uring_file.hpp"
+#else
+	#error "No lib.stream.impl.uring_file implementation found for current platform/OS."
+#endif // CPPLIB_PLATFORM_POSIX
+
+#endif // CPPLIB__lib__impl__stream__uring_file__hpp
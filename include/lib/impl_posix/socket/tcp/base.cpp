@@ -10,17 +10,21 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <linux/sockios.h>
 #include <unistd.h>
 
 #include <cerrno>
 
+#include <algorithm>
 #include <limits>
 #include <system_error>
 #include <utility>
 
 #include <cpp/lib_debug>
 
+#include "../../stream/transfer.hpp"
+
 #include "./base.hpp"
 
 namespace lib::socket::impl::tcp {
@@ -65,6 +69,12 @@ data::result_t base::read( const data::buffer_t & buffer )/* override*/ {
 	return check_error( ::read( sock, buffer.data(), buffer.size() ) );
 }
 
+data::result_t base::readv( ::std::span<const data::buffer_t> buffers )/* override*/ {
+	return transfer_iov( buffers, [this]( const ::iovec * iov, int count ) {
+		return ::readv( sock, iov, count );
+	});
+}
+
 data::result_t base::peek( const data::buffer_t & buffer )/* override*/ {
 	return check_error( ::recv( sock, buffer.data(), buffer.size(), MSG_PEEK ) );
 }
@@ -73,6 +83,12 @@ data::result_t base::write( const data::cbuffer_t & buffer )/* override*/ {
 	return check_error( ::write( sock, buffer.data(), buffer.size() ) );
 }
 
+data::result_t base::writev( ::std::span<const data::cbuffer_t> buffers )/* override*/ {
+	return transfer_iov( buffers, [this]( const ::iovec * iov, int count ) {
+		return ::writev( sock, iov, count );
+	});
+}
+
 data::result_t base::read_size()/* override*/ {
 	int value = 0;
 	auto result = check_error( ::ioctl( sock, SIOCINQ/*FIONREAD*/, &value ) );
@@ -86,6 +102,13 @@ data::result_t base::write_size()/* override*/ {
 	return ::std::numeric_limits<data::result_t::value_type>::max();
 }
 
+data::result_t base::transfer_from( data::rstream_t & source, usize count/* = TRANSFER_ALL*/ )/* override*/ {
+	const auto result = stream::impl::transfer_fd( sock, source, count );
+	if ( result < 0 and errno == EOPNOTSUPP )
+		return data::wstream_t::transfer_from( source, count );
+	return check_error( result );
+}
+
 ::std::error_condition base::error() const/* override*/
 { return error_; }
 
@@ -94,6 +117,43 @@ bool base::set_blocking( bool blocking ) {
 	return check_error( ::ioctl( sock, FIONBIO, &nonblocking ) ).success();
 }
 
+bool base::set_nodelay( bool nodelay ) {
+	int value = nodelay ? 1 : 0;
+	return check_error( ::setsockopt( sock, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value) ) ).success();
+}
+
+bool base::set_cork( bool cork ) {
+#if defined(TCP_CORK)
+	int value = cork ? 1 : 0;
+	return check_error( ::setsockopt( sock, IPPROTO_TCP, TCP_CORK, &value, sizeof(value) ) ).success();
+#else
+	CPP_UNUSED( cork );
+	return false;
+#endif // TCP_CORK
+}
+
+template< class Buffer, class Syscall >
+data::result_t base::transfer_iov( ::std::span<const Buffer> buffers, Syscall && syscall ) {
+	usize total = 0;
+	while ( not buffers.empty() ) {
+		::iovec iov[IOV_BATCH];
+		const auto count = ::std::min( buffers.size(), IOV_BATCH );
+		usize size = 0;
+		for ( usize i = 0; i < count; ++i ) {
+			iov[i] = { (void*) buffers[i].data(), buffers[i].size() };
+			size += buffers[i].size();
+		}
+		const auto & result = check_error( syscall( iov, (int) count ) );
+		if ( result.failed() )
+			return total == 0 ? result : data::result_t {total};
+		total += result.value();
+		if ( result.value() < size )
+			break;
+		buffers = buffers.subspan( count );
+	}
+	return total;
+}
+
 /*virtual */data::result_t base::check_error( isize result ) {
 	if ( result >= 0 )
 		return (usize) result;
@@ -9,17 +9,21 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <linux/sockios.h>
 #include <unistd.h>
 
 #include <cerrno>
 
+#include <algorithm>
 #include <limits>
 #include <system_error>
 #include <utility>
 
 #include <cpp/lib_debug>
 
+#include "../../stream/transfer.hpp"
+
 #include "./base.hpp"
 
 namespace lib::socket::impl::unix {
@@ -64,6 +68,12 @@ data::result_t base::read( const data::buffer_t & buffer )/* override*/ {
 	return check_error( ::read( sock, buffer.data(), buffer.size() ) );
 }
 
+data::result_t base::readv( ::std::span<const data::buffer_t> buffers )/* override*/ {
+	return transfer_iov( buffers, [this]( const ::iovec * iov, int count ) {
+		return ::readv( sock, iov, count );
+	});
+}
+
 data::result_t base::peek( const data::buffer_t & buffer )/* override*/ {
 	return check_error( ::recv( sock, buffer.data(), buffer.size(), MSG_PEEK ) );
 }
@@ -72,6 +82,12 @@ data::result_t base::write( const data::cbuffer_t & buffer )/* override*/ {
 	return check_error( ::write( sock, buffer.data(), buffer.size() ) );
 }
 
+data::result_t base::writev( ::std::span<const data::cbuffer_t> buffers )/* override*/ {
+	return transfer_iov( buffers, [this]( const ::iovec * iov, int count ) {
+		return ::writev( sock, iov, count );
+	});
+}
+
 data::result_t base::read_size()/* override*/ {
 	int value = 0;
 	auto result = check_error( ::ioctl( sock, SIOCINQ/*FIONREAD*/, &value ) );
@@ -85,6 +101,13 @@ data::result_t base::write_size()/* override*/ {
 	return ::std::numeric_limits<data::result_t::value_type>::max();
 }
 
+data::result_t base::transfer_from( data::rstream_t & source, usize count/* = TRANSFER_ALL*/ )/* override*/ {
+	const auto result = stream::impl::transfer_fd( sock, source, count );
+	if ( result < 0 and errno == EOPNOTSUPP )
+		return data::wstream_t::transfer_from( source, count );
+	return check_error( result );
+}
+
 ::std::error_condition base::error() const/* override*/
 { return error_; }
 
@@ -93,6 +116,28 @@ bool base::set_blocking( bool blocking ) {
 	return check_error( ::ioctl( sock, FIONBIO, &nonblocking ) ).success();
 }
 
+template< class Buffer, class Syscall >
+data::result_t base::transfer_iov( ::std::span<const Buffer> buffers, Syscall && syscall ) {
+	usize total = 0;
+	while ( not buffers.empty() ) {
+		::iovec iov[IOV_BATCH];
+		const auto count = ::std::min( buffers.size(), IOV_BATCH );
+		usize size = 0;
+		for ( usize i = 0; i < count; ++i ) {
+			iov[i] = { (void*) buffers[i].data(), buffers[i].size() };
+			size += buffers[i].size();
+		}
+		const auto & result = check_error( syscall( iov, (int) count ) );
+		if ( result.failed() )
+			return total == 0 ? result : data::result_t {total};
+		total += result.value();
+		if ( result.value() < size )
+			break;
+		buffers = buffers.subspan( count );
+	}
+	return total;
+}
+
 /*virtual */data::result_t base::check_error( isize result ) {
 	if ( result >= 0 )
 		return (usize) result;
@@ -10,6 +10,8 @@
 
 /// @todo Unify with "tcp"?
 
+#include <span>
+
 #include "../../../../lib/types.hpp"
 #include "../../../../lib/socket/socket.hpp"
 
@@ -38,10 +40,16 @@ public:
 	// IMPLEMENTATION lib::data::rstream_t, lib::data::wstream_t
 
 	data::result_t read( const data::buffer_t & buffer ) override;
+	data::result_t readv( ::std::span<const data::buffer_t> buffers ) override;
 	data::result_t peek( const data::buffer_t & buffer ) override;
 	data::result_t write( const data::cbuffer_t & buffer ) override;
+	data::result_t writev( ::std::span<const data::cbuffer_t> buffers ) override;
 	data::result_t read_size() override;
 	data::result_t write_size() override;
+	int read_fd() override { return sock; }
+	int write_fd() override { return sock; }
+	/// @brief Kernel side copy from descriptor based sources, see lib::stream::impl::transfer_fd().
+	data::result_t transfer_from( data::rstream_t & source, usize count = TRANSFER_ALL ) override;
 	::std::error_condition read_error() const override { return error(); }
 	::std::error_condition write_error() const override { return error(); }
 
@@ -52,6 +60,12 @@ public:
 	bool set_blocking( bool blocking );
 
 protected:
+	/// @brief Max buffers passed to a single ::readv()/::writev() call.
+	static constexpr usize IOV_BATCH = 64;
+
+	template< class Buffer, class Syscall >
+	data::result_t transfer_iov( ::std::span<const Buffer> buffers, Syscall && syscall );
+
 	virtual data::result_t check_error( isize result );
 
 	bool is_inprogress( isize result, bool check_error_ = true );
@@ -0,0 +1,167 @@
+/* File: /lib/impl_posix/stream/mapped_file.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <utility>
+
+#include <cpp/lib_debug>
+
+#include "./mapped_file.hpp"
+
+namespace lib::stream::impl {
+
+namespace {
+
+constexpr int to_madvise( mapped_file::Advice advice ) {
+	switch ( advice ) {
+	case mapped_file::Advice::NORMAL:		return MADV_NORMAL;
+	case mapped_file::Advice::SEQUENTIAL:	return MADV_SEQUENTIAL;
+	case mapped_file::Advice::RANDOM:		return MADV_RANDOM;
+	case mapped_file::Advice::WILL_NEED:	return MADV_WILLNEED;
+	case mapped_file::Advice::DONT_NEED:	return MADV_DONTNEED;
+	}
+	return MADV_NORMAL;
+}
+
+} // namespace
+
+// IMPLEMENTATION lib::stream::impl::mapped_file
+
+mapped_file::mapped_file( const char * name, Advice advice/* = Advice::NORMAL*/ ) {
+	CPP_UNUSED( open( name, advice ) );
+}
+
+mapped_file::~mapped_file() {
+	CPP_UNUSED( close() );
+}
+
+bool mapped_file::open( const char * name, Advice advice/* = Advice::NORMAL*/ ) {
+	CPP_ASSERT( not is_open() );
+	CPP_ASSERT( not error_ );
+	fd = ::open( name, O_RDONLY | O_CLOEXEC );
+	if ( fd < 0 ) {
+		set_error_from_errno();
+		return false;
+	}
+	struct ::stat info;
+	if ( ::fstat( fd, &info ) != 0 ) {
+		set_error_from_errno();
+		CPP_UNUSED( close() );
+		return false;
+	}
+	size_ = (usize) info.st_size;
+	pos_ = 0;
+	/// @note Empty files can not be mapped, they are represented by an empty mapping.
+	if ( size_ == 0 )
+		return true;
+	void * address = ::mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0 );
+	if ( address == MAP_FAILED ) {
+		set_error_from_errno();
+		size_ = 0;
+		CPP_UNUSED( close() );
+		return false;
+	}
+	data_ = (const u8*) address;
+	return advice == Advice::NORMAL or advise( advice );
+}
+
+bool mapped_file::close() {
+	if ( not is_open() )
+		return true;
+	bool result = true;
+	if ( data_ != nullptr and ::munmap( (void*) data_, size_ ) != 0 ) {
+		set_error_from_errno();
+		result = false;
+	}
+	data_ = nullptr;
+	size_ = pos_ = 0;
+	if ( ::close( ::std::exchange( fd, -1 ) ) != 0 ) {
+		set_error_from_errno();
+		result = false;
+	}
+	return result;
+}
+
+void mapped_file::reset() {
+	CPP_UNUSED( close() );
+	CPP_ASSERT( not is_open() );
+	error_.clear();
+}
+
+bool mapped_file::advise( Advice advice, usize offset/* = 0*/, usize size/* = WHOLE*/ ) {
+	if ( data_ == nullptr or offset >= size_ )
+		return is_open();
+	/// @note madvise() requires page aligned address.
+	const auto page_size = (usize) ::sysconf( _SC_PAGESIZE );
+	const auto first = offset - offset % page_size;
+	const auto last = size_ - offset < size ? size_ : offset + size;
+	if ( ::madvise( (void*)( data_ + first ), last - first, to_madvise( advice ) ) == 0 )
+		return true;
+	set_error_from_errno();
+	return false;
+}
+
+const ::std::error_condition & mapped_file::set_error_from_errno() {
+	return error_ = ::std::make_error_condition( (::std::errc) errno );
+}
+
+// IMPLEMENTATION lib::stream::impl::mapped_file: lib::data::rstream_t, lib::data::wstream_t
+
+data::result_t mapped_file::read( const data::buffer_t & buffer )/* override*/ {
+	const auto & count = peek( buffer );
+	if ( count.success() )
+		pos_ += count.value();
+	return count;
+}
+
+data::result_t mapped_file::peek( const data::buffer_t & buffer )/* override*/ {
+	if ( not is_open() )
+		return make_error_not_configured();
+	const auto count = ::std::min( buffer.size(), size_ - pos_ );
+	if ( count > 0 )
+		::std::memcpy( buffer.data(), data_ + pos_, count );
+	return count;
+}
+
+data::cbuffer_t mapped_file::read_cbuffer( bool/* flush*/ )/* override*/ {
+	return mapping().subspan( pos_ );
+}
+
+data::result_t mapped_file::write( const data::cbuffer_t &/* buffer*/ )/* override*/ {
+	return make_error_not_implemented();
+}
+
+// IMPLEMENTATION lib::stream::impl::mapped_file: lib::data::unistream_t
+
+data::result_t mapped_file::size()/* override*/ {
+	if ( not is_open() )
+		return make_error_not_configured();
+	return size_ - pos_;
+}
+
+// IMPLEMENTATION lib::stream::impl::mapped_file: lib::data::rwstream_t
+
+data::result_t mapped_file::pos( usize position )/* override*/ {
+	if ( not is_open() )
+		return make_error_not_configured();
+	return pos_ = ::std::min( position, size_ );
+}
+
+data::result_t mapped_file::pos()/* override*/ {
+	return pos_;
+}
+
+} // namespace lib::stream::impl
@@ -0,0 +1,94 @@
+/* File: /lib/impl_posix/stream/mapped_file.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__impl_posix__stream__mapped_file__hpp
+#define CPPLIB__lib__impl_posix__stream__mapped_file__hpp
+
+#include <limits>
+#include <system_error>
+
+#include "../../../lib/types.hpp"
+#include "../../../lib/data/stream.hpp"
+
+// DECLARATION lib::stream::impl::mapped_file
+
+namespace lib::stream::impl {
+
+/**
+ * Read-only file stream backed by mmap(): read_cbuffer() returns the mapping itself,
+ * so whole file can be parsed without copying it into user space buffers.
+ *
+ *                  ,----- read_cbuffer() ------,
+ * mapping  [. . . . |. . . . . . . . . . . . . . .]
+ *                    \                             \
+ *                   pos()                       mapping().size()
+ *          `------------- size() + pos() ---------'
+ */
+
+class mapped_file final
+	: public lib::data::unistream_t
+{
+public:
+	/// @brief Kernel paging hints, see `$ man madvise`.
+	enum class Advice {
+		NORMAL,
+		SEQUENTIAL,
+		RANDOM,
+		WILL_NEED,
+		DONT_NEED,
+	};
+	static constexpr usize WHOLE = ::std::numeric_limits<usize>::max();
+
+	mapped_file() = default;
+	mapped_file( const char * name, Advice advice = Advice::NORMAL );
+	mapped_file( const mapped_file & ) = delete;
+	virtual ~mapped_file();
+
+	mapped_file & operator = ( const mapped_file & ) = delete;
+
+	bool open( const char * name, Advice advice = Advice::NORMAL );
+	bool close();
+	bool is_open() const { return fd >= 0; }
+	void reset();
+
+	/// @brief Applies `advice` to [offset, offset + size) range of the mapping.
+	bool advise( Advice advice, usize offset = 0, usize size = WHOLE );
+	lib::data::cbuffer_t mapping() const { return {data_, size_}; }
+
+	// IMPLEMENTATION lib::data::rstream_t, lib::data::wstream_t
+
+	lib::data::result_t read( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t peek( const lib::data::buffer_t & buffer ) override;
+	lib::data::cbuffer_t read_cbuffer( bool flush ) override;
+	using unistream_t::read_cbuffer;
+	int read_fd() override { return fd; }
+	lib::data::result_t write( const lib::data::cbuffer_t & buffer ) override;
+	lib::data::result_t write_size() override { return (usize) 0; }
+
+	// IMPLEMENTATION lib::data::unistream_t
+
+	bool flush() override { return is_open(); }
+	lib::data::result_t size() override;
+
+	// IMPLEMENTATION lib::data::rwstream_t
+
+	lib::data::result_t pos( usize position ) override;
+	lib::data::result_t pos() override;
+	::std::error_condition error() const override { return error_; }
+private:
+	const ::std::error_condition & set_error_from_errno();
+
+	int fd = -1;
+	const u8 * data_ = nullptr;
+	usize size_ = 0;
+	usize pos_ = 0;
+	::std::error_condition error_;
+};
+
+} // namespace lib::stream::impl
+
+#endif // CPPLIB__lib__impl_posix__stream__mapped_file__hpp
@@ -0,0 +1,129 @@
+/* File: /lib/impl_posix/stream/transfer.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include <algorithm>
+
+#include <cpp/lib_debug>
+
+#include "./transfer.hpp"
+
+namespace lib::stream::impl {
+
+namespace {
+
+/// @brief Max bytes moved by a single sendfile()/splice() call (Linux limit for sendfile()).
+constexpr usize SYSCALL_CHUNK = 0x7FFFF000;
+/// @brief Default pipe capacity, splice() never moves more into it at once.
+constexpr usize PIPE_CHUNK = 64 * 1024;
+
+isize send_file( int fd, int in_fd, usize position, usize count ) {
+	::off_t offset = (::off_t) position;
+	usize total = 0;
+	while ( total < count ) {
+		const auto result = ::sendfile( fd, in_fd, &offset, ::std::min( count - total, SYSCALL_CHUNK ) );
+		if ( result < 0 and errno == EINTR )
+			continue;
+		if ( result < 0 )
+			return total == 0 ? -1 : (isize) total;
+		if ( result == 0 )
+			break;
+		total += (usize) result;
+	}
+	return (isize) total;
+}
+
+/** @brief Moves everything from the pipe to `fd`: these bytes are already consumed from the source.
+ *  @return Bytes moved, less than `count` on error (see errno).
+ */
+usize drain_pipe( int pipe_fd, int fd, usize count ) {
+	usize drained = 0;
+	while ( drained < count ) {
+		const auto result = ::splice( pipe_fd, nullptr, fd, nullptr, count - drained, SPLICE_F_MOVE | SPLICE_F_NONBLOCK );
+		if ( result > 0 ) {
+			drained += (usize) result;
+			continue;
+		}
+		if ( result < 0 and errno == EINTR )
+			continue;
+		if ( result < 0 and errno == EAGAIN ) {
+			::pollfd poll_fd { .fd = fd, .events = POLLOUT, .revents = 0 };
+			if ( ::poll( &poll_fd, 1, -1 ) >= 0 or errno == EINTR )
+				continue;
+		}
+		break;
+	}
+	return drained;
+}
+
+isize splice_through_pipe( int fd, int in_fd, usize count ) {
+	int pipe_fds[2];
+	if ( ::pipe2( pipe_fds, O_CLOEXEC | O_NONBLOCK ) != 0 )
+		return -1;
+
+	usize total = 0;
+	isize result = 0;
+	while ( total < count ) {
+		const auto chunk = ::std::min( count - total, PIPE_CHUNK );
+		const auto moved = ::splice( in_fd, nullptr, pipe_fds[1], nullptr, chunk, SPLICE_F_MOVE | SPLICE_F_NONBLOCK );
+		if ( moved < 0 and errno == EINTR )
+			continue;
+		if ( moved < 0 and errno == EINVAL and total == 0 )
+			errno = EOPNOTSUPP;
+		if ( moved < 0 and total == 0 )
+			result = -1;
+		if ( moved <= 0 )
+			break;
+		const auto drained = drain_pipe( pipe_fds[0], fd, (usize) moved );
+		total += drained;
+		// Delivered bytes are reported like send_file() does, the error is left in errno.
+		if ( drained < (usize) moved ) {
+			result = total == 0 ? -1 : (isize) total;
+			break;
+		}
+		result = (isize) total;
+		if ( (usize) moved < chunk )
+			break;
+	}
+
+	const auto error = errno;
+	CPP_UNUSED( ::close( pipe_fds[0] ) );
+	CPP_UNUSED( ::close( pipe_fds[1] ) );
+	errno = error;
+	return result;
+}
+
+} // namespace
+
+// IMPLEMENTATION lib::stream::impl::transfer_fd()
+
+isize transfer_fd( int fd, data::rstream_t & source, usize count ) {
+	const auto in_fd = source.read_fd();
+	if ( fd < 0 or in_fd < 0 ) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	const auto & position = source.read_pos();
+	if ( position.success() ) {
+		const auto result = send_file( fd, in_fd, position.value(), count );
+		if ( result > 0 )
+			CPP_UNUSED( source.read_pos( position.value() + (usize) result ) );
+		if ( result >= 0 or ( errno != EINVAL and errno != ENOSYS ) )
+			return result;
+	}
+	return splice_through_pipe( fd, in_fd, count );
+}
+
+} // namespace lib::stream::impl
@@ -0,0 +1,33 @@
+/* File: /lib/impl_posix/stream/transfer.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__impl_posix__stream__transfer__hpp
+#define CPPLIB__lib__impl_posix__stream__transfer__hpp
+
+#include "../../../lib/types.hpp"
+#include "../../../lib/data/stream.hpp"
+
+// DECLARATION lib::stream::impl::transfer_fd()
+
+namespace lib::stream::impl {
+
+/**
+ * Moves up to `count` bytes from `source` to descriptor `fd` without copying them to user space:
+ *   - sendfile() if `source` is seekable, file offset is taken from and stored back to source.read_pos();
+ *   - splice() through an intermediate pipe otherwise (sockets, pipes).
+ *
+ * @return Number of bytes moved, or -1 with errno set (like a syscall would do).
+ *         EOPNOTSUPP means `source` has no descriptor (see read_fd()) or kernel can't move data
+ *         between these descriptors, caller should fall back to user space copy.
+ * @note Stops at the first short transfer, so non-blocking `fd` is not waited for
+ *       unless bytes are already taken out of non-seekable `source`.
+ */
+isize transfer_fd( int fd, lib::data::rstream_t & source, usize count );
+
+} // namespace lib::stream::impl
+
+#endif // CPPLIB__lib__impl_posix__stream__transfer__hpp
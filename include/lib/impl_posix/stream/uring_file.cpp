@@ -0,0 +1,693 @@
+/* File: /lib/impl_posix/stream/uring_file.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+	#include <linux/io_uring.h>
+	#define CPPLIB__lib__impl_posix__stream__uring_file__URING
+#endif
+
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+
+#include <cpp/lib_debug>
+
+#include "./uring_file.hpp"
+
+namespace lib::stream::impl {
+
+// DECLARATION lib::stream::impl::uring_file::engine
+
+/// @brief Backend which moves requests to the kernel and completions back.
+class uring_file::engine {
+public:
+	struct request {
+		bool write;
+		int fd;
+		usize offset;
+		u8 * data;
+		usize size;
+		isize fixed_index;
+		u32 slot;
+	};
+	struct completion {
+		u32 slot;
+		/// @brief Transferred bytes count or negative errno.
+		isize result;
+	};
+
+	virtual ~engine() = default;
+
+	virtual Backend backend() const = 0;
+	virtual bool register_buffers( u8 * data, usize count, usize size ) = 0;
+	virtual bool prepare( const request & request ) = 0;
+	virtual bool submit() = 0;
+	/// @brief Fills `out` with completed requests, blocks until at least one completes if `block`.
+	/// @return Number of completions or -1 on error (errno is set).
+	virtual isize reap( ::std::span<completion> out, bool block ) = 0;
+};
+
+namespace {
+
+#if defined(CPPLIB__lib__impl_posix__stream__uring_file__URING)
+
+// DECLARATION uring_engine
+
+/// @brief io_uring driven by raw system calls (no liburing dependency).
+class uring_engine final
+	: public uring_file::engine
+{
+public:
+	uring_engine() = default;
+	~uring_engine();
+
+	bool setup( u32 entries );
+
+	uring_file::Backend backend() const override { return uring_file::Backend::URING; }
+	bool register_buffers( u8 * data, usize count, usize size ) override;
+	bool prepare( const request & request ) override;
+	bool submit() override;
+	isize reap( ::std::span<completion> out, bool block ) override;
+private:
+	static u32 load_acquire( const u32 * value )
+		{ return ::std::atomic_ref<const u32> {*value}.load( ::std::memory_order_acquire ); }
+	static void store_release( u32 * value, u32 new_value )
+		{ ::std::atomic_ref<u32> {*value}.store( new_value, ::std::memory_order_release ); }
+
+	int enter( u32 to_submit_, u32 min_complete, u32 flags );
+
+	int ring = -1;
+	bool registered = false;
+
+	void * sq_ring = MAP_FAILED;
+	usize sq_ring_size = 0;
+	void * cq_ring = MAP_FAILED;
+	usize cq_ring_size = 0;
+	::io_uring_sqe * sqes = (::io_uring_sqe*) MAP_FAILED;
+	usize sqes_size = 0;
+
+	u32 * sq_head = nullptr;
+	u32 * sq_tail = nullptr;
+	u32 sq_mask = 0;
+	u32 sq_entries = 0;
+	u32 * sq_array = nullptr;
+	u32 * cq_head = nullptr;
+	u32 * cq_tail = nullptr;
+	u32 cq_mask = 0;
+	::io_uring_cqe * cqes = nullptr;
+
+	u32 to_submit = 0;
+};
+
+// IMPLEMENTATION uring_engine
+
+uring_engine::~uring_engine() {
+	if ( sqes != MAP_FAILED )
+		CPP_UNUSED( ::munmap( sqes, sqes_size ) );
+	if ( cq_ring != MAP_FAILED and cq_ring != sq_ring )
+		CPP_UNUSED( ::munmap( cq_ring, cq_ring_size ) );
+	if ( sq_ring != MAP_FAILED )
+		CPP_UNUSED( ::munmap( sq_ring, sq_ring_size ) );
+	if ( ring >= 0 )
+		CPP_UNUSED( ::close( ring ) );
+}
+
+bool uring_engine::setup( u32 entries ) {
+	::io_uring_params params;
+	::std::memset( &params, 0, sizeof( params ) );
+	ring = (int) ::syscall( __NR_io_uring_setup, entries, &params );
+	if ( ring < 0 )
+		return false;
+	/// @note IORING_OP_READ/IORING_OP_WRITE appeared along with IORING_FEAT_RW_CUR_POS (Linux 5.6).
+	if ( ( params.features & IORING_FEAT_RW_CUR_POS ) == 0 )
+		return false;
+
+	sq_ring_size = params.sq_off.array + params.sq_entries * sizeof( u32 );
+	cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof( ::io_uring_cqe );
+	const bool single_mmap = ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0;
+	if ( single_mmap )
+		sq_ring_size = cq_ring_size = ::std::max( sq_ring_size, cq_ring_size );
+	sq_ring = ::mmap( nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING );
+	if ( sq_ring == MAP_FAILED )
+		return false;
+	cq_ring = single_mmap ? sq_ring
+		: ::mmap( nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING );
+	if ( cq_ring == MAP_FAILED )
+		return false;
+	sqes_size = params.sq_entries * sizeof( ::io_uring_sqe );
+	sqes = (::io_uring_sqe*) ::mmap( nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES );
+	if ( sqes == MAP_FAILED )
+		return false;
+
+	const auto sq = (u8*) sq_ring;
+	sq_head = (u32*)( sq + params.sq_off.head );
+	sq_tail = (u32*)( sq + params.sq_off.tail );
+	sq_mask = *(u32*)( sq + params.sq_off.ring_mask );
+	sq_entries = params.sq_entries;
+	sq_array = (u32*)( sq + params.sq_off.array );
+	const auto cq = (u8*) cq_ring;
+	cq_head = (u32*)( cq + params.cq_off.head );
+	cq_tail = (u32*)( cq + params.cq_off.tail );
+	cq_mask = *(u32*)( cq + params.cq_off.ring_mask );
+	cqes = (::io_uring_cqe*)( cq + params.cq_off.cqes );
+	return true;
+}
+
+int uring_engine::enter( u32 to_submit_, u32 min_complete, u32 flags ) {
+	return (int) ::syscall( __NR_io_uring_enter, ring, to_submit_, min_complete, flags, nullptr, 0 );
+}
+
+bool uring_engine::register_buffers( u8 * data, usize count, usize size ) {
+	if ( registered ) {
+		CPP_UNUSED( ::syscall( __NR_io_uring_register, ring, IORING_UNREGISTER_BUFFERS, nullptr, 0 ) );
+		registered = false;
+	}
+	::std::vector<::iovec> iovecs( count );
+	for ( usize i = 0; i < count; ++i )
+		iovecs[i] = { data + i * size, size };
+	/// @note Pinning may fail due to RLIMIT_MEMLOCK, requests fall back to regular buffers then.
+	registered = ::syscall( __NR_io_uring_register, ring, IORING_REGISTER_BUFFERS, iovecs.data(), (unsigned) count ) == 0;
+	return registered;
+}
+
+bool uring_engine::prepare( const request & request ) {
+	const auto tail = *sq_tail;
+	if ( tail - load_acquire( sq_head ) >= sq_entries ) {
+		errno = EBUSY;
+		return false;
+	}
+	const auto index = tail & sq_mask;
+	auto & sqe = sqes[index];
+	::std::memset( &sqe, 0, sizeof( sqe ) );
+	const bool fixed = request.fixed_index >= 0 and registered;
+	sqe.opcode = request.write
+		? (u8)( fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE )
+		: (u8)( fixed ? IORING_OP_READ_FIXED : IORING_OP_READ );
+	sqe.fd = request.fd;
+	sqe.off = request.offset;
+	sqe.addr = (u64) request.data;
+	sqe.len = (u32) ::std::min<usize>( request.size, ::std::numeric_limits<u32>::max() );
+	if ( fixed )
+		sqe.buf_index = (u16) request.fixed_index;
+	sqe.user_data = request.slot;
+	sq_array[index] = index;
+	store_release( sq_tail, tail + 1 );
+	++to_submit;
+	return true;
+}
+
+bool uring_engine::submit() {
+	while ( to_submit > 0 ) {
+		const auto submitted = enter( to_submit, 0, 0 );
+		if ( submitted < 0 ) {
+			if ( errno == EINTR or errno == EAGAIN )
+				continue;
+			return false;
+		}
+		to_submit -= (u32) submitted;
+	}
+	return true;
+}
+
+isize uring_engine::reap( ::std::span<completion> out, bool block ) {
+	usize count = 0;
+	while ( true ) {
+		auto head = *cq_head;
+		const auto tail = load_acquire( cq_tail );
+		for ( ; head != tail and count < out.size(); ++head, ++count ) {
+			const auto & cqe = cqes[head & cq_mask];
+			out[count] = { (u32) cqe.user_data, (isize) cqe.res };
+		}
+		store_release( cq_head, head );
+		if ( count > 0 or not block )
+			return (isize) count;
+		if ( enter( 0, 1, IORING_ENTER_GETEVENTS ) < 0 and errno != EINTR and errno != EAGAIN )
+			return -1;
+	}
+}
+
+#endif // CPPLIB__lib__impl_posix__stream__uring_file__URING
+
+// DECLARATION thread_engine
+
+/// @brief Fallback: blocking pread()/pwrite() on a pool of worker threads.
+class thread_engine final
+	: public uring_file::engine
+{
+public:
+	explicit thread_engine( usize threads_count );
+	~thread_engine();
+
+	uring_file::Backend backend() const override { return uring_file::Backend::THREADS; }
+	bool register_buffers( u8 *, usize, usize ) override { return true; }
+	bool prepare( const request & request ) override;
+	bool submit() override;
+	isize reap( ::std::span<completion> out, bool block ) override;
+private:
+	void work();
+
+	::std::vector<request> pending;
+	::std::vector<::std::thread> threads;
+
+	::std::mutex mutex;
+	::std::condition_variable jobs_changed;
+	::std::condition_variable done_changed;
+	::std::deque<request> jobs;
+	::std::deque<completion> done;
+	bool stop = false;
+};
+
+// IMPLEMENTATION thread_engine
+
+thread_engine::thread_engine( usize threads_count ) {
+	threads.reserve( threads_count );
+	for ( usize i = 0; i < threads_count; ++i )
+		threads.emplace_back( [this]() { work(); } );
+}
+
+thread_engine::~thread_engine() {
+	{
+		const ::std::lock_guard lock {mutex};
+		stop = true;
+	}
+	jobs_changed.notify_all();
+	for ( auto & thread : threads )
+		thread.join();
+}
+
+bool thread_engine::prepare( const request & request ) {
+	pending.push_back( request );
+	return true;
+}
+
+bool thread_engine::submit() {
+	if ( pending.empty() )
+		return true;
+	{
+		const ::std::lock_guard lock {mutex};
+		jobs.insert( jobs.end(), pending.begin(), pending.end() );
+	}
+	if ( pending.size() == 1 )
+		jobs_changed.notify_one();
+	else
+		jobs_changed.notify_all();
+	pending.clear();
+	return true;
+}
+
+isize thread_engine::reap( ::std::span<completion> out, bool block ) {
+	::std::unique_lock lock {mutex};
+	if ( block )
+		done_changed.wait( lock, [this]() { return not done.empty(); } );
+	const auto count = ::std::min( out.size(), done.size() );
+	::std::copy_n( done.begin(), count, out.begin() );
+	done.erase( done.begin(), done.begin() + (isize) count );
+	return (isize) count;
+}
+
+void thread_engine::work() {
+	::std::unique_lock lock {mutex};
+	while ( true ) {
+		jobs_changed.wait( lock, [this]() { return stop or not jobs.empty(); } );
+		if ( stop )
+			return;
+		const auto job = jobs.front();
+		jobs.pop_front();
+		lock.unlock();
+		const auto result = job.write
+			? ::pwrite( job.fd, job.data, job.size, (off_t) job.offset )
+			: ::pread( job.fd, job.data, job.size, (off_t) job.offset );
+		const completion completed { job.slot, result < 0 ? (isize) -errno : (isize) result };
+		lock.lock();
+		done.push_back( completed );
+		done_changed.notify_one();
+	}
+}
+
+constexpr int to_open_flags( uring_file::Mode mode ) {
+	switch ( mode ) {
+	case uring_file::Mode::READ:		return O_RDONLY;
+	case uring_file::Mode::WRITE:		return O_WRONLY | O_CREAT | O_TRUNC;
+	case uring_file::Mode::READ_WRITE:	return O_RDWR | O_CREAT;
+	}
+	return O_RDONLY;
+}
+
+} // namespace
+
+// IMPLEMENTATION lib::stream::impl::uring_file
+
+uring_file::uring_file() = default;
+
+uring_file::uring_file( const char * name, Mode mode/* = Mode::READ*/, Backend backend/* = Backend::URING*/ ) {
+	CPP_UNUSED( open( name, mode, backend ) );
+}
+
+uring_file::~uring_file() {
+	CPP_UNUSED( close() );
+}
+
+bool uring_file::open( const char * name, Mode mode/* = Mode::READ*/, Backend backend/* = Backend::URING*/ ) {
+	CPP_ASSERT( not is_open() );
+	CPP_ASSERT( not error_ );
+	fd = ::open( name, to_open_flags( mode ) | O_CLOEXEC, 0644 );
+	if ( fd < 0 ) {
+		set_error_from_errno();
+		return false;
+	}
+#if defined(CPPLIB__lib__impl_posix__stream__uring_file__URING)
+	if ( backend == Backend::URING ) {
+		auto uring = ::std::make_unique<uring_engine>();
+		if ( uring->setup( (u32) QUEUE_DEPTH ) )
+			engine_ = ::std::move( uring );
+	}
+#else
+	CPP_UNUSED( backend );
+#endif // CPPLIB__lib__impl_posix__stream__uring_file__URING
+	if ( not engine_ )
+		engine_ = ::std::make_unique<thread_engine>( THREADS_COUNT );
+
+	slots.assign( QUEUE_DEPTH, {} );
+	free_slots.resize( QUEUE_DEPTH );
+	for ( usize i = 0; i < QUEUE_DEPTH; ++i )
+		free_slots[i] = (u32)( QUEUE_DEPTH - 1 - i );
+	pos_ = 0;
+	return true;
+}
+
+bool uring_file::close() {
+	if ( not is_open() )
+		return true;
+	bool result = flush();
+	/// @note Engine goes first: requests still in flight may use registered buffers
+	///       until the ring (or the worker thread) is shut down.
+	engine_.reset();
+	slots.clear();
+	free_slots.clear();
+	chunks.clear();
+	fixed_storage = {};
+	fixed_size = 0;
+	pos_ = 0;
+	if ( ::close( ::std::exchange( fd, -1 ) ) != 0 ) {
+		set_error_from_errno();
+		result = false;
+	}
+	return result;
+}
+
+void uring_file::reset() {
+	CPP_UNUSED( close() );
+	CPP_ASSERT( not is_open() );
+	error_.clear();
+}
+
+uring_file::Backend uring_file::backend() const {
+	return engine_ ? engine_->backend() : Backend::NONE;
+}
+
+bool uring_file::register_buffers( usize count, usize size ) {
+	CPP_ASSERT( count > 0 and size > 0 );
+	if ( not is_open() )
+		return false;
+	/// @note Requests in flight may still reference old buffers.
+	if ( not flush() )
+		return false;
+	fixed_storage = ::std::vector<u8>( count * size );
+	fixed_size = size;
+	chunks.assign( count, {} );
+	ahead_first = 0;
+	ahead_offset = pos_;
+	CPP_UNUSED( engine_->register_buffers( fixed_storage.data(), count, size ) );
+	return true;
+}
+
+data::buffer_t uring_file::fixed_buffer( usize index ) {
+	CPP_ASSERT( index < chunks.size() );
+	return {fixed_storage.data() + index * fixed_size, fixed_size};
+}
+
+bool uring_file::read_async( usize offset, const data::buffer_t & buffer, completion_fn && fn ) {
+	return enqueue( false, offset, buffer.data(), buffer.size(), -1, ::std::move( fn ) );
+}
+
+bool uring_file::write_async( usize offset, const data::cbuffer_t & buffer, completion_fn && fn ) {
+	return enqueue( true, offset, (u8*) buffer.data(), buffer.size(), -1, ::std::move( fn ) );
+}
+
+bool uring_file::read_fixed_async( usize index, usize offset, usize size, completion_fn && fn ) {
+	CPP_ASSERT( size <= fixed_size );
+	return enqueue( false, offset, fixed_buffer( index ).data(), size, (isize) index, ::std::move( fn ) );
+}
+
+bool uring_file::write_fixed_async( usize index, usize offset, usize size, completion_fn && fn ) {
+	CPP_ASSERT( size <= fixed_size );
+	return enqueue( true, offset, fixed_buffer( index ).data(), size, (isize) index, ::std::move( fn ) );
+}
+
+bool uring_file::enqueue( bool write, usize offset, u8 * data, usize size, isize fixed_index, completion_fn && fn ) {
+	if ( not is_open() or free_slots.empty() )
+		return false;
+	const auto slot = free_slots.back();
+	if ( not engine_->prepare({ write, fd, offset, data, size, fixed_index, slot }) )
+		return false;
+	free_slots.pop_back();
+	slots[slot] = ::std::move( fn );
+	return true;
+}
+
+bool uring_file::submit() {
+	if ( not is_open() )
+		return false;
+	if ( engine_->submit() )
+		return true;
+	set_error_from_errno();
+	return false;
+}
+
+usize uring_file::poll() {
+	CPP_UNUSED( submit() );
+	if ( not is_open() or in_flight() == 0 )
+		return 0;
+	return dispatch( false );
+}
+
+usize uring_file::wait( usize count/* = 1*/ ) {
+	auto done = poll();
+	while ( done < count and in_flight() > 0 ) {
+		const auto dispatched = dispatch( true );
+		if ( dispatched == 0 )
+			break;
+		done += dispatched;
+	}
+	return done;
+}
+
+usize uring_file::dispatch( bool block ) {
+	engine::completion batch[QUEUE_DEPTH];
+	const auto count = engine_->reap( batch, block );
+	if ( count < 0 ) {
+		set_error_from_errno();
+		return 0;
+	}
+	for ( isize i = 0; i < count; ++i ) {
+		const auto & completed = batch[i];
+		/// @note Slot is released before the callback, so it may queue next request right away.
+		auto fn = ::std::move( slots[completed.slot] );
+		free_slots.push_back( completed.slot );
+		if ( not fn )
+			continue;
+		if ( completed.result < 0 )
+			fn( data::result_t {::std::make_error_condition( (::std::errc) -completed.result )} );
+		else
+			fn( (usize) completed.result );
+	}
+	return (usize) count;
+}
+
+data::result_t uring_file::transfer( bool write, usize offset, u8 * data, usize size ) {
+	usize done = 0;
+	while ( done < size ) {
+		data::result_t result = (usize) 0;
+		bool completed = false;
+		while ( free_slots.empty() and wait() > 0 ) {}
+		if ( not enqueue( write, offset + done, data + done, size - done, -1,
+				[&]( data::result_t result_ ) { result = result_; completed = true; } ) )
+			return error_ ? data::result_t {error_} : make_error_not_configured();
+		while ( not completed and wait() > 0 ) {}
+		// Callback references this frame and the kernel may still use `data`.
+		if ( not completed )
+			return abandon();
+		if ( result.failed() ) {
+			error_ = result.error();
+			return done > 0 ? data::result_t {done} : result;
+		}
+		if ( result.value() == 0 )
+			break;
+		done += result.value();
+	}
+	return done;
+}
+
+void uring_file::read_ahead() {
+	const auto count = chunks.size();
+	for ( usize i = 0; i < count; ++i ) {
+		const auto index = ( ahead_first + i ) % count;
+		auto & chunk_ = chunks[index];
+		if ( chunk_.state != chunk::State::IDLE )
+			continue;
+		const bool queued = read_fixed_async( index, ahead_offset, fixed_size, [this, index]( data::result_t result ) {
+			chunks[index].result = result;
+			chunks[index].state = chunk::State::READY;
+		});
+		if ( not queued )
+			break;
+		chunk_.offset = ahead_offset;
+		chunk_.state = chunk::State::PENDING;
+		ahead_offset += fixed_size;
+	}
+	CPP_UNUSED( submit() );
+}
+
+void uring_file::read_ahead_reset() {
+	const auto pending = [this]() {
+		return ::std::any_of( chunks.begin(), chunks.end(),
+			[]( const chunk & chunk_ ) { return chunk_.state == chunk::State::PENDING; } );
+	};
+	while ( pending() and wait() > 0 ) {}
+	for ( auto & chunk_ : chunks )
+		chunk_.state = chunk::State::IDLE;
+	ahead_first = 0;
+	ahead_offset = pos_;
+}
+
+data::result_t uring_file::abandon() {
+	if ( not error_ )
+		error_ = make_error_logic_broken();
+	const auto error = error_;
+	CPP_UNUSED( close() );
+	error_ = error;
+	return error;
+}
+
+const ::std::error_condition & uring_file::set_error_from_errno() {
+	return error_ = ::std::make_error_condition( (::std::errc) errno );
+}
+
+// IMPLEMENTATION lib::stream::impl::uring_file: lib::data::rstream_t, lib::data::wstream_t
+
+data::result_t uring_file::read( const data::buffer_t & buffer )/* override*/ {
+	if ( not is_open() )
+		return make_error_not_configured();
+	if ( chunks.empty() ) {
+		const auto & result = transfer( false, pos_, buffer.data(), buffer.size() );
+		if ( result.success() )
+			pos_ += result.value();
+		return result;
+	}
+	usize done = 0;
+	while ( done < buffer.size() ) {
+		read_ahead();
+		auto & front = chunks[ahead_first];
+		while ( front.state == chunk::State::PENDING and wait() > 0 ) {}
+		if ( front.state == chunk::State::PENDING )
+			return abandon();
+		if ( front.state != chunk::State::READY ) {
+			/// @note Queue is occupied by user requests, wait for some of them and retry.
+			if ( front.state == chunk::State::IDLE and wait() > 0 )
+				continue;
+			return error_ ? data::result_t {error_} : make_error_not_configured();
+		}
+		if ( front.result.failed() ) {
+			error_ = front.result.error();
+			read_ahead_reset();
+			return done > 0 ? data::result_t {done} : data::result_t {error_};
+		}
+		const auto end = front.offset + front.result.value();
+		if ( pos_ >= end ) {
+			/// @note End of file, next read() requests it again (file may grow).
+			read_ahead_reset();
+			break;
+		}
+		const auto count = ::std::min( end - pos_, buffer.size() - done );
+		::std::memcpy( buffer.data() + done, fixed_buffer( ahead_first ).data() + ( pos_ - front.offset ), count );
+		pos_ += count;
+		done += count;
+		if ( pos_ == front.offset + fixed_size ) {
+			front.state = chunk::State::IDLE;
+			ahead_first = ( ahead_first + 1 ) % chunks.size();
+		}
+	}
+	return done;
+}
+
+data::result_t uring_file::peek( const data::buffer_t & buffer )/* override*/ {
+	if ( not is_open() )
+		return make_error_not_configured();
+	return transfer( false, pos_, buffer.data(), buffer.size() );
+}
+
+data::result_t uring_file::write( const data::cbuffer_t & buffer )/* override*/ {
+	if ( not is_open() )
+		return make_error_not_configured();
+	read_ahead_reset();
+	const auto & result = transfer( true, pos_, (u8*) buffer.data(), buffer.size() );
+	if ( result.success() ) {
+		pos_ += result.value();
+		ahead_offset = pos_;
+	}
+	return result;
+}
+
+// IMPLEMENTATION lib::stream::impl::uring_file: lib::data::unistream_t
+
+bool uring_file::flush()/* override*/ {
+	if ( not is_open() )
+		return false;
+	CPP_UNUSED( wait( in_flight() ) );
+	return in_flight() == 0 and not error_;
+}
+
+data::result_t uring_file::size()/* override*/ {
+	if ( not is_open() )
+		return make_error_not_configured();
+	struct ::stat info;
+	if ( ::fstat( fd, &info ) != 0 )
+		return set_error_from_errno();
+	const auto size_ = (usize) info.st_size;
+	return size_ > pos_ ? size_ - pos_ : 0;
+}
+
+// IMPLEMENTATION lib::stream::impl::uring_file: lib::data::rwstream_t
+
+data::result_t uring_file::pos( usize position )/* override*/ {
+	if ( not is_open() )
+		return make_error_not_configured();
+	if ( position == pos_ )
+		return pos_;
+	pos_ = position;
+	read_ahead_reset();
+	return pos_;
+}
+
+} // namespace lib::stream::impl
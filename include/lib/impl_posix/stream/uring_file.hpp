@@ -0,0 +1,161 @@
+/* File: /lib/impl_posix/stream/uring_file.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__impl_posix__stream__uring_file__hpp
+#define CPPLIB__lib__impl_posix__stream__uring_file__hpp
+
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#include "../../../lib/types.hpp"
+#include "../../../lib/data/stream.hpp"
+
+// DECLARATION lib::stream::impl::uring_file
+
+namespace lib::stream::impl {
+
+/**
+ * File stream with completion based asynchronous I/O.
+ * Requests are submitted through io_uring, or through a small worker thread pool
+ * when io_uring is not available (old kernel, seccomp, etc.).
+ *
+ * Asynchronous API:
+ *   read_async()/write_async() queue a request, submit() passes queued requests to the kernel,
+ *   poll()/wait() reap completions and invoke callbacks on the calling thread.
+ *
+ * Synchronous API (lib::data::unistream_t) is built on top of it: with fixed buffers registered
+ * sequential read() keeps all of them in flight as read-ahead window:
+ *
+ *              ,---- chunk 0 ----,---- chunk 1 ----,---- chunk 2 ----,
+ * file  . . . [ ready . . . . . . | pending . . . . | pending . . . . ] . . .
+ *                   |                                                 |
+ *                 pos()                                       next read-ahead offset
+ *
+ * @note While synchronous reads are used fixed buffers belong to the read-ahead window,
+ *       do not pass them to read_fixed_async()/write_fixed_async() at the same time.
+ * @note Object is not thread-safe, callbacks are invoked from poll()/wait() only.
+ */
+
+class uring_file final
+	: public lib::data::unistream_t
+{
+public:
+	enum class Mode {
+		READ,		///< O_RDONLY
+		WRITE,		///< O_WRONLY | O_CREAT | O_TRUNC
+		READ_WRITE,	///< O_RDWR | O_CREAT
+	};
+	enum class Backend {
+		NONE,
+		URING,
+		THREADS,
+	};
+	using completion_fn = ::std::function<void( lib::data::result_t )>;
+
+	/// @brief Maximum number of requests in flight.
+	static constexpr usize QUEUE_DEPTH = 64;
+	/// @brief Size of the worker thread pool used by Backend::THREADS.
+	static constexpr usize THREADS_COUNT = 4;
+
+	uring_file();
+	/// @param backend Preferred backend, Backend::URING falls back to Backend::THREADS.
+	uring_file( const char * name, Mode mode = Mode::READ, Backend backend = Backend::URING );
+	uring_file( const uring_file & ) = delete;
+	virtual ~uring_file();
+
+	uring_file & operator = ( const uring_file & ) = delete;
+
+	bool open( const char * name, Mode mode = Mode::READ, Backend backend = Backend::URING );
+	bool close();
+	bool is_open() const { return fd >= 0; }
+	void reset();
+	Backend backend() const;
+
+	/// @brief Allocates `count` buffers of `size` bytes and registers them with the kernel.
+	bool register_buffers( usize count, usize size );
+	lib::data::buffer_t fixed_buffer( usize index );
+	usize fixed_count() const { return chunks.size(); }
+
+	/** @brief Queue asynchronous request at absolute file `offset`.
+	 *  @return false if the queue is full (see in_flight()) or stream is not open.
+	 *  @note `buffer` must stay valid until `fn` is called.
+	 */
+	bool read_async( usize offset, const lib::data::buffer_t & buffer, completion_fn && fn );
+	bool write_async( usize offset, const lib::data::cbuffer_t & buffer, completion_fn && fn );
+	/// @brief Same as above, but transfer [0, size) range of the registered buffer `index`.
+	bool read_fixed_async( usize index, usize offset, usize size, completion_fn && fn );
+	bool write_fixed_async( usize index, usize offset, usize size, completion_fn && fn );
+
+	/// @brief Passes queued requests to the backend.
+	bool submit();
+	/// @brief Invokes callbacks of completed requests without blocking.
+	/// @return Number of callbacks invoked.
+	usize poll();
+	/// @brief Blocks until at least `count` requests complete (or nothing is in flight).
+	/// @return Number of callbacks invoked.
+	usize wait( usize count = 1 );
+	usize in_flight() const { return slots.size() - free_slots.size(); }
+
+	// IMPLEMENTATION lib::data::rstream_t, lib::data::wstream_t
+
+	/// @note Blocking calls close the stream if completions can't be reaped while their request is
+	///       in flight (see error()): the request must not outlive the call.
+	lib::data::result_t read( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t peek( const lib::data::buffer_t & buffer ) override;
+	lib::data::result_t write( const lib::data::cbuffer_t & buffer ) override;
+	int read_fd() override { return fd; }
+
+	// IMPLEMENTATION lib::data::unistream_t
+
+	/// @brief Waits for all requests in flight.
+	bool flush() override;
+	lib::data::result_t size() override;
+
+	// IMPLEMENTATION lib::data::rwstream_t
+
+	lib::data::result_t pos( usize position ) override;
+	lib::data::result_t pos() override { return pos_; }
+	::std::error_condition error() const override { return error_; }
+
+	class engine;
+private:
+	struct chunk {
+		enum class State : u8 { IDLE, PENDING, READY };
+		usize offset = 0;
+		lib::data::result_t result = (usize) 0;
+		State state = State::IDLE;
+	};
+
+	bool enqueue( bool write, usize offset, u8 * data, usize size, isize fixed_index, completion_fn && fn );
+	usize dispatch( bool block );
+	lib::data::result_t transfer( bool write, usize offset, u8 * data, usize size );
+	/// @brief Closes the stream keeping the error: engine shutdown settles requests in flight, their callbacks are dropped.
+	lib::data::result_t abandon();
+	void read_ahead();
+	void read_ahead_reset();
+	const ::std::error_condition & set_error_from_errno();
+
+	int fd = -1;
+	usize pos_ = 0;
+	::std::error_condition error_;
+	::std::unique_ptr<engine> engine_;
+
+	::std::vector<completion_fn> slots;
+	::std::vector<u32> free_slots;
+
+	::std::vector<u8> fixed_storage;
+	usize fixed_size = 0;
+	::std::vector<chunk> chunks;
+	usize ahead_first = 0;
+	usize ahead_offset = 0;
+};
+
+} // namespace lib::stream::impl
+
+#endif // CPPLIB__lib__impl_posix__stream__uring_file__hpp
@@ -120,6 +120,11 @@ bool base::set_blocking( bool blocking ) {
 	return check_error( ::ioctlsocket( sock, FIONBIO, &nonblocking ) ).success();
 }
 
+bool base::set_nodelay( bool nodelay ) {
+	const BOOL value = nodelay ? TRUE : FALSE;
+	return check_error( ::setsockopt( sock, IPPROTO_TCP, TCP_NODELAY, (const char *) &value, sizeof(value) ) ).success();
+}
+
 /*virtual */data::result_t base::check_error( isize result ) {
 	if ( result >= 0 )
 		return (usize) result;
@@ -49,6 +49,8 @@ public:
 	::std::error_condition error() const override;
 
 	bool set_blocking( bool blocking );
+	/// @brief TCP_NODELAY: small writes are sent right away instead of waiting for more data.
+	bool set_nodelay( bool nodelay );
 
 protected:
 	virtual data::result_t check_error( isize result );
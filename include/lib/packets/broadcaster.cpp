@@ -0,0 +1,57 @@
+/* File: /lib/packets/broadcaster.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include <cpp/lib_debug>
+
+#include "../../lib/impl/stream/data.hpp"
+
+#include "./broadcaster.hpp"
+
+namespace lib::packets {
+
+// IMPLEMENTATION lib::packets::Broadcaster
+
+void Broadcaster::attach( Handler & handler, id_type id ) noexcept {
+	CPP_ASSERT( ::std::none_of( targets.begin(), targets.end()
+		, [&]( const auto & target_ ) { return target_.handler == &handler; } ) );
+	targets.push_back({ &handler, id });
+}
+
+void Broadcaster::detach( Handler & handler ) noexcept {
+	const auto it = ::std::remove_if( targets.begin(), targets.end()
+		, [&]( const auto & target_ ) { return target_.handler == &handler; } );
+	targets.erase( it, targets.end() );
+}
+
+usize Broadcaster::send( const tag_serializeable & packet ) noexcept {
+	::lib::stream::impl::data stream {data::buffer_t {payload_}};
+	const auto & size = serialized_size( stream, packet );
+	if ( size.failed() or size > ::std::numeric_limits<Header::size_type>::max() )
+		return 0;
+	payload_.resize( size.value() );
+	stream.reset( data::buffer_t {payload_} );
+	const auto & written = serialize( stream, packet );
+	if ( written != size )
+		return 0;
+
+	usize sent = 0;
+	for ( const auto & target_ : targets ) {
+		auto & handler = *target_.handler;
+		const auto ok = handler.aggregated( target_.id )
+			? handler.send( target_.id, packet )
+			: handler.send_serialized( target_.id, payload_ );
+		if ( ok )
+			++sent;
+	}
+	return sent;
+}
+
+} // namespace lib::packets
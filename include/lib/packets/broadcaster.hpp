@@ -0,0 +1,58 @@
+/* File: /lib/packets/broadcaster.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__packets__broadcaster__hpp
+#define CPPLIB__lib__packets__broadcaster__hpp
+
+#include <vector>
+
+#include "../../lib/types.hpp"
+#include "../../lib/data/serialize.hpp"
+
+#include "./handler.hpp"
+
+namespace lib::packets {
+
+// DECLARATION lib::packets::Broadcaster
+
+/** @brief Sends the same packet to many handlers, serializing it once.
+ *  @details Payload is serialized into a buffer reused between send() calls, every handler
+ *  writes only its own header (in its header format) along with that buffer, see
+ *  Handler::send_serialized(). Handlers which aggregate the packet id (Handler::aggregated()) get
+ *  the packet through Handler::send() instead, so their aggregators see it as usual.
+ *  @note Handlers have to be detached before they are destroyed.
+ */
+class Broadcaster {
+public:
+	using id_type = Handler::id_type;
+
+	Broadcaster() noexcept = default;
+
+	/// @brief `handler` receives broadcasted packets with `id` in their header.
+	void attach( Handler & handler, id_type id ) noexcept;
+	void detach( Handler & handler ) noexcept;
+	usize size() const noexcept { return targets.size(); }
+
+	/** @return Count of handlers which have sent the packet, the others keep the reason in Handler::error().
+	 *          0 if the packet can't be serialized (nothing is sent).
+	 */
+	usize send( const tag_serializeable & packet ) noexcept;
+	/// @brief Serialized payload of the last send().
+	data::cbuffer_t payload() const noexcept { return payload_; }
+private:
+	struct target {
+		Handler * handler;
+		id_type id;
+	};
+
+	::std::vector<target> targets;
+	::std::vector<u8> payload_;
+};
+
+} // namespace lib::packets
+
+#endif // CPPLIB__lib__packets__broadcaster__hpp
@@ -0,0 +1,113 @@
+/* File: /lib/packets/dispatcher.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include <cpp/lib_debug>
+
+#include "./dispatcher.hpp"
+
+namespace lib::packets {
+
+// IMPLEMENTATION lib::packets::Dispatcher
+
+Dispatcher::Dispatcher( usize workers/* = 0*/ ) {
+	if ( workers == 0 )
+		workers = ::std::max( 1u, ::std::thread::hardware_concurrency() );
+	workers_.reserve( workers );
+	for ( usize i = 0; i < workers; ++i )
+		workers_.emplace_back( MkPtr<worker_t>() );
+	for ( auto & worker : workers_ )
+		worker->thread = ::std::thread {[this, &worker = *worker]() { run( worker ); }};
+}
+
+Dispatcher::~Dispatcher() noexcept {
+	for ( auto & route : routes )
+		route->handler.unlisten_payload( route->id );
+	{
+		::std::lock_guard lock {mutex};
+		stopping = true;
+	}
+	// Workers process queued payloads before they stop.
+	for ( auto & worker : workers_ ) {
+		worker->changed.notify_one();
+		worker->thread.join();
+	}
+}
+
+void Dispatcher::listen( Handler & handler, id_type id, usize key, const Job & job ) noexcept {
+	unlisten( handler, id );
+	auto & route = routes.emplace_back( MkPtr<route_t>( *this, handler, id, key, job ) );
+	handler.listen_payload( id, { *route, &route_t::onPayload } );
+}
+
+void Dispatcher::unlisten( Handler & handler, id_type id ) noexcept {
+	const auto it = ::std::find_if( routes.begin(), routes.end(), [&]( const auto & route ) {
+		return &route->handler == &handler and route->id == id;
+	});
+	if ( it == routes.end() )
+		return;
+	handler.unlisten_payload( id );
+	routes.erase( it );
+}
+
+void Dispatcher::wait() noexcept {
+	::std::unique_lock lock {mutex};
+	idle.wait( lock, [this]() { return pending == 0; } );
+}
+
+usize Dispatcher::failed() const noexcept {
+	::std::lock_guard lock {mutex};
+	return failed_;
+}
+
+bool Dispatcher::post( usize key, const Job & job, const Header & header, const data::cbuffer_t & payload ) noexcept {
+	::std::vector<u8> buffer;
+	{
+		::std::lock_guard lock {mutex};
+		if ( not pool.empty() ) {
+			buffer = ::std::move( pool.back() );
+			pool.pop_back();
+		}
+	}
+	// Payload is a view of the stream memory: it has to be copied before the handler consumes it.
+	buffer.assign( payload.begin(), payload.end() );
+	auto & worker = *workers_[key % workers_.size()];
+	{
+		::std::lock_guard lock {mutex};
+		worker.jobs.push_back({ job, header, ::std::move( buffer ) });
+		++pending;
+	}
+	worker.changed.notify_one();
+	return true;
+}
+
+void Dispatcher::run( worker_t & worker ) noexcept {
+	::std::unique_lock lock {mutex};
+	for ( ;; ) {
+		worker.changed.wait( lock, [&]() { return stopping or not worker.jobs.empty(); } );
+		if ( worker.jobs.empty() )
+			return;
+		auto job = ::std::move( worker.jobs.front() );
+		worker.jobs.pop_front();
+		lock.unlock();
+
+		const auto done = job.job( job.header, job.payload );
+
+		lock.lock();
+		if ( not done )
+			++failed_;
+		if ( pool.size() < POOL_SIZE_MAX )
+			pool.push_back( ::std::move( job.payload ) );
+		if ( --pending == 0 )
+			idle.notify_all();
+	}
+}
+
+} // namespace lib::packets
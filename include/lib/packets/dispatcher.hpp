@@ -0,0 +1,107 @@
+/* File: /lib/packets/dispatcher.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__packets__dispatcher__hpp
+#define CPPLIB__lib__packets__dispatcher__hpp
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../lib/tl/listener.hpp"
+#include "../../lib/types.hpp"
+#include "../../lib/ptr.hpp"
+#include "../../lib/data/buffer.hpp"
+
+#include "./packet.hpp"
+#include "./handler.hpp"
+
+namespace lib::packets {
+
+// DECLARATION lib::packets::Dispatcher
+
+/** @brief Processes received payloads on a pool of worker threads.
+ *  @details Handler::receive() (I/O thread) only decodes frames: payloads of listened ids are
+ *  copied into pooled buffers and queued to a worker, which calls the job and returns the buffer
+ *  to the pool. Jobs with the same key run on the same worker in the order they were received:
+ *
+ *      dispatcher.listen( handler, Chat::ID, Chat::ID, {chat, &Chat::onMessage} );	// per id
+ *      dispatcher.listen( handler, Move::ID, connection, {world, &World::onMove} );	// per connection
+ *
+ *  so a slow job delays only jobs of its worker, not the connection.
+ *  @note Queues are not bounded. Handlers have to outlive the dispatcher or be unlistened.
+ */
+class Dispatcher {
+public:
+	using id_type = Handler::id_type;
+	/// @brief Called on a worker thread, payload is valid until it returns.
+	using Job = Handler::PayloadReceiver;
+
+	/// @brief Released buffers kept for reuse.
+	static constexpr usize POOL_SIZE_MAX = 64;
+
+	/// @param workers Count of worker threads, 0 - one per core.
+	explicit Dispatcher( usize workers = 0 );
+	Dispatcher( const Dispatcher & ) = delete;
+	~Dispatcher() noexcept;
+
+	Dispatcher & operator = ( const Dispatcher & ) = delete;
+
+	/// @brief Payloads of `id` received by `handler` go to `job` on worker number `key % workers()`.
+	void listen( Handler & handler, id_type id, usize key, const Job & job ) noexcept;
+	void unlisten( Handler & handler, id_type id ) noexcept;
+
+	usize workers() const noexcept { return workers_.size(); }
+	/// @brief Waits until all queued payloads are processed.
+	void wait() noexcept;
+	/// @brief Count of jobs which returned false.
+	usize failed() const noexcept;
+private:
+	struct job_t {
+		Job job;
+		Header header;
+		::std::vector<u8> payload;
+	};
+
+	struct worker_t {
+		::std::deque<job_t> jobs;
+		::std::condition_variable changed;
+		::std::thread thread;
+	};
+
+	/// @brief Handler's PayloadReceiver of a listened id.
+	struct route_t : tag_tl_listener< route_t > {
+		route_t( Dispatcher & dispatcher, Handler & handler, id_type id, usize key, const Job & job ) noexcept
+			: dispatcher{ dispatcher }, handler{ handler }, id{ id }, key{ key }, job{ job } {}
+		bool onPayload( const Header & header, const data::cbuffer_t & payload ) noexcept
+			{ return dispatcher.post( key, job, header, payload ); }
+
+		Dispatcher & dispatcher;
+		Handler & handler;
+		const id_type id;
+		const usize key;
+		const Job job;
+	};
+
+	bool post( usize key, const Job & job, const Header & header, const data::cbuffer_t & payload ) noexcept;
+	void run( worker_t & worker ) noexcept;
+
+	mutable ::std::mutex mutex;
+	::std::condition_variable idle;
+	::std::vector< Ptr<worker_t> > workers_;
+	::std::vector< ::std::vector<u8> > pool;
+	::std::vector< Ptr<route_t> > routes;
+	usize pending = 0;
+	usize failed_ = 0;
+	bool stopping = false;
+};
+
+} // namespace lib::packets
+
+#endif // CPPLIB__lib__packets__dispatcher__hpp
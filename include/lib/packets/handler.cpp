@@ -6,6 +6,8 @@
  * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
  */
 
+#include <algorithm>
+#include <cstring>
 #include <initializer_list>
 #include <tuple>
 #include <vector>
@@ -17,20 +19,40 @@
 #include "../../lib/types.hpp"
 #include "../../lib/data/serialize.hpp"
 #include "../../lib/utils/enum.hpp"
+#include "../../lib/impl/stream/data.hpp"
 
 #include "./packet.hpp"
 #include "./aggregator.hpp"
+#include "./stats.hpp"
 
 #include "./handler.hpp"
 
 namespace lib::packets {
 
+namespace {
+
+/// @brief Clock isn't read unless stats are attached.
+inline Stats::clock::time_point stats_now( const Stats * stats ) noexcept {
+	return stats != nullptr ? Stats::clock::now() : Stats::clock::time_point {};
+}
+
+} // namespace
+
 // IMPLEMENTATION lib::packets::Handler
 
 void Handler::reset( data::rwstream_t * stream_/* = nullptr*/ ) noexcept {
 	reset_aggregators();
 	deserialize_error_.clear();
 	recv_header_.id = 0;
+	send_chunked.reset();
+	recv_chunked.reset();
+	recv_chunked_packet = nullptr;
+	if ( arena_ != nullptr )
+		arena_->reset();
+	batch_buff.clear();
+	batch_packets.clear();
+	batch_written = 0;
+	batch_depth = 0;
 	error_ = Error::SUCCESS;
 	stream = stream_;
 }
@@ -56,89 +78,417 @@ void Handler::unlisten( id_type first_id, count_type count ) noexcept {
 		unlisten( first_id + count );
 }
 
+void Handler::listen_payload( id_type id, const PayloadReceiver & receiver ) noexcept {
+	const auto size = ::std::max<usize>( payload_receivers.size(), id + 1 );
+	payload_receivers.resize( size );
+	payload_receivers[id] = receiver;
+}
+
+void Handler::unlisten_payload( id_type id ) noexcept {
+	CPP_ASSERT( id < payload_receivers.size() );
+	payload_receivers[id] = {};
+}
+
 bool Handler::attach_aggregator( const SPtr<ISendAggregator> & aggregated ) noexcept {
 	return aggregators.emplace( aggregated ).second;
 }
 
+bool Handler::aggregated( id_type id ) const noexcept {
+	return ::std::any_of( aggregators.begin(), aggregators.end(), [id]( const auto & aggregator_ ) {
+		const auto & aggregator = aggregator_.lock();
+		return aggregator and *aggregator == id;
+	} );
+}
+
 bool Handler::send( id_type id, const tag_serializeable & packet ) noexcept {
+	active_id = id;
+	if ( send_pending() )
+		return set_error( Error::SEND_PENDING );
 	if ( send_aggregated( id, packet ) )
 		return true;
 	CPP_ASSERT( stream != nullptr );
 	const auto & data_size = serialized_size( *stream, packet );
 	CPP_ASSERT( data_size.success() );
-	if ( not send_header( id, (Header::size_type) data_size.value() ) )
+	return send_packet( id, packet, (Header::size_type) data_size.value() );
+}
+
+bool Handler::send_serialized( id_type id, const data::cbuffer_t & payload ) noexcept {
+	active_id = id;
+	if ( send_pending() )
+		return set_error( Error::SEND_PENDING );
+	CPP_ASSERT( stream != nullptr );
+	flush_last_aggregator( {} );
+	const auto size = (Header::size_type) payload.size();
+	if ( batching() ) {
+		auto * data = batch_reserve( id, size );
+		if ( data == nullptr )
+			return false;
+		::std::memcpy( data, payload.data(), size );
+		return true;
+	}
+	u8 header[HEADER_SIZE_MAX];
+	const auto header_size = encode_header( { id, size }, header );
+	if ( not check_write_size( header_size, size ) )
+		return false;
+	if ( not write_gathered( { header, header_size }, payload ) )
 		return false;
-	if ( data_size == 0_sz )
+	if ( stats_ != nullptr )
+		stats_->sent( id, header_size + size );
+	return true;
+}
+
+bool Handler::end_batch() noexcept {
+	CPP_ASSERT( batch_depth > 0 );
+	if ( --batch_depth > 0 )
 		return true;
-	const auto & data_write = serialize( *stream, packet );
-	if ( data_write == data_size )
+	// Batch mixes packets of any ids.
+	active_id = 0;
+	if ( not write_batch() )
+		return false;
+	return batch_buff.empty() or set_error( Error::SEND_DATA_PARTIAL );
+}
+
+bool Handler::send_continue() noexcept {
+	if ( not send_pending() )
 		return true;
-	return set_error( data_write.failed()
-		? Error::SEND_DATA_STREAM_FAILED
-		: Error::SEND_DATA_PARTIAL );
+	if ( not batch_buff.empty() ) {
+		active_id = 0;
+		return write_batch();
+	}
+	active_id = send_chunked_id;
+	const auto & write_size = stream->write_size();
+	if ( write_size.failed() )
+		return set_error( Error::SEND_DATA_STREAM_FAILED );
+	const auto & data_write = send_chunked.write( *stream, write_size.value() );
+	if ( data_write.failed() )
+		return set_error( Error::SEND_DATA_STREAM_FAILED );
+	if ( not send_chunked.done() )
+		return true;
+	if ( send_chunked.transferred() != send_chunked_size )
+		return set_error( Error::SEND_DATA_PARTIAL );
+	if ( stats_ != nullptr )
+		stats_->sent( send_chunked_id, wire_size({ send_chunked_id, send_chunked_size }) );
+	return true;
 }
 
 bool Handler::receive() noexcept {
 	CPP_ASSERT( stream != nullptr );
 	for ( ;; ) {
 		if ( recv_header_.id == 0 ) {
-			if ( not can_deserialize( *stream, recv_header_ ) )
+			active_id = 0;
+			const auto varint_header = header_format_ == HeaderFormat::VARINT;
+			/// @note Compact header tells incomplete (0) and malformed (bad data) bytes apart by itself.
+			if ( not varint_header and not can_deserialize( *stream, recv_header_ ) )
 				return true;
-			const auto & header_read = data::deserialize( *stream, recv_header_ );
+			const auto & header_read = varint_header
+				? packets::deserialize( *stream, data::varint{recv_header_} )
+				: data::deserialize( *stream, recv_header_ );
 			if ( header_read == 0_sz )
 				return true;
-			if ( header_read != HEADER_SIZE )
+			if ( header_read.failed() and header_read.error() == make_error_bad_data() )
+				return set_error( Error::RECEIVE_HEADER_BAD );
+			const auto header_size = varint_header
+				? serialized_size( *stream, data::varint{recv_header_} ).value()
+				: HEADER_SIZE;
+			if ( header_read != header_size )
 				return set_error( header_read.failed()
 				? Error::RECEIVE_HEADER_STREAM_FAILED
 				: Error::RECEIVE_HEADER_PARTIAL );
 			CPP_ASSERT( recv_header_.id != 0 );
 		}
+		// Id comes from the peer: unknown ones are accounted under 0, never by their value.
+		const auto known_id = recv_header_.id < receivers.size() or recv_header_.id < payload_receivers.size();
+		active_id = known_id ? recv_header_.id : 0;
 		const auto & read_size = stream->read_size();
 		if ( read_size.failed() )
 			return set_error( Error::RECEIVE_DATA_STREAM_FAILED );
-		if ( read_size < recv_header_.size )
-			return true;
+		if ( recv_header_.id < payload_receivers.size() and payload_receivers[ recv_header_.id ] ) {
+			if ( read_size < recv_header_.size )
+				return true;
+			if ( not receive_payload() )
+				return false;
+			recv_header_.id = 0;
+			continue;
+		}
 		if ( recv_header_.id >= receivers.size() )
 			return set_error( Error::RECEIVE_HEADER_BAD_ID );
-		const auto & [ packet, data_read ] = deserialize( *stream, recv_header_ );
-		if ( packet == nullptr )
-			return set_error( Error::RECEIVE_PACKET_UNKNOWN );
-		if ( data_read.failed() ) {
-			deserialize_error_ = data_read.error();
-			return set_error( Error::RECEIVE_DATA_STREAM_FAILED );
-		}
-		if ( data_read != recv_header_.size ) {
-			if ( data_read == 0_sz )
+		const tag_serializeable * packet = nullptr;
+		if ( recv_chunked_packet != nullptr or
+			( read_size < recv_header_.size and recv_header_.size > GATHER_SIZE_MAX ) ) {
+			if ( not receive_chunked( read_size, packet ) )
+				return false;
+			if ( packet == nullptr )
+				return true;
+		} else {
+			if ( read_size < recv_header_.size )
 				return true;
-			if ( data_read > 0_sz )
-				return set_error( Error::RECEIVE_DATA_PARTIAL );
+			if ( arena_ != nullptr )
+				arena_->reset();
+			const auto start = stats_now( stats_ );
+			const auto & [ packet_, data_read ] = deserialize( *stream, recv_header_ );
+			if ( stats_ != nullptr )
+				stats_->deserialized( active_id, start );
+			if ( packet_ == nullptr )
+				return set_error( Error::RECEIVE_PACKET_UNKNOWN );
+			if ( data_read.failed() ) {
+				deserialize_error_ = data_read.error();
+				return set_error( Error::RECEIVE_DATA_STREAM_FAILED );
+			}
+			if ( data_read != recv_header_.size ) {
+				if ( data_read == 0_sz )
+					return true;
+				if ( data_read > 0_sz )
+					return set_error( Error::RECEIVE_DATA_PARTIAL );
+			}
+			packet = packet_;
 		}
+		if ( stats_ != nullptr )
+			stats_->received( active_id, wire_size( recv_header_ ) );
 		auto & receiver = receivers[ recv_header_.id ];
 		if ( not receiver )
 			return set_error( Error::RECEIVE_NO_RECEIVER );
-		if ( not receiver( *packet ) )
+		const auto start = stats_now( stats_ );
+		const auto received = receiver( *packet );
+		if ( stats_ != nullptr )
+			stats_->receiver_returned( active_id, start );
+		// Packets are transient: nothing stays bound to the arena after the receiver.
+		if ( arena_ != nullptr )
+			arena_->reset();
+		if ( not received )
 			return set_error( Error::RECEIVE_RECEIVER_FAILED );
 		recv_header_.id = 0;
 	}
 }
 
-bool Handler::send_header( id_type id, Header::size_type size ) noexcept {
-	const auto total_size = HEADER_SIZE + size;
+usize Handler::encode_header( const Header & header, u8 * out ) const noexcept {
+	if ( header_format_ == HeaderFormat::VARINT )
+		return encode( data::varint{header}, out );
+	::std::memcpy( out, &header, HEADER_SIZE );
+	return HEADER_SIZE;
+}
+
+usize Handler::wire_size( const Header & header ) const noexcept {
+	u8 encoded[HEADER_SIZE_MAX];
+	return encode_header( header, encoded ) + header.size;
+}
+
+bool Handler::send_packet( id_type id, const tag_serializeable & packet, Header::size_type size ) noexcept {
+	if ( batching() ) {
+		if ( size <= GATHER_SIZE_MAX )
+			return send_batched( id, packet, size );
+		if ( not write_batch() )
+			return false;
+		if ( not batch_buff.empty() )
+			return set_error( Error::SEND_QUEUE_FULL );
+	}
+	// Batched and chunked packets are accounted once written (write_batch(), send_continue()).
+	if ( size > GATHER_SIZE_MAX and packet.serialize_chunked( send_chunked ) ) {
+		send_chunked_size = size;
+		send_chunked_id = id;
+		if ( not send_header( id, send_chunked_size, 0 ) ) {
+			send_chunked.reset();
+			return false;
+		}
+		return send_continue();
+	}
+	const auto written = size > 0 and size <= GATHER_SIZE_MAX
+		? send_gathered( id, packet, size )
+		: send_direct( id, packet, size );
+	if ( written and stats_ != nullptr )
+		stats_->sent( id, wire_size({ id, size }) );
+	return written;
+}
+
+bool Handler::send_direct( id_type id, const tag_serializeable & packet, Header::size_type size ) noexcept {
+	if ( not send_header( id, size, size ) )
+		return false;
+	if ( size == 0 )
+		return true;
+	const auto & data_write = serialize_packet( *stream, packet );
+	if ( data_write == size )
+		return true;
+	return set_error( data_write.failed()
+		? Error::SEND_DATA_STREAM_FAILED
+		: Error::SEND_DATA_PARTIAL );
+}
+
+bool Handler::check_write_size( usize header_size, Header::size_type size ) noexcept {
+	const auto total_size = header_size + size;
 	const auto & write_size = stream->write_size();
 	if ( write_size.failed() )
 		return set_error( Error::SEND_HEADER_STREAM_FAILED );
 	if ( total_size > write_size )
 		return set_error( Error::SEND_QUEUE_FULL );
-	const Header header{ id, size };
-	const auto & header_write = serialize( *stream, header );
-	if ( header_write == HEADER_SIZE )
+	return true;
+}
+
+bool Handler::send_header( id_type id, Header::size_type size, Header::size_type reserve ) noexcept {
+	u8 header[HEADER_SIZE_MAX];
+	const auto header_size = encode_header( { id, size }, header );
+	if ( not check_write_size( header_size, reserve ) )
+		return false;
+	const auto & header_write = stream->write({ header, header_size });
+	if ( header_write == header_size )
 		return true;
 	return set_error( header_write.failed()
 		? Error::SEND_HEADER_STREAM_FAILED
 		: Error::SEND_HEADER_PARTIAL );
 }
 
+bool Handler::send_gathered( id_type id, const tag_serializeable & packet, Header::size_type size ) noexcept {
+	u8 header[HEADER_SIZE_MAX];
+	const auto header_size = encode_header( { id, size }, header );
+	if ( not check_write_size( header_size, size ) )
+		return false;
+	send_buff.resize( size );
+	::lib::stream::impl::data payload {data::buffer_t {send_buff}};
+	const auto & data_write = serialize_packet( payload, packet );
+	if ( data_write != size )
+		return set_error( data_write.failed()
+			? Error::SEND_DATA_STREAM_FAILED
+			: Error::SEND_DATA_PARTIAL );
+	return write_gathered( { header, header_size }, send_buff );
+}
+
+bool Handler::write_gathered( const data::cbuffer_t & header, const data::cbuffer_t & payload ) noexcept {
+	const data::cbuffer_t buffers[] = { header, payload };
+	const auto & total_write = stream->writev( buffers );
+	if ( total_write == header.size() + payload.size() )
+		return true;
+	if ( total_write.failed() )
+		return set_error( Error::SEND_HEADER_STREAM_FAILED );
+	return set_error( total_write < header.size()
+		? Error::SEND_HEADER_PARTIAL
+		: Error::SEND_DATA_PARTIAL );
+}
+
+u8 * Handler::batch_reserve( id_type id, Header::size_type size ) noexcept {
+	u8 header[HEADER_SIZE_MAX];
+	const auto header_size = encode_header( { id, size }, header );
+	const auto offset = batch_buff.size();
+	if ( not check_write_size( offset + header_size, size ) )
+		return nullptr;
+	batch_buff.resize( offset + header_size + size );
+	batch_packets.emplace_back( id, header_size + size );
+	::std::memcpy( batch_buff.data() + offset, header, header_size );
+	return batch_buff.data() + offset + header_size;
+}
+
+bool Handler::send_batched( id_type id, const tag_serializeable & packet, Header::size_type size ) noexcept {
+	const auto offset = batch_buff.size();
+	auto * data = batch_reserve( id, size );
+	if ( data == nullptr )
+		return false;
+	/// @note Payload is serialized in place, right after its header.
+	::lib::stream::impl::data payload {data::buffer_t {data, size}};
+	const auto & data_write = serialize_packet( payload, packet );
+	if ( data_write == size )
+		return true;
+	batch_buff.resize( offset );
+	batch_packets.pop_back();
+	return set_error( data_write.failed()
+		? Error::SEND_DATA_STREAM_FAILED
+		: Error::SEND_DATA_PARTIAL );
+}
+
+bool Handler::write_batch() noexcept {
+	if ( batch_buff.empty() )
+		return true;
+	const auto & data_write = stream->write( batch_buff );
+	if ( data_write.failed() ) {
+		batch_buff.clear();
+		batch_packets.clear();
+		batch_written = 0;
+		return set_error( Error::SEND_DATA_STREAM_FAILED );
+	}
+	// Packets are accounted once written completely, the unsent tail is kept in order.
+	auto written = batch_written + data_write.value();
+	usize sent = 0;
+	for ( ; sent < batch_packets.size() and batch_packets[sent].second <= written; ++sent ) {
+		written -= batch_packets[sent].second;
+		if ( stats_ != nullptr )
+			stats_->sent( batch_packets[sent].first, batch_packets[sent].second );
+	}
+	batch_packets.erase( batch_packets.begin(), batch_packets.begin() + (isize) sent );
+	batch_written = written;
+	batch_buff.erase( batch_buff.begin(), batch_buff.begin() + (isize) data_write.value() );
+	return true;
+}
+
+bool Handler::receive_chunked( const data::result_t & read_size, const tag_serializeable *& packet ) noexcept {
+	if ( recv_chunked_packet == nullptr ) {
+		if ( arena_ != nullptr )
+			arena_->reset();
+		recv_chunked_packet = deserialize_chunked( recv_header_, recv_chunked );
+		// Not supported by the packet: wait for the whole payload.
+		if ( recv_chunked_packet == nullptr )
+			return true;
+	}
+	// Never read past the payload, even if fields of the packet don't match it.
+	const auto remain = recv_header_.size - recv_chunked.transferred();
+	const auto start = stats_now( stats_ );
+	const auto & data_read = recv_chunked.read( *stream, ::std::min( read_size.value(), remain ), remain );
+	if ( stats_ != nullptr )
+		stats_->deserialized( active_id, start );
+	if ( data_read.failed() ) {
+		deserialize_error_ = data_read.error();
+		return set_error( deserialize_error_ == make_error_bad_data()
+			? Error::RECEIVE_DATA_DESERIALIZE_FAILED
+			: Error::RECEIVE_DATA_STREAM_FAILED );
+	}
+	const auto payload_read = recv_chunked.transferred() == recv_header_.size;
+	if ( not recv_chunked.done() )
+		return payload_read ? set_error( Error::RECEIVE_DATA_PARTIAL ) : true;
+	if ( not payload_read )
+		return set_error( Error::RECEIVE_DATA_PARTIAL );
+	packet = ::std::exchange( recv_chunked_packet, nullptr );
+	return true;
+}
+
+bool Handler::receive_payload() noexcept {
+	const auto size = recv_header_.size;
+	const auto & memory = stream->read_cbuffer( false );
+	const auto & position = memory.size() >= size
+		? stream->read_pos()
+		: data::result_t {make_error_not_implemented()};
+	const auto & deliver = [&]( const data::cbuffer_t & payload ) {
+		if ( stats_ == nullptr )
+			return payload_receivers[ recv_header_.id ]( recv_header_, payload );
+		stats_->received( active_id, wire_size( recv_header_ ) );
+		const auto start = Stats::clock::now();
+		const auto received = payload_receivers[ recv_header_.id ]( recv_header_, payload );
+		stats_->receiver_returned( active_id, start );
+		return received;
+	};
+	bool received;
+	if ( position.success() ) {
+		received = deliver({ memory.data(), size });
+		// Consumed only now: the receiver has been looking right into the stream.
+		if ( stream->read_pos( position.value() + size ).failed() )
+			return set_error( Error::RECEIVE_DATA_STREAM_FAILED );
+	} else {
+		recv_payload.resize( size );
+		const auto & data_read = stream->read( recv_payload );
+		if ( data_read != size )
+			return set_error( data_read.failed()
+				? Error::RECEIVE_DATA_STREAM_FAILED
+				: Error::RECEIVE_DATA_PARTIAL );
+		received = deliver( recv_payload );
+	}
+	return received or set_error( Error::RECEIVE_RECEIVER_FAILED );
+}
+
+data::result_t Handler::serialize_packet( data::wstream_t & stream_, const tag_serializeable & packet ) noexcept {
+	const auto start = stats_now( stats_ );
+	const auto & data_write = serialize( stream_, packet );
+	if ( stats_ != nullptr )
+		stats_->serialized( active_id, start );
+	return data_write;
+}
+
 bool Handler::set_error( Error error ) noexcept {
+	if ( stats_ != nullptr )
+		stats_->failed( active_id, error );
 	if ( error_ == Error::SUCCESS )
 		error_ = error;
 	return false;
@@ -224,7 +574,16 @@ ReadHandler::DeserializeResult ReadHandler
 	auto * packet = packets[header.id];
 	if ( packet == nullptr )
 		return {};
-	return { packet, packet->deserialize( stream_ ) };
+	return { packet, packet->deserialize( deserialize_context(), stream_ ) };
+}
+
+tag_serializeable * ReadHandler::deserialize_chunked( const Header & header, data::chunked_t & chunked ) {
+	if ( packets.size() <= header.id )
+		return nullptr;
+	auto * packet = packets[header.id];
+	if ( packet == nullptr or not packet->deserialize_chunked( chunked ) )
+		return nullptr;
+	return packet;
 }
 
 } // namespace lib::packets
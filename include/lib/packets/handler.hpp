@@ -8,6 +8,7 @@
 #ifndef CPPLIB__lib__packets__handler__hpp
 #define CPPLIB__lib__packets__handler__hpp
 
+#include <algorithm>
 #include <initializer_list>
 #include <tuple>
 #include <vector>
@@ -22,12 +23,16 @@
 #include "../../lib/ptr.hpp"
 #include "../../lib/data/stream.hpp"
 #include "../../lib/data/serialize.hpp"
+#include "../../lib/data/chunked.hpp"
+#include "../../lib/data/arena.hpp"
 #include "../../lib/utils/enum.hpp"
 
 #include "./packet.hpp"
 
 namespace lib::packets {
 
+class Stats;
+
 // DECLARATION lib::packets::Handler
 
 class Handler {
@@ -39,11 +44,14 @@ public:
 
 	using Receiver = tl::listener<bool, const tag_serializeable &>;
 	using Receivers = ::std::vector< Receiver >;
+	/// @brief Receiver of a raw payload, see listen_payload().
+	using PayloadReceiver = tl::listener<bool, const Header &, const data::cbuffer_t &>;
 
 	/// @todo ::std::error_condition
 	LIB_UTILS_ENUM( Error
 		, SUCCESS
 		, SEND_QUEUE_FULL
+		, SEND_PENDING
 		, SEND_HEADER_STREAM_FAILED
 		, SEND_HEADER_PARTIAL
 		, SEND_DATA_STREAM_FAILED
@@ -51,6 +59,7 @@ public:
 		, RECEIVE_HEADER_STREAM_FAILED
 		, RECEIVE_HEADER_PARTIAL
 		, RECEIVE_HEADER_BAD_ID
+		, RECEIVE_HEADER_BAD
 		, RECEIVE_PACKET_UNKNOWN
 		, RECEIVE_DATA_STREAM_FAILED
 		, RECEIVE_DATA_DESERIALIZE_FAILED
@@ -59,10 +68,19 @@ public:
 		, RECEIVE_RECEIVER_FAILED
 	)
 
+	/// @brief Wire format of packet headers, both sides have to use the same one.
+	enum class HeaderFormat : u8 {
+		FIXED,	///< Header as is (8 bytes)
+		VARINT,	///< data::varint<Header> (2-10 bytes)
+	};
+
 	/*constexpr */Handler() noexcept = default;
 	virtual ~Handler() = default;
 
 	constexpr Error error() const noexcept { return error_; }
+	constexpr HeaderFormat header_format() const noexcept { return header_format_; }
+	/// @note Switch it only between packets (before reset() or on a fresh stream).
+	constexpr void header_format( HeaderFormat format ) noexcept { header_format_ = format; }
 
 	void reset( data::rwstream_t * stream_ = nullptr ) noexcept;
 
@@ -70,13 +88,54 @@ public:
 	void listen( id_type first_id, ::std::initializer_list<Receiver> receivers_ ) noexcept;
 	void unlisten( id_type id ) noexcept;
 	void unlisten( id_type first_id, count_type count ) noexcept;
+	/** @brief Packets with `id` aren't deserialized: `receiver` gets their payload as is.
+	 *  @details Payload is a view of the stream memory (read_cbuffer()), it's consumed after the
+	 *  receiver returns, so it can be inspected or forwarded without copying. Streams which don't
+	 *  expose their memory get the payload copied into an internal buffer, as well as payloads
+	 *  which aren't contiguous in stream memory: crossing the storage end of stream::impl::spsc or
+	 *  a block boundary of stream::impl::chain degrades to the copy from time to time.
+	 *  @note Payload is valid until the receiver returns. Whole payload has to fit in the stream buffer.
+	 */
+	void listen_payload( id_type id, const PayloadReceiver & receiver ) noexcept;
+	void unlisten_payload( id_type id ) noexcept;
 
 	bool attach_aggregator( const SPtr<ISendAggregator> & aggregator ) noexcept;
+	/// @brief Packets with `id` go through an attached aggregator on send().
+	bool aggregated( id_type id ) const noexcept;
+	/// @brief Packets are deserialized with the arena as context, it's reset before every packet and once
+	///        the receiver returns (containers of the packet are left empty, see data::arena_t::reset()).
+	/// @note Deserialized packet is valid until the receiver returns,
+	constexpr void attach_arena( data::arena_t * arena ) noexcept { arena_ = arena; }
+	/// @brief Sent and received packets, their timings and errors are accounted in `stats` (nullptr - off).
+	constexpr void attach_stats( Stats * stats ) noexcept { stats_ = stats; }
 
 	template< class T >
 	constexpr bool send( const T & packet ) noexcept;
 	bool send( id_type id, const tag_serializeable & packet ) noexcept;
-
+	/// @brief Sends already serialized payload (e.g. shared by Broadcaster), aggregators are bypassed.
+	bool send_serialized( id_type id, const data::cbuffer_t & payload ) noexcept;
+	/** @brief Chunked send of a big packet or the tail of a batch is in progress, no other packet can be sent meanwhile.
+	 *  @details Packets bigger than GATHER_SIZE_MAX which support tag_serializeable::serialize_chunked()
+	 *  are written as much as the stream accepts, the rest is written by send_continue() calls.
+	 *  Such packet has to stay valid and unchanged until send_pending() is false.
+	 */
+	bool send_pending() const noexcept { return not send_chunked.done() or ( not batching() and not batch_buff.empty() ); }
+	bool send_continue() noexcept;
+
+	/** @brief Packets sent until the matching end_batch() are gathered back-to-back in a buffer
+	 *  and written to the stream with a single write by end_batch().
+	 *  @details Packets bigger than GATHER_SIZE_MAX write the gathered ones first and go as usual.
+	 *  Batches may be nested, only the outermost end_batch() writes.
+	 *  @note For sockets it replaces TCP_CORK, consider tcp::base::set_nodelay() along with it.
+	 */
+	void begin_batch() noexcept { ++batch_depth; }
+	/// @return false if gathered packets weren't written completely, see error(). The unsent tail is kept
+	///         (SEND_DATA_PARTIAL) and written by send_continue(), or by the next batch.
+	bool end_batch() noexcept;
+	bool batching() const noexcept { return batch_depth > 0; }
+
+	/// @note Big packets which support tag_serializeable::deserialize_chunked() are read as their
+	///       payload arrives, instead of waiting for the whole payload to be in the stream.
 	bool receive() noexcept;
 
 	constexpr const Header & recv_header() const noexcept { return recv_header_; }
@@ -84,21 +143,69 @@ public:
 protected:
 	using DeserializeResult = ::std::tuple< const tag_serializeable *, data::result_t >;
 	virtual DeserializeResult deserialize( data::rstream_t & stream, const Header & header ) = 0;
+	void * deserialize_context() const noexcept { return arena_ != nullptr ? arena_->context() : nullptr; }
+	/// @return Packet which planned its fields in `chunked`, nullptr if chunked reading isn't supported.
+	virtual tag_serializeable * deserialize_chunked( const Header & /*header*/, data::chunked_t & /*chunked*/ ) { return nullptr; }
 private:
 	static constexpr auto HEADER_SIZE = sizeof(Header);
-
-	bool send_header( id_type id, Header::size_type size ) noexcept;
+	static constexpr auto HEADER_SIZE_MAX = ::std::max( HEADER_SIZE, VARINT_HEADER_SIZE_MAX );
+	/// @brief Bigger payloads are serialized straight into the stream instead of a gathered write.
+	static constexpr usize GATHER_SIZE_MAX = 64 * 1024;
+
+	/// @return Size of the header written into `out` of at least HEADER_SIZE_MAX bytes.
+	usize encode_header( const Header & header, u8 * out ) const noexcept;
+	bool check_write_size( usize header_size, Header::size_type size ) noexcept;
+	/// @param reserve Payload bytes which have to fit the stream together with the header.
+	/// @return Size of the packet on the wire (with its header).
+	usize wire_size( const Header & header ) const noexcept;
+	bool send_packet( id_type id, const tag_serializeable & packet, Header::size_type size ) noexcept;
+	bool send_header( id_type id, Header::size_type size, Header::size_type reserve ) noexcept;
+	bool send_gathered( id_type id, const tag_serializeable & packet, Header::size_type size ) noexcept;
+	/// @brief Header, then the packet serialized right into the stream.
+	bool send_direct( id_type id, const tag_serializeable & packet, Header::size_type size ) noexcept;
+	/// @brief Header and payload go to the stream with a single (vectored) write.
+	bool write_gathered( const data::cbuffer_t & header, const data::cbuffer_t & payload ) noexcept;
+	/// @return Memory for `size` bytes of payload in the batch after the header, nullptr on error.
+	u8 * batch_reserve( id_type id, Header::size_type size ) noexcept;
+	bool send_batched( id_type id, const tag_serializeable & packet, Header::size_type size ) noexcept;
+	/// @return false if the stream failed, written part of the batch is removed and accounted.
+	bool write_batch() noexcept;
+	/// @brief serialize() of the packet being sent, timed if stats are attached.
+	data::result_t serialize_packet( data::wstream_t & stream_, const tag_serializeable & packet ) noexcept;
 	bool set_error( Error error ) noexcept;
+	/// @return false if receiving failed, `packet` is set once the whole payload is read.
+	bool receive_chunked( const data::result_t & read_size, const tag_serializeable *& packet ) noexcept;
+	/// @brief Passes the whole payload in the stream to its PayloadReceiver.
+	bool receive_payload() noexcept;
 
 	bool send_aggregated( id_type id, const tag_serializeable & packet ) noexcept;
 	void flush_last_aggregator( const SPtr<ISendAggregator> & aggregator ) noexcept;
 	void reset_aggregators() noexcept;
 
 	Receivers receivers;
+	::std::vector< PayloadReceiver > payload_receivers;
+	::std::vector<u8> recv_payload;
 	data::rwstream_t * stream = nullptr;
 	Error error_ = Error::SUCCESS;
+	HeaderFormat header_format_ = HeaderFormat::FIXED;
 	Header recv_header_ = {};
 	::std::error_condition deserialize_error_;
+	::std::vector<u8> send_buff;
+	data::chunked_t send_chunked;
+	Header::size_type send_chunked_size = 0;
+	id_type send_chunked_id = 0;
+	data::chunked_t recv_chunked;
+	tag_serializeable * recv_chunked_packet = nullptr;
+	::std::vector<u8> batch_buff;
+	/// @brief Packets of batch_buff (id and wire size) to be accounted as sent once written.
+	::std::vector< ::std::pair<id_type, usize> > batch_packets;
+	/// @brief Bytes of the first of batch_packets which are already written.
+	usize batch_written = 0;
+	usize batch_depth = 0;
+	data::arena_t * arena_ = nullptr;
+	Stats * stats_ = nullptr;
+	/// @brief Id of the packet being sent or received (0 - header isn't read yet), errors are accounted to it.
+	id_type active_id = 0;
 
 	::std::set< WPtr<ISendAggregator>, ::cpp::wptr_less<WPtr<ISendAggregator>> > aggregators;
 	WPtr<ISendAggregator> last_aggregator;
@@ -129,6 +236,7 @@ private:
 	using Super::unlisten;
 
 	DeserializeResult deserialize( data::rstream_t & stream_, const Header & header ) override;
+	tag_serializeable * deserialize_chunked( const Header & header, data::chunked_t & chunked ) override;
 
 	::std::vector<tag_serializeable*> packets;
 };
@@ -145,6 +253,7 @@ inline constexpr bool Handler::send( const T & packet ) noexcept {
 LIB_UTILS_ENUM_NAMES( lib::packets::Handler::Error
 	, "success"
 	, "send queue is full"
+	, "send pending"
 	, "send-header stream failed"
 	, "send-header partial"
 	, "send-data stream_failed"
@@ -152,6 +261,7 @@ LIB_UTILS_ENUM_NAMES( lib::packets::Handler::Error
 	, "receive-header stream failed"
 	, "receive-header partial"
 	, "receive-header bad id"
+	, "receive-header malformed"
 	, "receive-packet unknown"
 	, "receive-data stream failed"
 	, "receive-data deserialize failed"
@@ -8,7 +8,12 @@
 #ifndef CPPLIB__lib__packets__packet__hpp
 #define CPPLIB__lib__packets__packet__hpp
 
+#include <cpp/lib_concepts>
+
 #include "../../lib/types.hpp"
+#include "../../lib/literals.hpp"
+#include "../../lib/data/stream.hpp"
+#include "../../lib/impl/serialize/varint.hpp"
 //#include "../../lib/debug/features.hpp"
 
 namespace lib::packets {
@@ -22,6 +27,89 @@ struct /*alignas(1)*/ Header {
 	size_type size;
 };
 
+// IMPLEMENTATION lib::data::varint<lib::packets::Header>
+
+/// @brief Compact header is written as varint( id ) varint( size ): 2-4 bytes for most packets instead of 8.
+template< class H >
+concept VarintHeader = ::cpp::SameAs<::std::remove_const_t<H>, Header>;
+
+/// @brief Max size of a compact header field (u32).
+inline constexpr usize VARINT_FIELD_SIZE_MAX = 5;
+/// @brief Max size of compact header, u32 fields take up to 5 bytes each.
+inline constexpr usize VARINT_HEADER_SIZE_MAX = 2 * VARINT_FIELD_SIZE_MAX;
+
+template< VarintHeader H >
+constexpr inline usize encode( const data::varint<H> & header, u8 * out ) noexcept {
+	const auto size = data::leb128::encode( header.value.id, out );
+	return size + data::leb128::encode( header.value.size, out + size );
+}
+
+template< data::WriteStream S, VarintHeader H >
+constexpr inline data::result_t serialized_size( S &/* stream*/, const data::varint<H> & header ) {
+	return data::leb128::size( header.value.id ) + data::leb128::size( header.value.size );
+}
+
+namespace detail {
+/// @return Size of a header field, 0 if it is incomplete, -1 if it is longer than 5 bytes or over 32 bits.
+inline isize decode_field( const u8 * bytes, usize size, u32 & field ) noexcept {
+	u64 wire;
+	const auto field_size = data::leb128::decode( bytes, ::std::min( size, VARINT_FIELD_SIZE_MAX ), wire );
+	if ( field_size == 0 )
+		return size < VARINT_FIELD_SIZE_MAX ? 0 : -1;
+	if ( field_size < 0 or not data::leb128::unpack( wire, field ) )
+		return -1;
+	return field_size;
+}
+
+/// @return Size of compact header at the start of `bytes`, 0 if it is incomplete, bad data error if it is malformed.
+inline data::result_t decode( const u8 * bytes, usize size, Header & header ) noexcept {
+	const auto id_size = decode_field( bytes, size, header.id );
+	if ( id_size <= 0 )
+		return id_size == 0 ? data::result_t {0_sz} : data::result_t {make_error_bad_data()};
+	const auto size_size = decode_field( bytes + id_size, size - (usize) id_size, header.size );
+	if ( size_size <= 0 )
+		return size_size == 0 ? data::result_t {0_sz} : data::result_t {make_error_bad_data()};
+	return (usize)( id_size + size_size );
+}
+} // namespace detail
+
+/// @note false for both incomplete and malformed header, deserialize() tells them apart.
+template< data::ReadStream S, VarintHeader H >
+constexpr inline bool can_deserialize( S & stream, const data::varint<H> &/* header*/ ) {
+	u8 bytes[VARINT_HEADER_SIZE_MAX];
+	const auto & peeked = stream.peek({ bytes, sizeof(bytes) });
+	if ( peeked.failed() )
+		return false;
+	Header header;
+	const auto & decoded = detail::decode( bytes, peeked.value(), header );
+	return decoded.success() and decoded > 0_sz;
+}
+
+template< data::WriteStream S, VarintHeader H >
+constexpr inline data::result_t serialize( S & stream, const data::varint<H> & header ) {
+	u8 bytes[VARINT_HEADER_SIZE_MAX];
+	return stream.write({ bytes, encode( header, bytes ) });
+}
+
+/** @return Size of the header, 0 if it is incomplete (nothing is consumed), bad data error if it is malformed.
+ *  @note Needs peek() support.
+ */
+template< data::ReadStream S >
+constexpr inline data::result_t deserialize( S & stream, const data::varint<Header> & header ) {
+	u8 bytes[VARINT_HEADER_SIZE_MAX];
+	const auto & peeked = stream.peek({ bytes, sizeof(bytes) });
+	if ( peeked.failed() )
+		return peeked;
+	Header decoded_header;
+	const auto & decoded = detail::decode( bytes, peeked.value(), decoded_header );
+	if ( decoded.failed() or decoded == 0_sz )
+		return decoded;
+	const auto & readen = stream.read({ bytes, decoded.value() });
+	if ( readen == decoded )
+		header.value = decoded_header;
+	return readen;
+}
+
 // DECLARATION lib::packets::Packet
 
 //struct /*alignas(1)*/ Packet
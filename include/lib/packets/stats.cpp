@@ -0,0 +1,132 @@
+/* File: /lib/packets/stats.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <cinttypes>
+#include <cstdio>
+
+#include <algorithm>
+
+#include "../../lib/utils/enum.hpp"
+
+#include "./stats.hpp"
+
+namespace lib::packets {
+
+namespace {
+
+template< class...Args >
+void append( ::std::string & out, const char * format, Args...args ) {
+	char line[256];
+	const auto count = ::std::snprintf( line, sizeof( line ), format, args... );
+	out.append( line, (usize) ::std::clamp( count, 0, (int) sizeof( line ) - 1 ) );
+}
+
+inline u64 elapsed_ns( Stats::clock::time_point start ) noexcept {
+	return (u64) ::std::chrono::duration_cast<::std::chrono::nanoseconds>( Stats::clock::now() - start ).count();
+}
+
+} // namespace
+
+// IMPLEMENTATION lib::packets::Stats::snapshot_t
+
+const Stats::counters_t * Stats::snapshot_t::find( id_type id ) const noexcept {
+	const auto it = ::std::lower_bound( ids.begin(), ids.end(), id
+		, []( const entry_t & entry, id_type id_ ) { return entry.id < id_; } );
+	return it != ids.end() and it->id == id ? &it->counters : nullptr;
+}
+
+::std::string Stats::snapshot_t::text() const {
+	::std::string out;
+	append( out, "%-6s %10s %14s %10s %14s %14s %14s %10s %10s %10s %10s %8s\n"
+		, "id", "sent", "sent_bytes", "received", "recv_bytes", "serialize", "deserialize"
+		, "receivers", "mean", "p99", "max", "errors" );
+	for ( const auto & [ id, counters ] : ids ) {
+		u64 errors = 0;
+		for ( usize i = 1; i < counters.errors.size(); ++i )
+			errors += counters.errors[i];
+		const auto & receiver = counters.receiver_ns;
+		append( out, "%-6u %10" PRIu64 " %14" PRIu64 " %10" PRIu64 " %14" PRIu64 " %14" PRIu64 " %14" PRIu64
+			" %10" PRIu64 " %10.0f %10" PRIu64 " %10" PRIu64 " %8" PRIu64 "\n"
+			, (unsigned) id, counters.sent, counters.sent_bytes, counters.received, counters.received_bytes
+			, counters.serialize_ns, counters.deserialize_ns
+			, receiver.count(), receiver.mean(), receiver.percentile( 0.99 ), receiver.max(), errors );
+		for ( usize i = 1; i < counters.errors.size(); ++i )
+			if ( counters.errors[i] > 0 )
+				append( out, "%-6s %s: %" PRIu64 "\n", "", utils::NAMES<Error>[i], counters.errors[i] );
+	}
+	return out;
+}
+
+::std::string Stats::snapshot_t::json() const {
+	::std::string out = "{";
+	bool first = true;
+	for ( const auto & [ id, counters ] : ids ) {
+		append( out, "%s\"%u\":{\"sent\":%" PRIu64 ",\"sent_bytes\":%" PRIu64 ",\"received\":%" PRIu64
+			",\"received_bytes\":%" PRIu64 ",\"serialize_ns\":%" PRIu64 ",\"deserialize_ns\":%" PRIu64
+			, first ? "" : ",", (unsigned) id, counters.sent, counters.sent_bytes, counters.received
+			, counters.received_bytes, counters.serialize_ns, counters.deserialize_ns );
+		out += ",\"receiver_ns\":";
+		out += counters.receiver_ns.json();
+		out += ",\"errors\":{";
+		bool first_error = true;
+		for ( usize i = 1; i < counters.errors.size(); ++i ) {
+			if ( counters.errors[i] == 0 )
+				continue;
+			append( out, "%s\"%s\":%" PRIu64, first_error ? "" : ",", utils::NAMES<Error>[i], counters.errors[i] );
+			first_error = false;
+		}
+		out += "}}";
+		first = false;
+	}
+	out += "}";
+	return out;
+}
+
+// IMPLEMENTATION lib::packets::Stats
+
+Stats::snapshot_t Stats::snapshot() const {
+	snapshot_t snapshot_;
+	snapshot_.ids.reserve( ids.size() );
+	for ( const auto & [ id, counters ] : ids )
+		snapshot_.ids.push_back({ id, counters });
+	return snapshot_;
+}
+
+void Stats::sent( id_type id, usize bytes ) noexcept {
+	auto & counters = ( *this )[id];
+	++counters.sent;
+	counters.sent_bytes += bytes;
+}
+
+void Stats::received( id_type id, usize bytes ) noexcept {
+	auto & counters = ( *this )[id];
+	++counters.received;
+	counters.received_bytes += bytes;
+}
+
+void Stats::serialized( id_type id, clock::time_point start ) noexcept {
+	( *this )[id].serialize_ns += elapsed_ns( start );
+}
+
+void Stats::deserialized( id_type id, clock::time_point start ) noexcept {
+	( *this )[id].deserialize_ns += elapsed_ns( start );
+}
+
+void Stats::receiver_returned( id_type id, clock::time_point start ) noexcept {
+	( *this )[id].receiver_ns.record( elapsed_ns( start ) );
+}
+
+void Stats::failed( id_type id, Error error ) noexcept {
+	++( *this )[id].errors[(usize) error];
+}
+
+Stats::counters_t & Stats::operator [] ( id_type id ) noexcept {
+	return ids.try_emplace( id ).first->second;
+}
+
+} // namespace lib::packets
@@ -0,0 +1,91 @@
+/* File: /lib/packets/stats.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__packets__stats__hpp
+#define CPPLIB__lib__packets__stats__hpp
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../lib/types.hpp"
+#include "../../lib/utils/histogram.hpp"
+
+#include "./packet.hpp"
+#include "./handler.hpp"
+
+namespace lib::packets {
+
+// DECLARATION lib::packets::Stats
+
+/** @brief Per packet id counters of a Handler, see Handler::attach_stats().
+ *  @details Bytes include headers (as they are on the wire). Serialize time is spent in
+ *  tag_serializeable::serialize() of sent packets, deserialize time - in reading received
+ *  payloads, receiver time - in Receiver/PayloadReceiver callbacks. Errors are accounted
+ *  to the id of the packet being sent or received, header errors and received ids without a
+ *  receiver go to id 0.
+ *  @note Not synchronized: update and snapshot() it on the thread of the handler.
+ */
+class Stats {
+public:
+	using id_type = Handler::id_type;
+	using Error = Handler::Error;
+	using histogram = utils::histogram;
+	using clock = ::std::chrono::steady_clock;
+
+	struct counters_t {
+		u64 sent = 0;
+		u64 sent_bytes = 0;
+		u64 received = 0;
+		u64 received_bytes = 0;
+		u64 serialize_ns = 0;
+		u64 deserialize_ns = 0;
+		histogram receiver_ns;
+		::std::array<u64, (usize) Error::count> errors {};
+	};
+
+	struct snapshot_t {
+		struct entry_t {
+			id_type id;
+			counters_t counters;
+		};
+
+		/// @return nullptr if nothing was accounted to `id`.
+		const counters_t * find( id_type id ) const noexcept;
+
+		/// @brief Human readable table, times are in nanoseconds.
+		::std::string text() const;
+		/// @brief `{"<id>":{"sent":..,"sent_bytes":..,..,"receiver_ns":{..},"errors":{"<error>":count,..}},..}`
+		::std::string json() const;
+
+		/// @brief Accounted ids in ascending order.
+		::std::vector<entry_t> ids;
+	};
+
+	Stats() noexcept = default;
+
+	snapshot_t snapshot() const;
+	void clear() noexcept { ids.clear(); }
+
+	void sent( id_type id, usize bytes ) noexcept;
+	void received( id_type id, usize bytes ) noexcept;
+	void serialized( id_type id, clock::time_point start ) noexcept;
+	void deserialized( id_type id, clock::time_point start ) noexcept;
+	void receiver_returned( id_type id, clock::time_point start ) noexcept;
+	void failed( id_type id, Error error ) noexcept;
+private:
+	counters_t & operator [] ( id_type id ) noexcept;
+
+	/// @brief Sparse: histogram is big (~8 KiB), only ids in use get counters.
+	::std::map<id_type, counters_t> ids;
+};
+
+} // namespace lib::packets
+
+#endif // CPPLIB__lib__packets__stats__hpp
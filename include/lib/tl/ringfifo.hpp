@@ -0,0 +1,254 @@
+/* File: /lib/tl/ringfifo.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__tl__ringfifo__hpp
+#define CPPLIB__lib__tl__ringfifo__hpp
+
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <cpp/lib_concepts>
+#include <cpp/lib_debug>
+
+#include "../../lib/types.hpp"
+
+namespace lib::tl {
+
+// DECLARATION lib::tl::ringfifo<>
+
+/**
+ *            ,- segment( N ) -,                  ,---- segment( 0 ) ----,
+ * storage   [..................|. . . . . . . . .|......................]
+ *            \                  \               /                        \
+ *             0         (head + size) % capacity   head                  capacity()
+ *
+ * @brief Growable ring buffer with ::std::vector<>-like interface.
+ * @details Elements are addressed by logical index, where 0 is the oldest element.
+ * Appending to the back and consuming from the front are amortized O(1), the storage
+ * capacity is always a power of two. Data may wrap around the storage end, so it's
+ * accessible as up to two contiguous segments or as a single one after linearize().
+ */
+
+template< ::cpp::Trivial T >
+class ringfifo final {
+public:
+	using value_type		= T;
+	using size_type			= usize;
+	using reference			= T &;
+	using const_reference	= const T &;
+	using span_type			= ::std::span<T>;
+	using cspan_type		= ::std::span<const T>;
+
+	static constexpr size_type MIN_CAPACITY = 64;
+
+	ringfifo() = default;
+	explicit ringfifo( size_type capacity_ ) { reserve( capacity_ ); }
+
+	/// @name Capacity
+	/// @{
+	constexpr size_type size() const noexcept { return size_; }
+	constexpr size_type capacity() const noexcept { return storage.size(); }
+	constexpr bool empty() const noexcept { return size_ == 0; }
+	void reserve( size_type capacity_ );
+	void shrink_to_fit();
+	/// @}
+
+	/// @name Element access
+	/// @{
+	constexpr reference operator[]( size_type n ) noexcept
+		{ CPP_ASSERT( n < size_ ); return storage[ index( n ) ]; }
+	constexpr const_reference operator[]( size_type n ) const noexcept
+		{ CPP_ASSERT( n < size_ ); return storage[ index( n ) ]; }
+	constexpr reference front() noexcept { return (*this)[0]; }
+	constexpr reference back() noexcept { return (*this)[size_ - 1]; }
+
+	/** @brief Longest contiguous run of elements starting from logical index `offset`.
+	 *  @note Whole data is covered by at most two segments: segment( 0 ) and segment( segment( 0 ).size() ).
+	 */
+	constexpr span_type segment( size_type offset = 0 ) noexcept;
+	constexpr cspan_type segment( size_type offset = 0 ) const noexcept;
+
+	/** @brief Makes data contiguous (if it wraps) and returns it as a single span.
+	 *  @details Costs O(size()) only when data wraps, then data starts at the storage begin
+	 *  and doesn't wrap again until the back reaches the storage end.
+	 */
+	span_type linearize();
+
+	/// @brief Longest contiguous run of unused storage right after the last element.
+	constexpr span_type spare_segment() noexcept;
+	/// @}
+
+	/// @name Modifiers
+	/// @{
+	constexpr void clear() noexcept { head = size_ = 0; }
+	void resize( size_type count );
+	void push_back( const value_type & value ) { append({ &value, 1 }); }
+	void append( cspan_type values );
+	/// @brief Removes `count` elements from the front. O(1).
+	constexpr void consume( size_type count ) noexcept;
+	/// @brief Appends `count` elements already written into spare_segment(). O(1).
+	constexpr void commit( size_type count ) noexcept;
+	/// @}
+
+	/// @name Bulk access
+	/// @{
+	/// @brief Copies up to `values.size()` elements starting from logical index `offset`.
+	constexpr size_type copy( span_type values, size_type offset = 0 ) const noexcept;
+	/// @}
+private:
+	constexpr size_type index( size_type n ) const noexcept
+		{ return ( head + n ) & ( capacity() - 1 ); }
+	void grow( size_type min_capacity );
+	void relocate( size_type new_capacity );
+
+	::std::vector<T> storage;
+	size_type head = 0;
+	size_type size_ = 0;
+};
+
+// INLINES lib::tl::ringfifo<>
+
+template< ::cpp::Trivial T >
+inline void ringfifo<T>::reserve( size_type capacity_ ) {
+	if ( capacity_ > capacity() )
+		relocate( ::std::bit_ceil( ::std::max( capacity_, MIN_CAPACITY ) ) );
+}
+
+template< ::cpp::Trivial T >
+inline void ringfifo<T>::shrink_to_fit() {
+	const auto new_capacity = size_ == 0 ? 0 : ::std::bit_ceil( ::std::max( size_, MIN_CAPACITY ) );
+	if ( new_capacity < capacity() )
+		relocate( new_capacity );
+}
+
+template< ::cpp::Trivial T >
+inline constexpr typename ringfifo<T>::span_type ringfifo<T>::segment( size_type offset/* = 0*/ ) noexcept {
+	if ( offset >= size_ )
+		return {};
+	const auto first = index( offset );
+	return { &storage[first], ::std::min( size_ - offset, capacity() - first ) };
+}
+
+template< ::cpp::Trivial T >
+inline constexpr typename ringfifo<T>::cspan_type ringfifo<T>::segment( size_type offset/* = 0*/ ) const noexcept {
+	if ( offset >= size_ )
+		return {};
+	const auto first = index( offset );
+	return { &storage[first], ::std::min( size_ - offset, capacity() - first ) };
+}
+
+template< ::cpp::Trivial T >
+inline typename ringfifo<T>::span_type ringfifo<T>::linearize() {
+	if ( size_ == 0 )
+		return {};
+	if ( head + size_ > capacity() ) {
+		/// @note Only live elements move, O(size()): the head part goes down right after
+		///       the tail part, then both are swapped in place.
+		const auto head_part = capacity() - head;
+		const auto tail_part = size_ - head_part;
+		::std::memmove( &storage[tail_part], &storage[head], head_part * sizeof(value_type) );
+		::std::rotate( storage.begin(), storage.begin() + (isize) tail_part, storage.begin() + (isize) size_ );
+		head = 0;
+	}
+	return { &storage[head], size_ };
+}
+
+template< ::cpp::Trivial T >
+inline constexpr typename ringfifo<T>::span_type ringfifo<T>::spare_segment() noexcept {
+	if ( size_ == capacity() )
+		return {};
+	const auto first = index( size_ );
+	const auto last = first < head ? head : capacity();
+	return { &storage[first], last - first };
+}
+
+template< ::cpp::Trivial T >
+inline void ringfifo<T>::resize( size_type count ) {
+	if ( count <= size_ ) {
+		size_ = count;
+		return;
+	}
+	grow( count );
+	while ( size_ < count ) {
+		const auto first = index( size_ );
+		const auto chunk = ::std::min( count - size_, capacity() - first );
+		::std::fill_n( &storage[first], chunk, value_type{} );
+		size_ += chunk;
+	}
+}
+
+template< ::cpp::Trivial T >
+inline void ringfifo<T>::append( cspan_type values ) {
+	grow( size_ + values.size() );
+	while ( not values.empty() ) {
+		const auto first = index( size_ );
+		const auto chunk = ::std::min( values.size(), capacity() - first );
+		::std::memcpy( &storage[first], values.data(), chunk * sizeof(value_type) );
+		values = values.subspan( chunk );
+		size_ += chunk;
+	}
+}
+
+template< ::cpp::Trivial T >
+inline constexpr void ringfifo<T>::consume( size_type count ) noexcept {
+	CPP_ASSERT( count <= size_ );
+	if ( count >= size_ ) {
+		clear();
+		return;
+	}
+	head = index( count );
+	size_ -= count;
+}
+
+template< ::cpp::Trivial T >
+inline constexpr void ringfifo<T>::commit( size_type count ) noexcept {
+	CPP_ASSERT( count <= spare_segment().size() );
+	size_ += count;
+}
+
+template< ::cpp::Trivial T >
+inline constexpr typename ringfifo<T>::size_type ringfifo<T>::copy
+	( span_type values, size_type offset/* = 0*/ ) const noexcept
+{
+	size_type count = 0;
+	while ( count < values.size() ) {
+		const auto & chunk = segment( offset + count );
+		if ( chunk.empty() )
+			break;
+		const auto chunk_size = ::std::min( chunk.size(), values.size() - count );
+		::std::memcpy( &values[count], chunk.data(), chunk_size * sizeof(value_type) );
+		count += chunk_size;
+	}
+	return count;
+}
+
+template< ::cpp::Trivial T >
+inline void ringfifo<T>::grow( size_type min_capacity ) {
+	if ( min_capacity <= capacity() )
+		return;
+	relocate( ::std::bit_ceil( ::std::max( { min_capacity, capacity() * 2, MIN_CAPACITY } ) ) );
+}
+
+template< ::cpp::Trivial T >
+inline void ringfifo<T>::relocate( size_type new_capacity ) {
+	CPP_ASSERT( new_capacity >= size_ and ( new_capacity == 0 or ::std::has_single_bit( new_capacity ) ) );
+	::std::vector<T> new_storage( new_capacity );
+	const auto count = copy( new_storage );
+	CPP_ASSERT( count == size_ );
+	CPP_UNUSED( count );
+	storage = ::std::move( new_storage );
+	head = 0;
+}
+
+} // namespace lib::tl
+
+#endif // CPPLIB__lib__tl__ringfifo__hpp
@@ -0,0 +1,103 @@
+/* File: /lib/utils/histogram.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+
+#include <algorithm>
+
+#include "./histogram.hpp"
+
+namespace lib::utils {
+
+namespace {
+
+/// @note Single writer: plain load/store keeps updates cheap and snapshots race-free.
+inline void add( ::std::atomic<u64> & counter, u64 value ) noexcept {
+	counter.store( counter.load( ::std::memory_order_relaxed ) + value, ::std::memory_order_relaxed );
+}
+
+inline void copy( ::std::atomic<u64> & to, const ::std::atomic<u64> & from ) noexcept {
+	to.store( from.load( ::std::memory_order_relaxed ), ::std::memory_order_relaxed );
+}
+
+template< class...Args >
+void append( ::std::string & out, const char * format, Args...args ) {
+	char line[256];
+	const auto count = ::std::snprintf( line, sizeof( line ), format, args... );
+	out.append( line, (usize) ::std::clamp( count, 0, (int) sizeof( line ) - 1 ) );
+}
+
+} // namespace
+
+// IMPLEMENTATION lib::utils::histogram
+
+histogram & histogram::operator = ( const histogram & other ) noexcept {
+	for ( usize i = 0; i < BUCKETS; ++i )
+		copy( buckets[i], other.buckets[i] );
+	copy( count_, other.count_ );
+	copy( sum_, other.sum_ );
+	copy( min_, other.min_ );
+	copy( max_, other.max_ );
+	return *this;
+}
+
+void histogram::record( u64 value ) noexcept {
+	add( buckets[bucket( value )], 1 );
+	add( count_, 1 );
+	add( sum_, value );
+	if ( value < min_.load( ::std::memory_order_relaxed ) )
+		min_.store( value, ::std::memory_order_relaxed );
+	if ( value > max_.load( ::std::memory_order_relaxed ) )
+		max_.store( value, ::std::memory_order_relaxed );
+}
+
+void histogram::clear() noexcept {
+	for ( auto & bucket_ : buckets )
+		bucket_.store( 0, ::std::memory_order_relaxed );
+	count_.store( 0, ::std::memory_order_relaxed );
+	sum_.store( 0, ::std::memory_order_relaxed );
+	min_.store( ::std::numeric_limits<u64>::max(), ::std::memory_order_relaxed );
+	max_.store( 0, ::std::memory_order_relaxed );
+}
+
+u64 histogram::percentile( f64 quantile ) const noexcept {
+	const auto total = count();
+	if ( total == 0 )
+		return 0;
+	const auto target = ::std::max( (u64) ::std::ceil( ::std::clamp( quantile, 0.0, 1.0 ) * (f64) total ), 1_u64 );
+	u64 accumulated = 0;
+	for ( usize i = 0; i < BUCKETS; ++i ) {
+		accumulated += ( *this )[i];
+		if ( accumulated >= target )
+			return ::std::min( bucket_max( i ), max() );
+	}
+	return max();
+}
+
+::std::string histogram::json() const {
+	::std::string out;
+	append( out, "{\"count\":%" PRIu64 ",\"min\":%" PRIu64 ",\"mean\":%.1f,\"max\":%" PRIu64
+		, count(), min(), mean(), max() );
+	for ( const auto & percentile : PERCENTILES )
+		append( out, ",\"%s\":%" PRIu64, percentile.name, this->percentile( percentile.quantile ) );
+	out += ",\"buckets\":[";
+	bool first = true;
+	for ( usize i = 0; i < BUCKETS; ++i ) {
+		const auto count_ = ( *this )[i];
+		if ( count_ == 0 )
+			continue;
+		append( out, "%s[%" PRIu64 ",%" PRIu64 "]", first ? "" : ",", bucket_min( i ), count_ );
+		first = false;
+	}
+	out += "]}";
+	return out;
+}
+
+} // namespace lib::utils
@@ -0,0 +1,96 @@
+/* File: /lib/utils/histogram.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__lib__utils__histogram__hpp
+#define CPPLIB__lib__utils__histogram__hpp
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <string>
+
+#include "../../lib/types.hpp"
+#include "../../lib/literals.hpp"
+
+namespace lib::utils {
+
+// DECLARATION lib::utils::histogram
+
+/** @brief Log-linear histogram of u64 values (latency in nanoseconds).
+ *  Values below SUB_BUCKETS are exact, every other power of two range is split into
+ *  SUB_BUCKETS linear buckets, so relative error stays below 1 / SUB_BUCKETS.
+ */
+class histogram {
+public:
+	static constexpr usize SUB_BITS = 4;
+	static constexpr usize SUB_BUCKETS = 1_sz << SUB_BITS;
+	static constexpr usize BUCKETS = ( 64 - SUB_BITS + 1 ) * SUB_BUCKETS;
+	struct percentile_t {
+		const char * name;
+		f64 quantile;
+	};
+	/// @brief Percentiles reported by json() and text reports.
+	static constexpr percentile_t PERCENTILES[] =
+		{ { "p50", 0.5 }, { "p90", 0.9 }, { "p99", 0.99 }, { "p999", 0.999 } };
+
+	static constexpr usize bucket( u64 value ) noexcept;
+	static constexpr u64 bucket_min( usize index ) noexcept;
+	static constexpr u64 bucket_max( usize index ) noexcept;
+
+	histogram() noexcept = default;
+	histogram( const histogram & other ) noexcept { *this = other; }
+	histogram & operator = ( const histogram & other ) noexcept;
+
+	void record( u64 value ) noexcept;
+	void clear() noexcept;
+
+	u64 count() const noexcept { return count_.load( ::std::memory_order_relaxed ); }
+	u64 sum() const noexcept { return sum_.load( ::std::memory_order_relaxed ); }
+	u64 min() const noexcept { return count() == 0 ? 0 : min_.load( ::std::memory_order_relaxed ); }
+	u64 max() const noexcept { return max_.load( ::std::memory_order_relaxed ); }
+	f64 mean() const noexcept { return count() == 0 ? 0.0 : (f64) sum() / (f64) count(); }
+	/// @brief Upper bound of the bucket holding `quantile` (in [0, 1]) of recorded values.
+	u64 percentile( f64 quantile ) const noexcept;
+	u64 operator [] ( usize index ) const noexcept { return buckets[index].load( ::std::memory_order_relaxed ); }
+	/// @brief `{"count":..,"min":..,"mean":..,"max":..,"p50":..,..,"buckets":[[min,count],..]}`
+	::std::string json() const;
+private:
+	::std::array<::std::atomic<u64>, BUCKETS> buckets {};
+	::std::atomic<u64> count_ {0};
+	::std::atomic<u64> sum_ {0};
+	::std::atomic<u64> min_ {::std::numeric_limits<u64>::max()};
+	::std::atomic<u64> max_ {0};
+};
+
+// INLINES lib::utils::histogram
+
+inline constexpr usize histogram::bucket( u64 value ) noexcept {
+	if ( value < SUB_BUCKETS )
+		return (usize) value;
+	const auto exponent = (usize) ::std::bit_width( value ) - 1;
+	const auto range = exponent - SUB_BITS + 1;
+	return range * SUB_BUCKETS + (usize)( value >> ( exponent - SUB_BITS ) ) - SUB_BUCKETS;
+}
+
+inline constexpr u64 histogram::bucket_min( usize index ) noexcept {
+	if ( index < SUB_BUCKETS )
+		return index;
+	const auto range = index / SUB_BUCKETS;
+	return ( SUB_BUCKETS + index % SUB_BUCKETS ) << ( range - 1 );
+}
+
+inline constexpr u64 histogram::bucket_max( usize index ) noexcept {
+	if ( index < SUB_BUCKETS )
+		return index;
+	const auto range = index / SUB_BUCKETS;
+	return bucket_min( index ) + ( ( 1_u64 << ( range - 1 ) ) - 1 );
+}
+
+} // namespace lib::utils
+
+#endif // CPPLIB__lib__utils__histogram__hpp
@@ -0,0 +1,493 @@
+/* File: /test/lib/data/serialize.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <array>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+#include <lib/cstring.hpp>
+#include <lib/data/serialize.hpp>
+#include <lib/data/chunked.hpp>
+#include <lib/data/arena.hpp>
+#include <lib/impl/serialize/std_contiguous_container.hpp>
+#include <lib/impl/serialize/ptr.hpp>
+#include <lib/impl/serialize/varint.hpp>
+#include <lib/data/fields.hpp>
+
+#include <lib/impl/stream/data.hpp>
+#include <lib/impl/stream/fifo.hpp>
+#include <lib/impl/stream/metered.hpp>
+
+#include "./serialize.hpp"
+
+namespace test::lib::data {
+
+namespace {
+
+/// @brief Stream which can't peek(), like some sockets and decorators.
+class NoPeekStream final
+	: public ::lib::data::rwstream_t
+{
+public:
+	explicit NoPeekStream( ::lib::data::rwstream_t & stream ) : stream{ stream } {}
+	::lib::data::result_t read( const ::lib::data::buffer_t & buffer ) override { return stream.read( buffer ); }
+	::lib::data::result_t read_size() override { return stream.read_size(); }
+	::std::error_condition read_error() const override { return stream.read_error(); }
+	::lib::data::result_t write( const ::lib::data::cbuffer_t & buffer ) override { return stream.write( buffer ); }
+	::lib::data::result_t write_size() override { return stream.write_size(); }
+	::std::error_condition write_error() const override { return stream.write_error(); }
+	::std::error_condition error() const override { return stream.error(); }
+	bool flush() override { return stream.flush(); }
+	::lib::data::result_t size() override { return stream.size(); }
+private:
+	::lib::data::rwstream_t & stream;
+};
+
+/// @brief Counts allocations which went past the arena buffer.
+class counting_resource final
+	: public ::std::pmr::memory_resource
+{
+public:
+	::lib::usize allocations = 0;
+private:
+	void * do_allocate( ::std::size_t bytes, ::std::size_t alignment ) override {
+		++allocations;
+		return ::std::pmr::new_delete_resource()->allocate( bytes, alignment );
+	}
+	void do_deallocate( void * p, ::std::size_t bytes, ::std::size_t alignment ) override
+	{ ::std::pmr::new_delete_resource()->deallocate( p, bytes, alignment ); }
+	bool do_is_equal( const ::std::pmr::memory_resource & other ) const noexcept override
+	{ return this == &other; }
+};
+
+struct Record
+	: ::lib::tag_serializeable_fields<Record>
+{
+	::lib::u32 id = 0;
+	::lib::u16 flags = 0;
+	::std::vector<::lib::u8> payload;
+	::lib::u64 timestamp = 0;
+	::lib::u8 kind = 0;
+	static constexpr auto fields = ::std::tuple {
+		&Record::id, &Record::flags, &Record::payload, &Record::timestamp, &Record::kind };
+};
+
+} // namespace
+
+void Serialize::test_execute() noexcept/* override*/ {
+	CPPLIB__TEST__SUBTEST( trivial_pack );
+	CPPLIB__TEST__SUBTEST( mixed_pack );
+	CPPLIB__TEST__SUBTEST( varint );
+	CPPLIB__TEST__SUBTEST( view );
+	CPPLIB__TEST__SUBTEST( chunked );
+	CPPLIB__TEST__SUBTEST( arena );
+	CPPLIB__TEST__SUBTEST( fields );
+}
+
+void Serialize::trivial_pack() noexcept {
+	using namespace ::lib;
+	using Op = ::lib::stream::impl::metered::Op;
+
+	static_assert( ::lib::data::TrivialPack<u32, u16, u8, f64, i64> );
+	static_assert( not ::lib::data::TrivialPack<u32, const char *> );
+	static_assert( ::lib::data::trivial_size_v<u32, u16, u8, f64, i64> == 23 );
+
+	::lib::stream::impl::fifo fifo;
+	::lib::stream::impl::metered stream {&fifo};
+
+	const u32 a = 0xDEADBEEF;
+	const u16 b = 0x1234;
+	const u8 c = 0x56;
+	const f64 d = 3.25;
+	const i64 e = -7;
+	CPPLIB__TEST__EQ( ::lib::data::serialized_size( stream, a, b, c, d, e ), 23_sz );
+	CPPLIB__TEST__EQ( ::lib::data::serialize( stream, a, b, c, d, e ), 23_sz );
+	// Whole pack goes to the stream with a single call.
+	CPPLIB__TEST__EQ( stream[Op::WRITE].calls.load(), 1_u64 );
+
+	u32 a_ = 0;
+	u16 b_ = 0;
+	u8 c_ = 0;
+	f64 d_ = 0;
+	i64 e_ = 0;
+	CPPLIB__TEST__TRUE( ::lib::data::can_deserialize( stream, a_, b_, c_, d_, e_ ) );
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( stream, a_, b_, c_, d_, e_ ), 23_sz );
+	CPPLIB__TEST__EQ( stream[Op::READ].calls.load(), 1_u64 );
+	CPPLIB__TEST__EQ( a_, a );
+	CPPLIB__TEST__EQ( b_, b );
+	CPPLIB__TEST__EQ( c_, c );
+	CPPLIB__TEST__EQ( d_, d );
+	CPPLIB__TEST__EQ( e_, e );
+	CPPLIB__TEST__FALSE( ::lib::data::can_deserialize( stream, a_, b_ ) );
+
+	// Short read assigns complete values only.
+	CPPLIB__TEST__EQ( ::lib::data::serialize( stream, a, b ), 6_sz );
+	CPPLIB__TEST__EQ( ::lib::data::serialize( stream, c ), 1_sz );
+	a_ = 0;
+	b_ = 0;
+	c_ = 0;
+	d_ = 0;
+	CPPLIB__TEST__FALSE( ::lib::data::can_deserialize( stream, a_, b_, c_, d_ ) );
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( stream, a_, b_, d_ ), 7_sz );
+	CPPLIB__TEST__EQ( a_, a );
+	CPPLIB__TEST__EQ( b_, b );
+	CPPLIB__TEST__EQ( d_, 0.0 );
+}
+
+void Serialize::mixed_pack() noexcept {
+	using namespace ::lib;
+
+	::lib::stream::impl::fifo stream;
+	const u32 id = 42;
+	const ::std::vector<u16> values { 1, 2, 3 };
+	const ::std::string name = "mixed";
+	const auto & size = ::lib::data::serialized_size( stream, id, values, name );
+	CPPLIB__TEST__EQ( size, 4_sz + ( 4 + 3 * 2 ) + ( 4 + 5 ) );
+	CPPLIB__TEST__EQ( ::lib::data::serialize( stream, id, values, name ), size );
+
+	u32 id_ = 0;
+	::std::vector<u16> values_;
+	::std::string name_;
+	CPPLIB__TEST__TRUE( ::lib::data::can_deserialize( stream, id_ ) );
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( stream, id_, values_, name_ ), size );
+	CPPLIB__TEST__EQ( id_, id );
+	CPPLIB__TEST__EQ( values_, values );
+	CPPLIB__TEST__EQ( name_, name );
+}
+
+void Serialize::varint() noexcept {
+	using namespace ::lib;
+	using leb128 = ::lib::data::leb128;
+
+	// Padding makes decoder take its 8 bytes path.
+	u8 bytes[leb128::MAX_SIZE + 8] = {};
+	const u64 values[] = { 0, 1, 127, 128, 300, 16383, 16384
+		, ( 1_u64 << 56 ) - 1, 1_u64 << 56, ::std::numeric_limits<u64>::max() };
+	for ( const auto value : values ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		const auto size = leb128::encode( value, bytes );
+		CPPLIB__TEST__EQ( size, leb128::size( value ) );
+		u64 decoded = 0;
+		CPPLIB__TEST__EQ( leb128::decode( bytes, size, decoded ), (isize) size );
+		CPPLIB__TEST__EQ( decoded, value );
+		decoded = 0;
+		CPPLIB__TEST__EQ( leb128::decode( bytes, sizeof(bytes), decoded ), (isize) size );
+		CPPLIB__TEST__EQ( decoded, value );
+		CPPLIB__TEST__EQ( leb128::decode( bytes, size - 1, decoded ), (isize) 0 );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__EQ( leb128::size( 127 ), 1_sz );
+	CPPLIB__TEST__EQ( leb128::size( 128 ), 2_sz );
+	CPPLIB__TEST__EQ( leb128::size( ::std::numeric_limits<u64>::max() ), leb128::MAX_SIZE );
+
+	CPPLIB__TEST__EQ( leb128::zigzag( 0 ), 0_u64 );
+	CPPLIB__TEST__EQ( leb128::zigzag( -1 ), 1_u64 );
+	CPPLIB__TEST__EQ( leb128::zigzag( 1 ), 2_u64 );
+	CPPLIB__TEST__EQ( leb128::unzigzag( leb128::zigzag( ::std::numeric_limits<i64>::min() ) ), ::std::numeric_limits<i64>::min() );
+
+	// Varint longer than 10 bytes, 10th byte out of u64 range.
+	u8 malformed[leb128::MAX_SIZE + 1];
+	::std::fill( ::std::begin( malformed ), ::std::end( malformed ), (u8) 0x80 );
+	u64 decoded = 0;
+	CPPLIB__TEST__EQ( leb128::decode( malformed, sizeof(malformed), decoded ), (isize) -1 );
+	malformed[leb128::MAX_SIZE - 1] = 0x02;
+	CPPLIB__TEST__EQ( leb128::decode( malformed, sizeof(malformed), decoded ), (isize) -1 );
+
+	::lib::stream::impl::fifo stream;
+	const u32 id = 5;
+	const i32 delta = -3;
+	const ::std::vector<u16> numbers { 1, 2, 3 };
+	const ::std::string name = "varint";
+	const ::std::vector<::std::string> tags { "a", "bc" };
+	const auto & size = ::lib::data::serialized_size( stream
+		, ::lib::data::varint{id}, ::lib::data::varint{delta}, ::lib::data::varint{numbers}
+		, ::lib::data::varint{name}, ::lib::data::varint{tags} );
+	CPPLIB__TEST__EQ( size, 1_sz + 1 + ( 1 + 3 * 2 ) + ( 1 + 6 ) + ( 1 + ( 4 + 1 ) + ( 4 + 2 ) ) );
+	CPPLIB__TEST__EQ( ::lib::data::serialize( stream
+		, ::lib::data::varint{id}, ::lib::data::varint{delta}, ::lib::data::varint{numbers}
+		, ::lib::data::varint{name}, ::lib::data::varint{tags} ), size );
+
+	u32 id_ = 0;
+	i32 delta_ = 0;
+	::std::vector<u16> numbers_;
+	::std::string name_;
+	::std::vector<::std::string> tags_;
+	::lib::data::varint id_varint {id_};
+	::lib::data::varint delta_varint {delta_};
+	::lib::data::varint numbers_varint {numbers_};
+	::lib::data::varint name_varint {name_};
+	::lib::data::varint tags_varint {tags_};
+	CPPLIB__TEST__TRUE( ::lib::data::can_deserialize( stream, id_varint ) );
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( stream, id_varint, delta_varint, numbers_varint, name_varint, tags_varint ), size );
+	CPPLIB__TEST__EQ( id_, id );
+	CPPLIB__TEST__EQ( delta_, delta );
+	CPPLIB__TEST__EQ( numbers_, numbers );
+	CPPLIB__TEST__EQ( name_, name );
+	CPPLIB__TEST__EQ( tags_, tags );
+
+	// Value out of range of the destination type.
+	const u32 big = 300;
+	u8 small = 0;
+	CPPLIB__TEST__EQ( ::lib::data::serialize( stream, ::lib::data::varint{big} ), 2_sz );
+	CPPLIB__TEST__TRUE( ::lib::data::deserialize( stream, ::lib::data::varint{small} ).failed() );
+
+	// Incomplete varint is not consumed.
+	::lib::stream::impl::fifo partial;
+	const u8 first = 0x80;
+	CPPLIB__TEST__EQ( partial.write({ &first, 1 }), 1_sz );
+	CPPLIB__TEST__FALSE( ::lib::data::can_deserialize( partial, ::lib::data::varint{id_} ) );
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( partial, ::lib::data::varint{id_} ), 0_sz );
+	CPPLIB__TEST__EQ( partial.read_size(), 1_sz );
+
+	// Stream without peek(): read byte by byte, a cut varint is an error, not a partial count.
+	::lib::stream::impl::fifo fifo;
+	NoPeekStream no_peek {fifo};
+	u32 id_read = 0;
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( no_peek, ::lib::data::varint{id_read} ), 0_sz );
+	CPPLIB__TEST__EQ( ::lib::data::serialize( fifo, ::lib::data::varint{big}, ::lib::data::varint{name} ), 2_sz + 1 + name.size() );
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( no_peek, ::lib::data::varint{id_read} ), 2_sz );
+	CPPLIB__TEST__EQ( id_read, big );
+	name_.clear();
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( no_peek, ::lib::data::varint{name_} ), 1_sz + name.size() );
+	CPPLIB__TEST__EQ( name_, name );
+	CPPLIB__TEST__EQ( fifo.write({ &first, 1 }), 1_sz );
+	id_read = 7;
+	const auto & cut = ::lib::data::deserialize( no_peek, ::lib::data::varint{id_read} );
+	CPPLIB__TEST__TRUE( cut.failed() );
+	CPPLIB__TEST__TRUE( cut.error() == ::lib::make_error_empty_data() );
+	CPPLIB__TEST__EQ( id_read, 7 );
+	const u8 overlong[12] { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01 };
+	CPPLIB__TEST__EQ( fifo.write({ overlong, sizeof(overlong) }), sizeof(overlong) );
+	CPPLIB__TEST__TRUE( ::lib::data::deserialize( no_peek, ::lib::data::varint{id_read} ).failed() );
+}
+
+void Serialize::view() noexcept {
+	using namespace ::lib;
+
+	static_assert( ::lib::data::ContiguousView<::std::span<const u8>> );
+	static_assert( ::lib::data::ContiguousView<cstring> );
+	static_assert( not ::lib::data::ContiguousView<::std::span<u8>> );
+	static_assert( not ::lib::data::ContiguousView<::std::string> );
+
+	::std::array<u8, 64> storage {};
+	::lib::stream::impl::data stream {::lib::data::buffer_t {storage}};
+	const ::std::vector<u8> bytes { 1, 2, 3, 4, 5 };
+	const ::std::string text = "zero-copy";
+	const auto & size = ::lib::data::serialize( stream, bytes, text );
+	CPPLIB__TEST__EQ( size, ( 4_sz + 5 ) + ( 4 + 9 ) );
+
+	// Views alias memory of the stream.
+	::std::span<const u8> bytes_;
+	cstring text_;
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( stream, bytes_, text_ ), size );
+	CPPLIB__TEST__EQ( bytes_.data(), storage.data() + 4 );
+	CPPLIB__TEST__TRUE( ::std::equal( bytes_.begin(), bytes_.end(), bytes.begin(), bytes.end() ) );
+	CPPLIB__TEST__EQ( (const u8 *) text_.data(), storage.data() + 4 + 5 + 4 );
+	CPPLIB__TEST__EQ( text_, text );
+	CPPLIB__TEST__EQ( stream.read_pos(), size );
+
+	// Incomplete payload is left in the stream.
+	::lib::stream::impl::fifo fifo;
+	CPPLIB__TEST__EQ( ::lib::data::serialize( fifo, text ), 4_sz + 9 );
+	CPPLIB__TEST__EQ( fifo.write_pos( 4 + 4 ), 8_sz );
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( fifo, text_ ), 0_sz );
+	CPPLIB__TEST__EQ( fifo.read_size(), 8_sz );
+	CPPLIB__TEST__EQ( fifo.write({ text.data() + 4, 5 }), 5_sz );
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( fifo, text_ ), 4_sz + 9 );
+	CPPLIB__TEST__EQ( text_, text );
+	CPPLIB__TEST__TRUE( fifo.read_flush() );
+	CPPLIB__TEST__EQ( fifo.read_size(), 0_sz );
+}
+
+void Serialize::chunked() noexcept {
+	using namespace ::lib;
+	static constexpr usize CHUNK = 1000;
+
+	::std::vector<u8> blob( 100 * 1000 + 7 );
+	for ( usize i = 0; i < blob.size(); ++i )
+		blob[i] = (u8) i;
+	const u32 id = 42;
+	const ::std::vector<u16> empty;
+
+	// Chunked writer, regular deserialize() on the other side.
+	::lib::stream::impl::fifo stream;
+	::lib::data::chunked_t writer;
+	writer.serialize( id, blob, empty );
+	usize chunks = 0;
+	while ( not writer.done() ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__EQ( writer.write( stream, CHUNK ), ::std::min( CHUNK, 4 + 4 + blob.size() + 4 - chunks * CHUNK ) );
+		++chunks;
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__EQ( chunks, ( 4 + 4 + blob.size() + 4 + CHUNK - 1 ) / CHUNK );
+	CPPLIB__TEST__EQ( writer.transferred(), ::lib::data::serialized_size( stream, id, blob, empty ).value() );
+
+	u32 id_ = 0;
+	::std::vector<u8> blob_;
+	::std::vector<u16> empty_ { 1 };
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( stream, id_, blob_, empty_ ), writer.transferred() );
+	CPPLIB__TEST__EQ( id_, id );
+	CPPLIB__TEST__EQ( blob_, blob );
+	CPPLIB__TEST__TRUE( empty_.empty() );
+
+	// Regular serialize(), chunked reader gets data as it arrives.
+	::lib::stream::impl::fifo source;
+	CPPLIB__TEST__EQ( ::lib::data::serialize( source, id, blob, empty ), writer.transferred() );
+	::lib::data::chunked_t reader;
+	id_ = 0;
+	blob_.clear();
+	empty_ = { 1 };
+	reader.deserialize( id_, blob_, empty_ );
+	u8 piece[777];
+	while ( not reader.done() ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		const auto & piece_read = source.read({ piece, sizeof(piece) });
+		CPPLIB__TEST__TRUE( piece_read.success() );
+		CPPLIB__TEST__EQ( stream.write({ piece, piece_read.value() }), piece_read );
+		// Reader holds no more than a piece in the stream.
+		CPPLIB__TEST__TRUE( reader.read( stream ).success() );
+		CPPLIB__TEST__EQ( stream.read_size(), 0_sz );
+		CPPLIB__TEST__TRUE( stream.read_flush() );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__EQ( reader.transferred(), writer.transferred() );
+	CPPLIB__TEST__EQ( id_, id );
+	CPPLIB__TEST__EQ( blob_, blob );
+	CPPLIB__TEST__TRUE( empty_.empty() );
+
+	// Forged container length: the container isn't resized past the budget.
+	const u32 forged_length = 0xffffffff;
+	::lib::stream::impl::fifo forged;
+	CPPLIB__TEST__EQ( ::lib::data::serialize( forged, id, forged_length, blob ), 4 + 4 + 4 + blob.size() );
+	blob_.clear();
+	reader.deserialize( id_, blob_ );
+	CPPLIB__TEST__TRUE( reader.read( forged, CHUNK, 4 + 4 + 4 + blob.size() ).failed() );
+	CPPLIB__TEST__TRUE( blob_.empty() );
+	CPPLIB__TEST__FALSE( reader.done() );
+
+	// Length within the budget is fine.
+	const u32 length = 16;
+	::lib::stream::impl::fifo fits;
+	CPPLIB__TEST__EQ( ::lib::data::serialize( fits, id, length ), 4_sz + 4 );
+	CPPLIB__TEST__EQ( fits.write({ blob.data(), length }), (usize) length );
+	reader.deserialize( id_, blob_ );
+	CPPLIB__TEST__EQ( reader.read( fits, CHUNK, 4 + 4 + length ), 4_sz + 4 + length );
+	CPPLIB__TEST__TRUE( reader.done() );
+	CPPLIB__TEST__EQ( blob_.size(), (usize) length );
+}
+
+void Serialize::arena() noexcept {
+	using namespace ::lib;
+
+	::lib::stream::impl::fifo stream;
+	const ::std::vector<::std::string> names { "a", "bb", ::std::string( 100, 'c' ) };
+	const u32 id = 42;
+	CPPLIB__TEST__TRUE( ::lib::data::serialize( stream, names, id, names, id ).success() );
+
+	counting_resource upstream;
+	::lib::data::arena_t arena {4096, &upstream};
+	::std::pmr::vector<::std::pmr::string> names_;
+	::lib::SPtr<u32> id_;
+	CPPLIB__TEST__TRUE( ::lib::data::deserialize( arena.context(), stream, names_, id_ ).success() );
+	CPPLIB__TEST__EQ( names_.size(), names.size() );
+	for ( usize i = 0; i < names.size(); ++i )
+		CPPLIB__TEST__EQ( ::std::string_view {names_[i]}, names[i] );
+	CPPLIB__TEST__TRUE( id_ );
+	CPPLIB__TEST__EQ( *id_, id );
+	// Nested containers and pointee come from the arena.
+	CPPLIB__TEST__EQ( names_.get_allocator().resource(), arena.resource() );
+	CPPLIB__TEST__EQ( names_[2].get_allocator().resource(), arena.resource() );
+	CPPLIB__TEST__EQ( upstream.allocations, 0_sz );
+
+	// Next packet reuses the same memory.
+	id_.reset();
+	arena.reset();
+	CPPLIB__TEST__TRUE( ::lib::data::deserialize( arena.context(), stream, names_, id_ ).success() );
+	CPPLIB__TEST__EQ( ::std::string_view {names_[2]}, names[2] );
+	CPPLIB__TEST__EQ( *id_, id );
+	CPPLIB__TEST__EQ( upstream.allocations, 0_sz );
+	id_.reset();
+	arena.reset();
+	// Containers outside of the arena are left empty, they don't reference its memory.
+	CPPLIB__TEST__TRUE( names_.empty() );
+	CPPLIB__TEST__EQ( names_.get_allocator().resource(), ::std::pmr::get_default_resource() );
+
+	// Foreign context isn't taken for an arena.
+	CPPLIB__TEST__TRUE( ::lib::data::serialize( stream, names ).success() );
+	CPPLIB__TEST__EQ( ::lib::data::arena_t::from( &upstream ), nullptr );
+	CPPLIB__TEST__EQ( ::lib::data::arena_t::from( arena.context() ), &arena );
+	CPPLIB__TEST__TRUE( ::lib::data::deserialize( &upstream, stream, names_ ).success() );
+	CPPLIB__TEST__EQ( names_.get_allocator().resource(), ::std::pmr::get_default_resource() );
+	CPPLIB__TEST__EQ( ::std::string_view {names_[2]}, names[2] );
+
+	// Without context containers use their own allocator.
+	CPPLIB__TEST__TRUE( ::lib::data::serialize( stream, names ).success() );
+	::std::pmr::vector<::std::pmr::string> heap_names;
+	CPPLIB__TEST__TRUE( ::lib::data::deserialize( nullptr, stream, heap_names ).success() );
+	CPPLIB__TEST__EQ( heap_names.get_allocator().resource(), ::std::pmr::get_default_resource() );
+	CPPLIB__TEST__EQ( ::std::string_view {heap_names[1]}, names[1] );
+}
+
+void Serialize::fields() noexcept {
+	using namespace ::lib;
+	using Op = ::lib::stream::impl::metered::Op;
+
+	static_assert( ::lib::data::detail::trivial_run<u32, u16, ::std::vector<u8>, u64, u8>( 0 ) == 2 );
+	static_assert( ::lib::data::detail::trivial_run<u32, u16, ::std::vector<u8>, u64, u8>( 2 ) == 0 );
+	static_assert( ::lib::data::detail::trivial_run<u32, u16, ::std::vector<u8>, u64, u8>( 3 ) == 2 );
+
+	::lib::stream::impl::fifo fifo;
+	::lib::stream::impl::metered stream {&fifo};
+
+	Record record;
+	record.id = 42;
+	record.flags = 0x8001;
+	record.payload = { 1, 2, 3, 4, 5 };
+	record.timestamp = 0x0123456789ABCDEF;
+	record.kind = 7;
+	const tag_serializeable & packet = record;
+	const auto size = 4_sz + 2 + ( 4 + 5 ) + 8 + 1;
+	CPPLIB__TEST__EQ( packet.serialized_size( stream ), size );
+	CPPLIB__TEST__EQ( packet.serialize( stream ), size );
+	// Trivial runs (id, flags) and (timestamp, kind) take a write each, payload takes two.
+	CPPLIB__TEST__EQ( stream[Op::WRITE].calls.load(), 4_u64 );
+	// Same wire format as serialize() of the fields.
+	CPPLIB__TEST__EQ( ::lib::data::serialize( fifo, record.id, record.flags, record.payload, record.timestamp, record.kind ), size );
+
+	Record record_;
+	tag_serializeable & packet_ = record_;
+	CPPLIB__TEST__TRUE( packet_.can_deserialize( stream ) );
+	CPPLIB__TEST__EQ( packet_.deserialize( stream ), size );
+	CPPLIB__TEST__EQ( stream[Op::READ].calls.load(), 4_u64 );
+	CPPLIB__TEST__EQ( record_.id, record.id );
+	CPPLIB__TEST__EQ( record_.flags, record.flags );
+	CPPLIB__TEST__EQ( record_.payload, record.payload );
+	CPPLIB__TEST__EQ( record_.timestamp, record.timestamp );
+	CPPLIB__TEST__EQ( record_.kind, record.kind );
+
+	record_ = {};
+	CPPLIB__TEST__EQ( packet_.deserialize( nullptr, stream ), size );
+	CPPLIB__TEST__EQ( record_.payload, record.payload );
+	CPPLIB__TEST__EQ( record_.kind, record.kind );
+
+	// Short read stops at the incomplete run.
+	CPPLIB__TEST__EQ( ::lib::data::serialize( stream, record.id ), 4_sz );
+	record_ = {};
+	CPPLIB__TEST__EQ( packet_.deserialize( stream ), 4_sz );
+	CPPLIB__TEST__EQ( record_.id, record.id );
+	CPPLIB__TEST__EQ( record_.flags, 0 );
+	CPPLIB__TEST__EQ( stream[Op::READ].calls.load(), 4_u64 * 2 + 1 );
+}
+
+} // namespace test::lib::data
@@ -0,0 +1,34 @@
+/* File: /test/lib/data/serialize.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__test__lib__data__serialize__hpp
+#define CPPLIB__test__lib__data__serialize__hpp
+
+#include <lib/test/unit.hpp>
+
+namespace test::lib::data {
+
+class Serialize final
+	: public ::lib::test::IUnit
+{
+public:
+	Serialize() noexcept : IUnit {"Serialize"} {}
+private:
+	void test_execute() noexcept override;
+
+	void trivial_pack() noexcept;
+	void mixed_pack() noexcept;
+	void varint() noexcept;
+	void view() noexcept;
+	void chunked() noexcept;
+	void arena() noexcept;
+	void fields() noexcept;
+};
+
+} // namespace test::lib::data
+
+#endif // CPPLIB__test__lib__data__serialize__hpp
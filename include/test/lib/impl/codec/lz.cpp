@@ -0,0 +1,95 @@
+/* File: /test/lib/impl/codec/lz.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <string>
+#include <vector>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+
+#include <lib/impl/codec/lz.hpp>
+
+#include "./lz.hpp"
+
+namespace test::lib::codec::impl {
+
+void Lz::test_execute() noexcept/* override*/ {
+	using namespace ::lib;
+	using ::lib::codec::impl::lz;
+	using bytes = ::std::vector<u8>;
+
+	const auto to_bytes = []( data::cbuffer_t buffer ) { return bytes( buffer.begin(), buffer.end() ); };
+
+	bytes text;
+	for ( usize i = 0; text.size() < 3 * lz::BLOCK_SIZE + 1000; ++i ) {
+		const auto line = "{\"id\":" + ::std::to_string( i ) + ",\"state\":\"sync\",\"pos\":[" + ::std::to_string( i * 3 % 17 ) + ",0,1]}\n";
+		text.insert( text.end(), line.begin(), line.end() );
+	}
+	bytes noise( 100000 );
+	u32 seed = 313373;
+	for ( auto & value : noise ) {
+		seed = seed * 1664525u + 1013904223u;
+		value = (u8)( seed >> 24 );
+	}
+	const bytes run( 70000, 'x' );
+	const bytes PAYLOADS[] = { {}, { 'a' }, to_bytes( data::cbuffer_t {text}.first( 100 ) ), text, noise, run };
+
+	lz codec;
+	for ( const auto & plain : PAYLOADS ) {
+		CPPLIB__TEST__LOOP_NEXT();
+
+		CPPLIB__TEST__EQ( codec.encode( plain ), plain.size() );
+		const auto coded = to_bytes( codec.read_cbuffer( true ) );
+		CPPLIB__TEST__LE( coded.size(), lz::Bound( plain.size() ) + 8 * ( plain.size() / lz::BLOCK_SIZE + 1 ) );
+		if ( &plain == &text or &plain == &run )
+			CPPLIB__TEST__LT( coded.size() * 4, plain.size() );
+
+		CPPLIB__TEST__EQ( codec.decode( coded ), coded.size() );
+		CPPLIB__TEST__TRUE( codec.read_flush() );
+		CPPLIB__TEST__TRUE( to_bytes( codec.read_cbuffer() ) == plain );
+
+		// Coded stream may be split at any byte.
+		codec.reset( lz::Mode::DECODE );
+		for ( usize offset = 0; offset < coded.size(); offset += 4093 )
+			CPPLIB__TEST__EQ( codec.decode( data::cbuffer_t {coded}.subspan( offset, ::std::min( 4093_sz, coded.size() - offset ) ) ), ::std::min( 4093_sz, coded.size() - offset ) );
+		CPPLIB__TEST__TRUE( codec.read_flush() );
+		CPPLIB__TEST__TRUE( to_bytes( codec.read_cbuffer() ) == plain );
+
+		// Plain stream may be split too.
+		codec.reset( lz::Mode::ENCODE );
+		for ( usize offset = 0; offset < plain.size(); offset += 777 )
+			CPP_UNUSED( codec.encode( data::cbuffer_t {plain}.subspan( offset, ::std::min( 777_sz, plain.size() - offset ) ) ) );
+		const auto chunked = to_bytes( codec.read_cbuffer( true ) );
+		CPPLIB__TEST__EQ( codec.decode( chunked ), chunked.size() );
+		CPPLIB__TEST__TRUE( to_bytes( codec.read_cbuffer( true ) ) == plain );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+
+	// LZ4 block: literals "ab" and match (offset 2, length 6), then empty last literals.
+	const bytes BLOCK = { 8, 6 << 1, 0x22, 'a', 'b', 0x02, 0x00, 0x00 };
+	const ::std::string ABABABAB = "abababab";
+	codec.reset( lz::Mode::DECODE );
+	CPPLIB__TEST__EQ( codec.decode( BLOCK ), BLOCK.size() );
+	CPPLIB__TEST__TRUE( to_bytes( codec.read_cbuffer() ) == to_bytes({ (const u8*) ABABABAB.data(), ABABABAB.size() }) );
+
+	// Incomplete block is not flushed.
+	codec.reset( lz::Mode::DECODE );
+	CPPLIB__TEST__EQ( codec.decode( data::cbuffer_t {BLOCK}.first( 5 ) ), 5_sz );
+	CPPLIB__TEST__FALSE( codec.read_flush() );
+	CPPLIB__TEST__EQ( codec.read_size(), 0_sz );
+
+	// Corrupted data: offset beyond the decoded data.
+	bytes corrupted = BLOCK;
+	corrupted[5] = 0x03;
+	codec.reset( lz::Mode::DECODE );
+	CPPLIB__TEST__TRUE( codec.decode( corrupted ).failed() );
+	CPPLIB__TEST__TRUE( codec.decode_error() );
+	CPPLIB__TEST__FALSE( codec.read_flush() );
+}
+
+} // namespace test::lib::codec::impl
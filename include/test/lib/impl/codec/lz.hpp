@@ -0,0 +1,26 @@
+/* File: /test/lib/impl/codec/lz.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__test__lib__impl__codec__lz__hpp
+#define CPPLIB__test__lib__impl__codec__lz__hpp
+
+#include <lib/test/unit.hpp>
+
+namespace test::lib::codec::impl {
+
+class Lz final
+	: public ::lib::test::IUnit
+{
+public:
+	Lz() noexcept : IUnit {"Lz"} {}
+private:
+	void test_execute() noexcept override;
+};
+
+} // namespace test::lib::codec::impl
+
+#endif // CPPLIB__test__lib__impl__codec__lz__hpp
@@ -0,0 +1,130 @@
+/* File: /test/lib/impl/stream/buffer.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+
+#include <lib/system/error.hpp>
+#include <lib/impl/stream/buffer.hpp>
+#include <lib/impl/stream/fifo.hpp>
+
+#include "./buffer.hpp"
+
+namespace test::lib::stream::impl {
+
+namespace {
+
+/// @brief Stream which fails every write.
+class BrokenWriteStream final
+	: public ::lib::data::rwstream_t
+{
+public:
+	::lib::data::result_t read( const ::lib::data::buffer_t & ) override { return ::lib::usize {0}; }
+	::lib::data::result_t read_size() override { return ::lib::usize {0}; }
+	::std::error_condition read_error() const override { return ::lib::make_error_no_error(); }
+	::lib::data::result_t write( const ::lib::data::cbuffer_t & ) override
+		{ return ::lib::data::result_t {write_error()}; }
+	::lib::data::result_t write_size() override { return ::lib::usize {1024}; }
+	::std::error_condition write_error() const override { return ::lib::make_error_bad_data(); }
+	::std::error_condition error() const override { return write_error(); }
+	bool flush() override { return false; }
+	::lib::data::result_t size() override { return ::lib::usize {0}; }
+};
+
+} // namespace
+
+void Buffer::test_execute() noexcept/* override*/ {
+	using namespace ::lib;
+
+	::std::array<u8, 256> data;
+	::std::iota( data.begin(), data.end(), (u8) 0 );
+	::std::array<u8, 512> copy {};
+
+	::lib::stream::impl::fifo fifo;
+	::lib::stream::impl::buffer buffer {128};
+	buffer.reset( &fifo );
+	CPPLIB__TEST__EQ( buffer.capacity(), 128 );
+
+	// Small writes are staged.
+	CPPLIB__TEST__EQ( buffer.write({ data.data(), 100 }), 100_sz );
+	CPPLIB__TEST__EQ( buffer.write_size(), 28_sz );
+	CPPLIB__TEST__EQ( fifo.read_size(), 0_sz );
+	CPPLIB__TEST__TRUE( buffer.write_flush() );
+	CPPLIB__TEST__EQ( buffer.write_pos(), 0_sz );
+	CPPLIB__TEST__EQ( fifo.read_size(), 100_sz );
+
+	// Read data wraps around the ring end.
+	CPPLIB__TEST__TRUE( buffer.read_flush() );
+	CPPLIB__TEST__EQ( buffer.read({ copy.data(), 60 }), 60_sz );
+	CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 60, data.begin() ) );
+	CPPLIB__TEST__EQ( fifo.write({ data.data() + 100, 100 }), 100_sz );
+	CPPLIB__TEST__TRUE( fifo.read_flush() );
+	CPPLIB__TEST__TRUE( buffer.read_flush() );
+	CPPLIB__TEST__EQ( buffer.read_size(), 128_sz );
+	CPPLIB__TEST__EQ( buffer.peek({ copy.data(), 128 }), 128_sz );
+	CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 128, data.begin() + 60 ) );
+	const auto & read_buff = buffer.read_cbuffer( false );
+	CPPLIB__TEST__EQ( read_buff.size(), 128 );
+	CPPLIB__TEST__TRUE( ::std::equal( read_buff.begin(), read_buff.end(), data.begin() + 60 ) );
+
+	// Large read drains the buffer, then bypasses it.
+	CPPLIB__TEST__EQ( buffer.read( copy ), 140_sz );
+	CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 140, data.begin() + 60 ) );
+	CPPLIB__TEST__EQ( buffer.read_size(), 0_sz );
+	// Bypassed bytes are consumed too, but can't be rewound.
+	CPPLIB__TEST__EQ( buffer.read_pos(), 140_sz );
+	CPPLIB__TEST__TRUE( buffer.read_pos( 0 ).failed() );
+	CPPLIB__TEST__EQ( buffer.read_pos( 140 ), 140_sz );
+	CPPLIB__TEST__TRUE( fifo.read_flush() );
+	CPPLIB__TEST__EQ( fifo.read_size(), 0_sz );
+	CPPLIB__TEST__TRUE( buffer.read_flush() );
+	CPPLIB__TEST__EQ( buffer.read_pos(), 0_sz );
+
+	// Large write flushes staged data, then bypasses the buffer.
+	CPPLIB__TEST__EQ( buffer.write({ data.data(), 10 }), 10_sz );
+	CPPLIB__TEST__EQ( buffer.write({ data.data() + 10, 200 }), 200_sz );
+	CPPLIB__TEST__EQ( buffer.write_pos(), 0_sz );
+	CPPLIB__TEST__EQ( fifo.read( copy ), 210_sz );
+	CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 210, data.begin() ) );
+	CPPLIB__TEST__TRUE( fifo.read_flush() );
+
+	// Staged write data wraps around the ring end.
+	for ( auto i = 0_sz; i < 8; ++i ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__EQ( buffer.write({ data.data() + i * 16, 100 }), 100_sz );
+		CPPLIB__TEST__EQ( buffer.write_buffer( false ).size(), 100 );
+		CPPLIB__TEST__TRUE( buffer.write_flush() );
+		CPPLIB__TEST__EQ( fifo.read( copy ), 100_sz );
+		CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 100, data.begin() + (isize)( i * 16 ) ) );
+		CPPLIB__TEST__TRUE( fifo.read_flush() );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+
+	// Vectored I/O falls back to sequential read()/write() calls.
+	const ::lib::data::cbuffer_t write_parts[] = { { data.data(), 20 }, { data.data() + 20, 30 } };
+	CPPLIB__TEST__EQ( buffer.writev( write_parts ), 50_sz );
+	CPPLIB__TEST__TRUE( buffer.write_flush() );
+	CPPLIB__TEST__TRUE( buffer.read_flush() );
+	const ::lib::data::buffer_t read_parts[] = { { copy.data(), 10 }, { copy.data() + 10, 100 } };
+	CPPLIB__TEST__EQ( buffer.readv( read_parts ), 50_sz );
+	CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 50, data.begin() ) );
+
+	// Failed flush of staged data fails the large write, nothing is staged after it.
+	BrokenWriteStream broken;
+	buffer.reset( &broken );
+	CPPLIB__TEST__EQ( buffer.write({ data.data(), 10 }), 10_sz );
+	const auto & broken_write = buffer.write({ data.data() + 10, 200 });
+	CPPLIB__TEST__TRUE( broken_write.failed() and broken_write.error() == ::lib::make_error_bad_data() );
+	CPPLIB__TEST__EQ( buffer.write_pos(), 10_sz );
+}
+
+} // namespace test::lib::stream::impl
@@ -0,0 +1,103 @@
+/* File: /test/lib/impl/stream/chain.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+
+#include <lib/system/error.hpp>
+#include <lib/data/serialize.hpp>
+#include <lib/impl/serialize/std_contiguous_container.hpp>
+#include <lib/impl/stream/chain.hpp>
+
+#include "./chain.hpp"
+
+namespace test::lib::stream::impl {
+
+void Chain::test_execute() noexcept/* override*/ {
+	using namespace ::lib;
+	using ::lib::stream::impl::chain;
+
+	::std::array<u8, 256> data;
+	::std::iota( data.begin(), data.end(), (u8) 0 );
+	::std::array<u8, 256> copy {};
+
+	chain::pool pool {64, 3};
+	{
+		chain stream {pool};
+		CPPLIB__TEST__EQ( stream.block_size(), 64 );
+
+		// Writes span several blocks, stored bytes never move.
+		CPPLIB__TEST__EQ( stream.write({ data.data(), 100 }), 100_sz );
+		const auto * first_block = stream.read_cbuffer( false ).data();
+		CPPLIB__TEST__EQ( stream.write({ data.data() + 100, 100 }), 100_sz );
+		CPPLIB__TEST__EQ( stream.read_cbuffer( false ).data(), first_block );
+		CPPLIB__TEST__EQ( stream.read_cbuffer( false ).size(), 64 );
+		CPPLIB__TEST__EQ( pool.allocated_count(), 4 );
+		CPPLIB__TEST__EQ( stream.read_size(), 200_sz );
+
+		CPPLIB__TEST__EQ( stream.peek( copy ), 200_sz );
+		CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 200, data.begin() ) );
+
+		// Partial read + rewind.
+		CPPLIB__TEST__EQ( stream.read({ copy.data(), 70 }), 70_sz );
+		CPPLIB__TEST__EQ( stream.read_cbuffer( false ).size(), 58 );
+		CPPLIB__TEST__EQ( stream.read_pos( 10 ), 10_sz );
+		CPPLIB__TEST__EQ( stream.read({ copy.data(), 60 }), 60_sz );
+		CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 60, data.begin() + 10 ) );
+		CPPLIB__TEST__EQ( stream.read_pos(), 70_sz );
+
+		// Flush returns consumed blocks to the pool.
+		CPPLIB__TEST__TRUE( stream.read_flush() );
+		CPPLIB__TEST__EQ( pool.free_count(), 1 );
+		CPPLIB__TEST__EQ( stream.read_size(), 130_sz );
+		CPPLIB__TEST__EQ( stream.read( copy ), 130_sz );
+		CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 130, data.begin() + 70 ) );
+		CPPLIB__TEST__TRUE( stream.read_flush() );
+		CPPLIB__TEST__EQ( pool.free_count(), 3 );
+		CPPLIB__TEST__EQ( pool.allocated_count(), 3 );
+		CPPLIB__TEST__TRUE( stream.read_cbuffer( false ).empty() );
+
+		// Steady state reuses pooled blocks.
+		for ( auto i = 0_sz; i < 10; ++i ) {
+			CPPLIB__TEST__LOOP_NEXT();
+			CPPLIB__TEST__EQ( stream.write({ data.data() + i, 150 }), 150_sz );
+			CPPLIB__TEST__EQ( stream.read( copy ), 150_sz );
+			CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 150, data.begin() + (isize) i ) );
+			CPPLIB__TEST__TRUE( stream.read_flush() );
+			CPPLIB__TEST__EQ( pool.allocated_count(), 3 );
+		}
+		CPPLIB__TEST__LOOP_RESET();
+
+		// Serialized data crossing a block boundary isn't contiguous: views fail, copies work.
+		const ::std::vector<u8> crossing ( data.begin(), data.begin() + 100 );
+		CPPLIB__TEST__EQ( ::lib::data::serialize( stream, crossing ), 104_sz );
+		CPPLIB__TEST__LT( stream.read_cbuffer( false ).size(), 104 );
+		::std::span<const u8> view;
+		const auto & view_readen = ::lib::data::deserialize( stream, view );
+		CPPLIB__TEST__TRUE( view_readen.failed() and view_readen.error() == ::lib::make_error_not_implemented() );
+		CPPLIB__TEST__EQ( stream.read_pos(), 0_sz );
+		::std::vector<u8> joined;
+		CPPLIB__TEST__EQ( ::lib::data::deserialize( stream, joined ), 104_sz );
+		CPPLIB__TEST__TRUE( joined == crossing );
+		CPPLIB__TEST__TRUE( stream.read_flush() );
+
+		CPPLIB__TEST__EQ( stream.write( data ), data.size() );
+	}
+	CPPLIB__TEST__EQ( pool.free_count(), 3 );
+	CPPLIB__TEST__EQ( pool.allocated_count(), 3 );
+	pool.shrink_to_fit();
+	CPPLIB__TEST__EQ( pool.allocated_count(), 0 );
+}
+
+} // namespace test::lib::stream::impl
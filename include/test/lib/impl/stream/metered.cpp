@@ -0,0 +1,109 @@
+/* File: /test/lib/impl/stream/metered.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <array>
+#include <numeric>
+#include <string>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+
+#include <lib/impl/stream/debug.hpp>
+#include <lib/impl/stream/fifo.hpp>
+#include <lib/impl/stream/metered.hpp>
+
+#include "./metered.hpp"
+
+namespace test::lib::stream::impl {
+
+void Metered::test_execute() noexcept/* override*/ {
+	using namespace ::lib;
+	using ::lib::stream::impl::metered;
+	using histogram = metered::histogram;
+	using Op = metered::Op;
+
+	// Histogram buckets cover values without gaps, relative error is bounded.
+	CPPLIB__TEST__EQ( histogram::bucket( 0 ), 0_sz );
+	CPPLIB__TEST__EQ( histogram::bucket( ::std::numeric_limits<u64>::max() ), histogram::BUCKETS - 1 );
+	CPPLIB__TEST__EQ( histogram::bucket_max( histogram::BUCKETS - 1 ), ::std::numeric_limits<u64>::max() );
+	for ( usize i = 1; i < histogram::BUCKETS; ++i ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__EQ( histogram::bucket_min( i ), histogram::bucket_max( i - 1 ) + 1 );
+		CPPLIB__TEST__EQ( histogram::bucket( histogram::bucket_min( i ) ), i );
+		CPPLIB__TEST__EQ( histogram::bucket( histogram::bucket_max( i ) ), i );
+		CPPLIB__TEST__LE( histogram::bucket_max( i ) - histogram::bucket_min( i ), histogram::bucket_min( i ) / histogram::SUB_BUCKETS );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+
+	histogram latency;
+	CPPLIB__TEST__EQ( latency.percentile( 0.5 ), 0_u64 );
+	for ( u64 value = 1; value <= 1000; ++value )
+		latency.record( value );
+	CPPLIB__TEST__EQ( latency.count(), 1000_u64 );
+	CPPLIB__TEST__EQ( latency.min(), 1_u64 );
+	CPPLIB__TEST__EQ( latency.max(), 1000_u64 );
+	CPPLIB__TEST__EQf( (float) latency.mean(), 500.5f );
+	CPPLIB__TEST__TRUE( latency.percentile( 0.5 ) >= 500 and latency.percentile( 0.5 ) < 500 + 500 / histogram::SUB_BUCKETS );
+	CPPLIB__TEST__EQ( latency.percentile( 1.0 ), 1000_u64 );
+	const histogram copy = latency;
+	latency.clear();
+	CPPLIB__TEST__EQ( latency.count(), 0_u64 );
+	CPPLIB__TEST__EQ( copy.count(), 1000_u64 );
+
+	// Decorated stream.
+	::std::array<u8, 100> data;
+	::std::iota( data.begin(), data.end(), (u8) 0 );
+	::std::array<u8, 200> buffer {};
+
+	::lib::stream::impl::fifo fifo;
+	metered stream {&fifo};
+	CPPLIB__TEST__EQ( stream.write( data ), data.size() );
+	CPPLIB__TEST__EQ( stream.writev( ::std::array<data::cbuffer_t, 2> {data::cbuffer_t {data}, data::cbuffer_t {data}} ), 200_sz );
+	CPPLIB__TEST__EQ( stream.read_size(), 300_sz );
+	CPPLIB__TEST__EQ( stream.peek({ buffer.data(), 10 }), 10_sz );
+	CPPLIB__TEST__EQ( stream.read( buffer ), buffer.size() );
+	CPPLIB__TEST__EQ( stream.read( buffer ), 100_sz );
+	CPPLIB__TEST__TRUE( stream.read_flush() );
+	CPPLIB__TEST__EQ( stream[Op::WRITE].calls, 2_u64 );
+	CPPLIB__TEST__EQ( stream[Op::WRITE].bytes, 300_u64 );
+	CPPLIB__TEST__EQ( stream[Op::WRITE].shorts, 0_u64 );
+	CPPLIB__TEST__EQ( stream[Op::READ].calls, 2_u64 );
+	CPPLIB__TEST__EQ( stream[Op::READ].bytes, 300_u64 );
+	CPPLIB__TEST__EQ( stream[Op::READ].shorts, 1_u64 );
+	CPPLIB__TEST__EQ( stream[Op::READ].latency.count(), 2_u64 );
+	CPPLIB__TEST__EQ( stream[Op::PEEK].calls, 1_u64 );
+	CPPLIB__TEST__EQ( stream[Op::FLUSH].calls, 1_u64 );
+	CPPLIB__TEST__EQ( stream[Op::FLUSH].errors, 0_u64 );
+
+	const auto snapshot = stream.snapshot();
+	stream.clear();
+	CPPLIB__TEST__EQ( stream[Op::READ].calls, 0_u64 );
+	CPPLIB__TEST__EQ( snapshot[Op::READ].calls, 2_u64 );
+	const auto & text = snapshot.text();
+	CPPLIB__TEST__NE( text.find( "read" ), ::std::string::npos );
+	CPPLIB__TEST__NE( text.find( "p999" ), ::std::string::npos );
+	const auto & json = snapshot.json();
+	CPPLIB__TEST__EQ( json.front(), '{' );
+	CPPLIB__TEST__EQ( json.back(), '}' );
+	CPPLIB__TEST__NE( json.find( "\"read\":{\"calls\":2,\"bytes\":300,\"short\":1,\"errors\":0" ), ::std::string::npos );
+	CPPLIB__TEST__NE( json.find( "\"buckets\":[[" ), ::std::string::npos );
+
+	// Errors of the wrapped stream.
+	::lib::stream::impl::debug broken;
+	stream.reset( &broken );
+	CPPLIB__TEST__TRUE( stream.write( data ).failed() );
+	CPPLIB__TEST__FALSE( stream.write_flush() );
+	CPPLIB__TEST__EQ( stream[Op::WRITE].errors, 1_u64 );
+	CPPLIB__TEST__EQ( stream[Op::FLUSH].errors, 1_u64 );
+
+	stream.reset();
+	CPPLIB__TEST__TRUE( stream.read( buffer ).failed() );
+	CPPLIB__TEST__EQ( stream[Op::READ].calls, 0_u64 );
+}
+
+} // namespace test::lib::stream::impl
@@ -0,0 +1,26 @@
+/* File: /test/lib/impl/stream/metered.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__test__lib__impl__stream__metered__hpp
+#define CPPLIB__test__lib__impl__stream__metered__hpp
+
+#include <lib/test/unit.hpp>
+
+namespace test::lib::stream::impl {
+
+class Metered final
+	: public ::lib::test::IUnit
+{
+public:
+	Metered() noexcept : IUnit {"Metered"} {}
+private:
+	void test_execute() noexcept override;
+};
+
+} // namespace test::lib::stream::impl
+
+#endif // CPPLIB__test__lib__impl__stream__metered__hpp
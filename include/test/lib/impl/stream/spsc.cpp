@@ -0,0 +1,99 @@
+/* File: /test/lib/impl/stream/spsc.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <numeric>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+
+#include <lib/system/error.hpp>
+#include <lib/data/serialize.hpp>
+#include <lib/impl/serialize/std_contiguous_container.hpp>
+#include <lib/impl/stream/spsc.hpp>
+
+#include "./spsc.hpp"
+
+namespace test::lib::stream::impl {
+
+void Spsc::test_execute() noexcept/* override*/ {
+	using namespace ::lib;
+
+	::std::array<u8, 256> data;
+	::std::iota( data.begin(), data.end(), (u8) 0 );
+	::std::array<u8, 256> copy {};
+
+	::lib::stream::impl::spsc ring {100};
+	CPPLIB__TEST__EQ( ring.capacity(), 128 );
+	CPPLIB__TEST__EQ( ring.write_size(), 128_sz );
+
+	// Single thread: wrap around and partial writes.
+	CPPLIB__TEST__EQ( ring.write({ data.data(), 100 }), 100_sz );
+	CPPLIB__TEST__EQ( ring.write({ data.data() + 100, 100 }), 28_sz );
+	CPPLIB__TEST__EQ( ring.write_size(), 0_sz );
+	CPPLIB__TEST__EQ( ring.read({ copy.data(), 90 }), 90_sz );
+	CPPLIB__TEST__EQ( ring.write_size(), 0_sz );
+	CPPLIB__TEST__TRUE( ring.read_flush() );
+	CPPLIB__TEST__EQ( ring.write_size(), 90_sz );
+	CPPLIB__TEST__EQ( ring.write({ data.data() + 128, 60 }), 60_sz );
+	CPPLIB__TEST__EQ( ring.read_size(), 98_sz );
+	CPPLIB__TEST__EQ( ring.read_cbuffer( false ).size(), 38 );
+	CPPLIB__TEST__EQ( ring.peek( copy ), 98_sz );
+	CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 98, data.begin() + 90 ) );
+	CPPLIB__TEST__EQ( ring.read_pos( 1000 ), 98_sz );
+	CPPLIB__TEST__EQ( ring.read_pos( 0 ), 0_sz );
+	CPPLIB__TEST__EQ( ring.read( copy ), 98_sz );
+	CPPLIB__TEST__TRUE( ring.read_flush() );
+	CPPLIB__TEST__EQ( ring.read_size(), 0_sz );
+
+	// Serialized data wrapping the storage end isn't contiguous: views fail, copies work.
+	const ::std::vector<u8> wrapped ( data.begin(), data.begin() + 100 );
+	CPPLIB__TEST__EQ( ::lib::data::serialize( ring, wrapped ), 104_sz );
+	CPPLIB__TEST__LT( ring.read_cbuffer( false ).size(), 104 );
+	::std::span<const u8> view;
+	const auto & view_readen = ::lib::data::deserialize( ring, view );
+	CPPLIB__TEST__TRUE( view_readen.failed() and view_readen.error() == ::lib::make_error_not_implemented() );
+	CPPLIB__TEST__EQ( ring.read_pos(), 0_sz );
+	::std::vector<u8> unwrapped;
+	CPPLIB__TEST__EQ( ::lib::data::deserialize( ring, unwrapped ), 104_sz );
+	CPPLIB__TEST__TRUE( unwrapped == wrapped );
+	CPPLIB__TEST__TRUE( ring.read_flush() );
+
+	// Two threads: bytes arrive in order.
+	static constexpr usize TOTAL = 1024_sz * 1024;
+	auto producer = ::std::async( ::std::launch::async, [&]() {
+		for ( usize sent = 0; sent < TOTAL; ) {
+			const auto & count = ring.write({ data.data() + sent % 256, ::std::min( TOTAL - sent, 256 - sent % 256 ) });
+			sent += count.value();
+			if ( count == 0_sz )
+				::std::this_thread::yield();
+		}
+	});
+	usize received = 0;
+	bool ordered = true;
+	while ( received < TOTAL ) {
+		const auto & count = ring.read( copy );
+		for ( usize i = 0; i < count.value(); ++i )
+			ordered = ordered and copy[i] == (u8)( received + i );
+		received += count.value();
+		CPPLIB__TEST__TRUE( ring.read_flush() );
+		if ( count == 0_sz )
+			::std::this_thread::yield();
+	}
+	producer.get();
+	CPPLIB__TEST__TRUE( ordered );
+	CPPLIB__TEST__EQ( received, TOTAL );
+	CPPLIB__TEST__EQ( ring.read_size(), 0_sz );
+}
+
+} // namespace test::lib::stream::impl
@@ -62,6 +62,12 @@ void Unix::test_execute() noexcept/* override*/ {
 		CPPLIB__TEST__EQ( count, sizeof(BAR) );
 		CPPLIB__TEST__TRUE( client.update() );
 
+		// Same data once again, gathered from two parts.
+		const ::lib::data::cbuffer_t bar_parts[] = { { BAR, 6 }, { BAR + 6, ::std::strlen( BAR ) + 1 - 6 } };
+		count = client.writev( bar_parts );
+		CPPLIB__TEST__EQ( count, sizeof(BAR) );
+		CPPLIB__TEST__TRUE( client.update() );
+
 		::std::wstring foo;
 		while ( not emergency_client_stop
 		and client.update()
@@ -148,6 +154,17 @@ void Unix::test_execute() noexcept/* override*/ {
 
 		CPPLIB__TEST__EQ( BAR, bar );
 
+		// Second copy is a separate packet (SOCK_SEQPACKET), scattered into three parts.
+		for ( auto i = 0; i < 10 and client.obj->read_size() < bar.size() + 1; ++i )
+			sleep( 10ms );
+		char terminator = '?';
+		bar.assign( bar.size(), '\0' );
+		const ::lib::data::buffer_t bar_parts[] = { { (::lib::u8 *) bar.data(), 4 }
+			, { (::lib::u8 *) bar.data() + 4, bar.size() - 4 }, { (::lib::u8 *) &terminator, 1 } };
+		CPPLIB__TEST__EQ( client.obj->readv( bar_parts ), bar.size() + 1 );
+		CPPLIB__TEST__EQ( terminator, '\0' );
+		CPPLIB__TEST__EQ( BAR, bar );
+
 		serialize_result = ::lib::data::serialize( *client.obj, CLIENT_STOP );
 		CPPLIB__TEST__EQ( serialize_result, ::lib::data::serialized_size( *client.obj, CLIENT_STOP ) );
 		CPPLIB__TEST__TRUE( client.obj->shutdown() );
@@ -0,0 +1,90 @@
+/* File: /test/lib/impl_posix/stream/mapped_file.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+#include <cpp/lib_scope>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+
+#include <lib/impl/stream/mapped_file.hpp>
+
+#include "./mapped_file.hpp"
+
+namespace test::lib::stream::impl {
+
+void MappedFile::test_execute() noexcept/* override*/ {
+	using namespace ::lib;
+	using ::lib::stream::impl::mapped_file;
+
+	::std::array<u8, 10000> data;
+	::std::iota( data.begin(), data.end(), (u8) 0 );
+
+	char file_name[] = "/tmp/CPPLIB__test__lib__impl_posix__stream__mapped_file__XXXXXX";
+	{
+		const int file = ::mkstemp( file_name );
+		CPPLIB__TEST__NE( file, -1 );
+		CPPLIB__TEST__EQ( ::write( file, data.data(), data.size() ), (isize) data.size() );
+		CPPLIB__TEST__EQ( ::close( file ), 0 );
+	}
+	const auto remove_file = ::cpp::scope_exit {[&]() {
+		CPP_UNUSED( ::unlink( file_name ) );
+	}};
+
+	mapped_file file {file_name, mapped_file::Advice::SEQUENTIAL};
+	CPPLIB__TEST__TRUE( file.is_open() );
+	CPPLIB__TEST__FALSE( file.error() );
+	CPPLIB__TEST__EQ( file.mapping().size(), data.size() );
+	CPPLIB__TEST__EQ( file.read_size(), data.size() );
+
+	// Whole file is available without copying.
+	const auto & content = file.read_cbuffer();
+	CPPLIB__TEST__EQ( content.size(), data.size() );
+	CPPLIB__TEST__EQ( content.data(), file.mapping().data() );
+	CPPLIB__TEST__TRUE( ::std::equal( content.begin(), content.end(), data.begin() ) );
+
+	::std::array<u8, 100> copy {};
+	CPPLIB__TEST__EQ( file.read( copy ), copy.size() );
+	CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.end(), data.begin() ) );
+	CPPLIB__TEST__EQ( file.pos(), 100_sz );
+	CPPLIB__TEST__EQ( file.read_cbuffer().size(), data.size() - 100 );
+
+	// Seeking.
+	CPPLIB__TEST__EQ( file.pos( 9950 ), 9950_sz );
+	CPPLIB__TEST__EQ( file.peek( copy ), 50_sz );
+	CPPLIB__TEST__EQ( copy[0], data[9950] );
+	CPPLIB__TEST__EQ( file.read( copy ), 50_sz );
+	CPPLIB__TEST__EQ( file.read( copy ), 0_sz );
+	CPPLIB__TEST__EQ( file.pos( 20000 ), data.size() );
+	CPPLIB__TEST__EQ( file.read_size(), 0_sz );
+
+	// Hints on the part of the mapping.
+	CPPLIB__TEST__TRUE( file.advise( mapped_file::Advice::WILL_NEED, 5000, 100 ) );
+	CPPLIB__TEST__TRUE( file.advise( mapped_file::Advice::RANDOM ) );
+
+	CPPLIB__TEST__TRUE( file.write( copy ).failed() );
+	CPPLIB__TEST__EQ( file.write_size(), 0_sz );
+
+	CPPLIB__TEST__TRUE( file.close() );
+	CPPLIB__TEST__FALSE( file.is_open() );
+	CPPLIB__TEST__TRUE( file.read_cbuffer().empty() );
+
+	// Missing file.
+	CPPLIB__TEST__FALSE( file.open( "/tmp/CPPLIB__test__lib__impl_posix__stream__mapped_file__missing" ) );
+	CPPLIB__TEST__TRUE( file.error() );
+	file.reset();
+	CPPLIB__TEST__FALSE( file.error() );
+}
+
+} // namespace test::lib::stream::impl
@@ -0,0 +1,26 @@
+/* File: /test/lib/impl_posix/stream/mapped_file.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__test__lib__impl_posix__stream__mapped_file__hpp
+#define CPPLIB__test__lib__impl_posix__stream__mapped_file__hpp
+
+#include <lib/test/unit.hpp>
+
+namespace test::lib::stream::impl {
+
+class MappedFile final
+	: public ::lib::test::IUnit
+{
+public:
+	MappedFile() noexcept : IUnit {"MappedFile"} {}
+private:
+	void test_execute() noexcept override;
+};
+
+} // namespace test::lib::stream::impl
+
+#endif // CPPLIB__test__lib__impl_posix__stream__mapped_file__hpp
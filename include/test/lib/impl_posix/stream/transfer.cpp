@@ -0,0 +1,272 @@
+/* File: /test/lib/impl_posix/stream/transfer.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <cpp/lib_scope>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+
+#include <lib/impl/stream/fifo.hpp>
+#include <lib/impl/stream/file.hpp>
+#include <lib/impl/stream/mapped_file.hpp>
+#include <lib/impl/stream/metered.hpp>
+#include <lib/impl_posix/socket/unix/base.hpp>
+
+#include "./transfer.hpp"
+
+namespace test::lib::stream::impl {
+
+namespace {
+
+using namespace ::lib;
+
+/// @brief Non-blocking socket pair: transfer into `first`, receive from `second`.
+struct socket_pair {
+	static ::std::array<int, 2> open() {
+		::std::array<int, 2> fds { -1, -1 };
+		CPP_UNUSED( ::socketpair( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data() ) );
+		return fds;
+	}
+
+	socket_pair() : socket_pair( open() ) {}
+	socket_pair( ::std::array<int, 2> fds )
+		: first {fds[0]}
+		, second {fds[1]}
+	{
+		CPP_UNUSED( first.set_blocking( false ) );
+		CPP_UNUSED( second.set_blocking( false ) );
+	}
+
+	/// @brief Alternates transfer_from() and reads until `size` bytes are received.
+	::std::vector<u8> pump( data::rstream_t & source, usize size ) {
+		::std::vector<u8> received;
+		::std::array<u8, 4096> chunk;
+		for ( usize idle = 0; received.size() < size and idle < 1000; ) {
+			const auto & sent = first.transfer_from( source );
+			if ( sent.failed() and first.error() )
+				break;
+			const auto & count = second.read( chunk );
+			if ( count.success() )
+				received.insert( received.end(), chunk.begin(), chunk.begin() + (isize) count.value() );
+			idle = ( sent.success() and sent.value() > 0 ) or ( count.success() and count.value() > 0 ) ? 0 : idle + 1;
+		}
+		return received;
+	}
+
+	socket::impl::unix::base first;
+	socket::impl::unix::base second;
+};
+
+/// @brief Source with neither descriptor, nor peek(), nor contiguous view: only read() is left.
+class read_only final
+	: public data::rstream_t
+{
+public:
+	explicit read_only( data::rstream_t & stream ) : stream{ stream } {}
+	data::result_t read( const data::buffer_t & buffer ) override { return stream.read( buffer ); }
+	data::result_t read_size() override { return stream.read_size(); }
+	::std::error_condition read_error() const override { return stream.read_error(); }
+private:
+	data::rstream_t & stream;
+};
+
+::std::vector<u8> make_data( usize size ) {
+	::std::vector<u8> data( size );
+	for ( usize i = 0; i < size; ++i )
+		data[i] = (u8)( i * 7 + i / 251 );
+	return data;
+}
+
+} // namespace
+
+void Transfer::test_execute() noexcept/* override*/ {
+	CPPLIB__TEST__SUBTEST( sendfile );
+	CPPLIB__TEST__SUBTEST( splice );
+	CPPLIB__TEST__SUBTEST( generic );
+}
+
+void Transfer::sendfile() noexcept {
+	const auto data = make_data( 1000_sz * 1000 );
+
+	char file_name[] = "/tmp/CPPLIB__test__lib__impl_posix__stream__transfer__XXXXXX";
+	{
+		const int file = ::mkstemp( file_name );
+		CPPLIB__TEST__NE( file, -1 );
+		CPPLIB__TEST__EQ( ::write( file, data.data(), data.size() ), (isize) data.size() );
+		CPPLIB__TEST__EQ( ::close( file ), 0 );
+	}
+	const auto remove_file = ::cpp::scope_exit {[&]() {
+		CPP_UNUSED( ::unlink( file_name ) );
+	}};
+
+	// Mapped file: whole file from the current position.
+	{
+		::lib::stream::impl::mapped_file file {file_name};
+		CPPLIB__TEST__TRUE( file.is_open() );
+		CPPLIB__TEST__NE( file.read_fd(), -1 );
+		CPPLIB__TEST__EQ( file.pos( 100 ), 100_sz );
+
+		socket_pair sockets;
+		const auto & received = sockets.pump( file, data.size() - 100 );
+		CPPLIB__TEST__FALSE( sockets.first.error() );
+		CPPLIB__TEST__EQ( received.size(), data.size() - 100 );
+		CPPLIB__TEST__TRUE( ::std::equal( received.begin(), received.end(), data.begin() + 100 ) );
+		CPPLIB__TEST__EQ( file.pos(), data.size() );
+	}
+
+	// Metered file: descriptor is forwarded, the fast path is kept.
+	{
+		::lib::stream::impl::mapped_file file {file_name};
+		::lib::stream::impl::metered metered {&file};
+		CPPLIB__TEST__EQ( metered.read_fd(), file.read_fd() );
+		CPPLIB__TEST__EQ( metered.write_fd(), file.write_fd() );
+
+		socket_pair sockets;
+		const auto & received = sockets.pump( metered, data.size() );
+		CPPLIB__TEST__FALSE( sockets.first.error() );
+		CPPLIB__TEST__TRUE( received == data );
+		CPPLIB__TEST__EQ( metered[::lib::stream::impl::metered::Op::READ].calls.load(), 0_u64 );
+	}
+
+	// Stdio file: bytes buffered by fread() are not transferred twice.
+	{
+		::lib::stream::impl::file file {file_name};
+		CPPLIB__TEST__TRUE( file.is_open() );
+		::std::array<u8, 10> head;
+		CPPLIB__TEST__EQ( file.read( head ), head.size() );
+
+		socket_pair sockets;
+		CPPLIB__TEST__EQ( sockets.first.transfer_from( file, 1000 ), 1000_sz );
+		CPPLIB__TEST__EQ( file.pos(), 1010_sz );
+		::std::array<u8, 1000> received;
+		CPPLIB__TEST__EQ( sockets.second.read( received ), received.size() );
+		CPPLIB__TEST__TRUE( ::std::equal( received.begin(), received.end(), data.begin() + 10 ) );
+		CPPLIB__TEST__EQ( file.read( head ), head.size() );
+		CPPLIB__TEST__TRUE( ::std::equal( head.begin(), head.end(), data.begin() + 1010 ) );
+	}
+}
+
+void Transfer::splice() noexcept {
+	const auto data = make_data( 300_sz * 1000 );
+
+	// Socket to socket: source has a descriptor, but can't be seeked.
+	socket_pair input;
+	socket_pair output;
+	CPPLIB__TEST__EQ( input.second.read_fd(), input.second.write_fd() );
+	CPPLIB__TEST__TRUE( input.second.read_pos().failed() );
+
+	/// @note Bytes spliced out of the source are written out before transfer_from() returns,
+	///       so the other end has to be drained concurrently.
+	::std::atomic<bool> stop = false;
+	auto receiver = ::std::async( ::std::launch::async, [&]() {
+		::std::vector<u8> received;
+		::std::array<u8, 4096> chunk;
+		while ( not stop and received.size() < data.size() ) {
+			const auto & count = output.second.read( chunk );
+			if ( count.success() )
+				received.insert( received.end(), chunk.begin(), chunk.begin() + (isize) count.value() );
+			else
+				::std::this_thread::yield();
+		}
+		return received;
+	});
+
+	usize moved = 0;
+	for ( usize offset = 0, idle = 0; moved < data.size() and idle < 100000; ) {
+		usize progress = 0;
+		if ( offset < data.size() ) {
+			const auto & sent = input.first.write({ data.data() + offset, data.size() - offset });
+			if ( sent.success() ) {
+				offset += sent.value();
+				progress += sent.value();
+			}
+		}
+		const auto & count = output.first.transfer_from( input.second );
+		if ( output.first.error() )
+			break;
+		if ( count.success() ) {
+			moved += count.value();
+			progress += count.value();
+		}
+		idle = progress == 0 ? idle + 1 : 0;
+		if ( progress == 0 )
+			::std::this_thread::yield();
+	}
+	stop = moved < data.size();
+	const auto & received = receiver.get();
+
+	CPPLIB__TEST__FALSE( output.first.error() );
+	CPPLIB__TEST__EQ( moved, data.size() );
+	CPPLIB__TEST__TRUE( received == data );
+}
+
+void Transfer::generic() noexcept {
+	const auto data = make_data( 100_sz * 1000 );
+
+	// Memory stream without descriptor: copied from its read_cbuffer().
+	{
+		::lib::stream::impl::fifo source;
+		CPPLIB__TEST__EQ( source.write( data ), data.size() );
+		CPPLIB__TEST__EQ( source.read_fd(), -1 );
+
+		socket_pair sockets;
+		const auto & received = sockets.pump( source, data.size() );
+		CPPLIB__TEST__FALSE( sockets.first.error() );
+		CPPLIB__TEST__TRUE( received == data );
+		CPPLIB__TEST__EQ( source.read_size(), 0_sz );
+	}
+
+	// Neither side has a descriptor, `count` is respected.
+	{
+		::lib::stream::impl::fifo source;
+		::lib::stream::impl::fifo target;
+		CPPLIB__TEST__EQ( source.write( data ), data.size() );
+		CPPLIB__TEST__EQ( target.transfer_from( source, 1000 ), 1000_sz );
+		CPPLIB__TEST__EQ( target.transfer_from( source ), data.size() - 1000 );
+		CPPLIB__TEST__EQ( target.transfer_from( source ), 0_sz );
+		::std::vector<u8> received( data.size() );
+		CPPLIB__TEST__EQ( target.read( received ), data.size() );
+		CPPLIB__TEST__TRUE( received == data );
+	}
+
+	// Only read() of the source: full socket stops the transfer, written bytes are reported.
+	{
+		const auto big = make_data( 16_sz * 1024 * 1024 );
+		::lib::stream::impl::fifo fifo;
+		CPPLIB__TEST__EQ( fifo.write( big ), big.size() );
+		read_only source {fifo};
+		socket_pair sockets;
+		const auto & sent = sockets.first.transfer_from( source );
+		CPPLIB__TEST__TRUE( sent.success() );
+		CPPLIB__TEST__GT( sent.value(), 0_sz );
+		CPPLIB__TEST__LT( sent.value(), big.size() );
+		::std::vector<u8> received( big.size() );
+		usize received_size = 0;
+		for ( ;; ) {
+			const auto & count = sockets.second.read({ received.data() + received_size, received.size() - received_size });
+			if ( count.failed() or count.value() == 0 )
+				break;
+			received_size += count.value();
+		}
+		CPPLIB__TEST__EQ( received_size, sent.value() );
+		CPPLIB__TEST__TRUE( ::std::equal( received.begin(), received.begin() + (isize) received_size, big.begin() ) );
+	}
+}
+
+} // namespace test::lib::stream::impl
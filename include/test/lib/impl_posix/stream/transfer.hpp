@@ -0,0 +1,30 @@
+/* File: /test/lib/impl_posix/stream/transfer.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__test__lib__impl_posix__stream__transfer__hpp
+#define CPPLIB__test__lib__impl_posix__stream__transfer__hpp
+
+#include <lib/test/unit.hpp>
+
+namespace test::lib::stream::impl {
+
+class Transfer final
+	: public ::lib::test::IUnit
+{
+public:
+	Transfer() noexcept : IUnit {"Transfer"} {}
+private:
+	void test_execute() noexcept override;
+
+	void sendfile() noexcept;
+	void splice() noexcept;
+	void generic() noexcept;
+};
+
+} // namespace test::lib::stream::impl
+
+#endif // CPPLIB__test__lib__impl_posix__stream__transfer__hpp
@@ -0,0 +1,148 @@
+/* File: /test/lib/impl_posix/stream/uring_file.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+#include <cpp/lib_scope>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+
+#include <lib/impl/stream/uring_file.hpp>
+
+#include "./uring_file.hpp"
+
+namespace test::lib::stream::impl {
+
+void UringFile::test_execute() noexcept/* override*/ {
+	CPPLIB__TEST__SUBTEST( uring );
+	CPPLIB__TEST__SUBTEST( threads );
+}
+
+void UringFile::uring() noexcept {
+	run( false );
+}
+
+void UringFile::threads() noexcept {
+	run( true );
+}
+
+void UringFile::run( bool threads ) noexcept {
+	using namespace ::lib;
+	using ::lib::stream::impl::uring_file;
+
+	const auto backend = threads ? uring_file::Backend::THREADS : uring_file::Backend::URING;
+	static constexpr usize CHUNK = 1000;
+	static constexpr usize CHUNKS = 10;
+
+	::std::array<u8, CHUNK * CHUNKS> data;
+	::std::iota( data.begin(), data.end(), (u8) 0 );
+
+	char file_name[] = "/tmp/CPPLIB__test__lib__impl_posix__stream__uring_file__XXXXXX";
+	{
+		const int file = ::mkstemp( file_name );
+		CPPLIB__TEST__NE( file, -1 );
+		CPPLIB__TEST__EQ( ::close( file ), 0 );
+	}
+	const auto remove_file = ::cpp::scope_exit {[&]() {
+		CPP_UNUSED( ::unlink( file_name ) );
+	}};
+
+	uring_file file {file_name, uring_file::Mode::WRITE, backend};
+	CPPLIB__TEST__TRUE( file.is_open() );
+	CPPLIB__TEST__NE( file.backend(), uring_file::Backend::NONE );
+	if ( threads )
+		CPPLIB__TEST__EQ( file.backend(), uring_file::Backend::THREADS );
+
+	// Many writes in flight, completed in any order.
+	usize written = 0;
+	for ( usize i = 0; i < CHUNKS; ++i ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		const auto chunk = CHUNKS - 1 - i;
+		CPPLIB__TEST__TRUE( file.write_async( chunk * CHUNK, { data.data() + chunk * CHUNK, CHUNK },
+			[&]( data::result_t result ) { written += result.value(); } ) );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__EQ( file.in_flight(), CHUNKS );
+	CPPLIB__TEST__GE( file.wait( CHUNKS ), CHUNKS );
+	CPPLIB__TEST__EQ( file.in_flight(), 0_sz );
+	CPPLIB__TEST__EQ( written, data.size() );
+	CPPLIB__TEST__TRUE( file.close() );
+
+	CPPLIB__TEST__TRUE( file.open( file_name, uring_file::Mode::READ, backend ) );
+	CPPLIB__TEST__EQ( file.size(), data.size() );
+
+	// Synchronous reads without read-ahead.
+	::std::array<u8, 300> copy {};
+	CPPLIB__TEST__EQ( file.peek( copy ), copy.size() );
+	CPPLIB__TEST__EQ( file.pos(), 0_sz );
+	CPPLIB__TEST__EQ( file.read( copy ), copy.size() );
+	CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.end(), data.begin() ) );
+
+	// Sequential reads through the read-ahead window.
+	CPPLIB__TEST__TRUE( file.register_buffers( 4, 256 ) );
+	CPPLIB__TEST__EQ( file.fixed_count(), 4_sz );
+	for ( usize offset = copy.size(); offset < data.size(); offset += copy.size() ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		const auto count = ::std::min( copy.size(), data.size() - offset );
+		CPPLIB__TEST__EQ( file.read( copy ), count );
+		CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + (isize) count, data.begin() + (isize) offset ) );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__EQ( file.read( copy ), 0_sz );
+	CPPLIB__TEST__EQ( file.pos(), data.size() );
+
+	// Seeking drops the window.
+	CPPLIB__TEST__EQ( file.pos( 5000 ), 5000_sz );
+	CPPLIB__TEST__EQ( file.read( copy ), copy.size() );
+	CPPLIB__TEST__EQ( copy[0], data[5000] );
+	CPPLIB__TEST__EQ( copy.back(), data[5299] );
+	CPPLIB__TEST__EQ( file.size(), data.size() - 5300 );
+	CPPLIB__TEST__TRUE( file.flush() );
+
+	// Asynchronous reads into registered buffers.
+	usize completed = 0;
+	for ( usize i = 0; i < file.fixed_count(); ++i ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__TRUE( file.read_fixed_async( i, i * 1000, 256, [&, i]( data::result_t result ) {
+			const auto & buffer = file.fixed_buffer( i );
+			if ( result == 256_sz and ::std::equal( buffer.begin(), buffer.end(), data.begin() + (isize)( i * 1000 ) ) )
+				++completed;
+		}));
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__TRUE( file.submit() );
+	while ( file.in_flight() > 0 )
+		CPP_UNUSED( file.poll() );
+	CPPLIB__TEST__EQ( completed, file.fixed_count() );
+
+	// Reading past the end of file is not an error.
+	bool eof = false;
+	CPPLIB__TEST__TRUE( file.read_async( data.size() + 100, copy, [&]( data::result_t result ) { eof = result == 0_sz; } ) );
+	CPPLIB__TEST__EQ( file.wait(), 1_sz );
+	CPPLIB__TEST__TRUE( eof );
+
+	CPPLIB__TEST__TRUE( file.write( copy ).failed() );
+	CPPLIB__TEST__TRUE( file.error() );
+	file.reset();
+	CPPLIB__TEST__FALSE( file.is_open() );
+	CPPLIB__TEST__EQ( file.backend(), uring_file::Backend::NONE );
+
+	// Missing file.
+	CPPLIB__TEST__FALSE( file.open( "/tmp/CPPLIB__test__lib__impl_posix__stream__uring_file__missing" ) );
+	CPPLIB__TEST__TRUE( file.error() );
+	file.reset();
+	CPPLIB__TEST__FALSE( file.error() );
+}
+
+} // namespace test::lib::stream::impl
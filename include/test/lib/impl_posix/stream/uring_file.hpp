@@ -0,0 +1,30 @@
+/* File: /test/lib/impl_posix/stream/uring_file.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__test__lib__impl_posix__stream__uring_file__hpp
+#define CPPLIB__test__lib__impl_posix__stream__uring_file__hpp
+
+#include <lib/test/unit.hpp>
+
+namespace test::lib::stream::impl {
+
+class UringFile final
+	: public ::lib::test::IUnit
+{
+public:
+	UringFile() noexcept : IUnit {"UringFile"} {}
+private:
+	void test_execute() noexcept override;
+
+	void uring() noexcept;
+	void threads() noexcept;
+	void run( bool threads ) noexcept;
+};
+
+} // namespace test::lib::stream::impl
+
+#endif // CPPLIB__test__lib__impl_posix__stream__uring_file__hpp
@@ -8,18 +8,27 @@
 
 #include <lib/debug/features.hpp>
 
+#include <array>
+#include <cstring>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 CPPLIB_MSVC_WARNING(disable:4355)
 CPPLIB_MSVC_WARNING(disable:5204)
 #include <future>
 CPPLIB_MSVC_WARNING(default:5204)
+#include <memory_resource>
 CPPLIB_MSVC_WARNING(default:4355)
 
 #include <cpp/lib_debug>
 #include <cpp/lib_scope>
 
 #include <lib/packets/handler.hpp>
+#include <lib/packets/aggregator.hpp>
+#include <lib/packets/broadcaster.hpp>
+#include <lib/packets/dispatcher.hpp>
+#include <lib/packets/stats.hpp>
 #include <lib/impl/packets/ping_counter.hpp>
 
 #include <lib/tl/listener.hpp>
@@ -33,6 +42,11 @@ CPPLIB_MSVC_WARNING(default:4355)
 
 #include <lib/impl/socket/tcp.hpp>
 #include <lib/impl/stream/buffer.hpp>
+#include <lib/impl/stream/data.hpp>
+#include <lib/impl/stream/fifo.hpp>
+#include <lib/impl/stream/chain.hpp>
+#include <lib/impl/stream/metered.hpp>
+#include <lib/impl/stream/spsc.hpp>
 
 #include "./handler.hpp"
 
@@ -62,6 +76,118 @@ struct Message : PacketBase {
 	using PacketBase::deserialize;
 };
 
+struct Blob : PacketBase {
+	static constexpr auto ID = 2;
+	::lib::u32 tag = 0;
+	::std::vector< ::lib::u8 > data;
+
+	inline ::lib::data::result_t serialized_size( ::lib::data::wstream_t & stream ) const override
+	{ return ::lib::data::serialized_size( stream, tag, data ); }
+	inline bool can_deserialize( ::lib::data::rstream_t & stream ) const override
+	{ return ::lib::data::can_deserialize( stream, tag, data ); }
+	inline ::lib::data::result_t serialize( ::lib::data::wstream_t & stream ) const override
+	{ return ::lib::data::serialize( stream, tag, data ); }
+	inline ::lib::data::result_t deserialize( ::lib::data::rstream_t & stream ) override
+	{ return ::lib::data::deserialize( stream, tag, data ); }
+	using PacketBase::deserialize;
+	inline bool serialize_chunked( ::lib::data::chunked_t & chunked ) const override
+	{ chunked.serialize( tag, data ); return true; }
+	inline bool deserialize_chunked( ::lib::data::chunked_t & chunked ) override
+	{ chunked.deserialize( tag, data ); return true; }
+};
+
+/// @brief Counts serialize() calls.
+struct Counter : PacketBase {
+	static constexpr auto ID = 3;
+	::lib::u64 value = 0;
+	mutable ::lib::usize serialized = 0;
+
+	inline ::lib::data::result_t serialized_size( ::lib::data::wstream_t & stream ) const override
+	{ return ::lib::data::serialized_size( stream, value ); }
+	inline bool can_deserialize( ::lib::data::rstream_t & stream ) const override
+	{ return ::lib::data::can_deserialize( stream, value ); }
+	inline ::lib::data::result_t serialize( ::lib::data::wstream_t & stream ) const override
+	{ ++serialized; return ::lib::data::serialize( stream, value ); }
+	inline ::lib::data::result_t deserialize( ::lib::data::rstream_t & stream ) override
+	{ return ::lib::data::deserialize( stream, value ); }
+	using PacketBase::deserialize;
+};
+
+/// @brief Size of the packet is unknown.
+struct Unsized : Counter {
+	inline ::lib::data::result_t serialized_size( ::lib::data::wstream_t & /*stream*/ ) const override
+	{ return ::lib::make_error_not_implemented(); }
+};
+
+/// @brief Keeps the last Counter instead of sending it.
+struct CounterAggregator : ::lib::packets::Handler::ISendAggregator {
+	CounterAggregator() noexcept : ISendAggregator{ Counter::ID } {}
+	void process( ::lib::packets::Header::id_type /*id*/, const ::lib::tag_serializeable & packet ) noexcept override
+	{ ++processed; value = static_cast<const Counter&>( packet ).value; }
+	void flush( ::lib::packets::Handler & /*handler*/ ) noexcept override { ++flushed; }
+	void reset() noexcept override {}
+	::lib::usize processed = 0;
+	::lib::usize flushed = 0;
+	::lib::u64 value = 0;
+};
+
+/// @brief Deserialized into the arena of the handler, if any.
+struct Names : PacketBase {
+	static constexpr auto ID = 4;
+	::std::pmr::vector< ::std::pmr::string > names;
+
+	inline ::lib::data::result_t serialized_size( ::lib::data::wstream_t & stream ) const override
+	{ return ::lib::data::serialized_size( stream, names ); }
+	inline bool can_deserialize( ::lib::data::rstream_t & stream ) const override
+	{ return ::lib::data::can_deserialize( stream, names ); }
+	inline ::lib::data::result_t serialize( ::lib::data::wstream_t & stream ) const override
+	{ return ::lib::data::serialize( stream, names ); }
+	inline ::lib::data::result_t deserialize( ::lib::data::rstream_t & stream ) override
+	{ return ::lib::data::deserialize( stream, names ); }
+	inline ::lib::data::result_t deserialize( void * context, ::lib::data::rstream_t & stream ) override
+	{ return ::lib::data::deserialize( context, stream, names ); }
+};
+
+/// @brief Stream which doesn't expose its memory (read_cbuffer() is empty), like sockets.
+class OpaqueStream final
+	: public ::lib::data::rwstream_t
+{
+public:
+	explicit OpaqueStream( ::lib::data::rwstream_t & stream ) : stream{ stream } {}
+	::lib::data::result_t read( const ::lib::data::buffer_t & buffer ) override { return stream.read( buffer ); }
+	::lib::data::result_t read_size() override { return stream.read_size(); }
+	::std::error_condition read_error() const override { return stream.read_error(); }
+	::lib::data::result_t write( const ::lib::data::cbuffer_t & buffer ) override { return stream.write( buffer ); }
+	::lib::data::result_t write_size() override { return stream.write_size(); }
+	::std::error_condition write_error() const override { return stream.write_error(); }
+	::std::error_condition error() const override { return stream.error(); }
+	bool flush() override { return stream.flush(); }
+	::lib::data::result_t size() override { return stream.size(); }
+private:
+	::lib::data::rwstream_t & stream;
+};
+
+/// @brief Stream which accepts at most `limit` bytes per write, like a socket with a full send buffer.
+class TrickleStream final
+	: public ::lib::data::rwstream_t
+{
+public:
+	TrickleStream( ::lib::data::rwstream_t & stream, ::lib::usize limit ) : stream{ stream }, limit{ limit } {}
+	::lib::data::result_t read( const ::lib::data::buffer_t & buffer ) override { return stream.read( buffer ); }
+	::lib::data::result_t read_size() override { return stream.read_size(); }
+	::std::error_condition read_error() const override { return stream.read_error(); }
+	::lib::data::result_t write( const ::lib::data::cbuffer_t & buffer ) override
+	{ return stream.write({ buffer.data(), ::std::min( buffer.size(), limit ) }); }
+	::lib::data::result_t write_size() override { return stream.write_size(); }
+	::std::error_condition write_error() const override { return stream.write_error(); }
+	::std::error_condition error() const override { return stream.error(); }
+	bool flush() override { return stream.flush(); }
+	::lib::data::result_t size() override { return stream.size(); }
+private:
+	::lib::data::rwstream_t & stream;
+	::lib::usize limit;
+};
+
 class PacketsHandler
 	: public ::lib::packets::ReadHandler
 	, public ::lib::tag_tl_listener< PacketsHandler >
@@ -101,9 +227,48 @@ private:
 	::lib::packets::impl::PingCounter ping_counter;
 };
 
+struct Inbox : ::lib::tag_tl_listener< Inbox > {
+	bool onMessage( const ::lib::tag_serializeable & message ) {
+		messages.push_back( static_cast<const Message&>( message ).message );
+		return true;
+	}
+	bool onBlob( const ::lib::tag_serializeable & blob_ ) {
+		const auto & blob = static_cast<const Blob&>( blob_ );
+		blobs.push_back( blob.data );
+		return blob.tag == 7;
+	}
+	::std::vector< ::std::string > messages;
+	bool onCounter( const ::lib::tag_serializeable & counter ) {
+		counters.push_back( static_cast<const Counter&>( counter ).value );
+		return true;
+	}
+	bool onNames( const ::lib::tag_serializeable & names_ ) {
+		const auto & names = static_cast<const Names&>( names_ ).names;
+		names_resource = names.get_allocator().resource();
+		for ( const auto & name : names )
+			messages.emplace_back( name );
+		return true;
+	}
+	::std::vector< ::std::vector< ::lib::u8 > > blobs;
+	::std::vector< ::lib::u64 > counters;
+	::std::pmr::memory_resource * names_resource = nullptr;
+};
+
 } // namespace
 
 void Handler::test_execute() noexcept/* override*/ {
+	CPPLIB__TEST__SUBTEST( tcp );
+	CPPLIB__TEST__SUBTEST( varint_header );
+	CPPLIB__TEST__SUBTEST( chunked );
+	CPPLIB__TEST__SUBTEST( broadcast );
+	CPPLIB__TEST__SUBTEST( batch );
+	CPPLIB__TEST__SUBTEST( payload_view );
+	CPPLIB__TEST__SUBTEST( dispatcher );
+	CPPLIB__TEST__SUBTEST( stats );
+	CPPLIB__TEST__SUBTEST( arena );
+}
+
+void Handler::tcp() noexcept {
 	static constexpr auto sleep = []( auto ms ) { ::std::this_thread::sleep_for( ms ); };
 	using namespace ::std::literals::chrono_literals;
 
@@ -123,6 +288,7 @@ void Handler::test_execute() noexcept/* override*/ {
 		}};
 
 		CPPLIB__TEST__TRUE( client.connect( SOCKET_ADDR, SOCKET_PORT ) );
+		CPPLIB__TEST__TRUE( client.set_nodelay( true ) );
 
 		PacketsHandler handler( client );
 		CPPLIB__TEST__TRUE( client.update() );
@@ -240,4 +406,579 @@ void Handler::test_execute() noexcept/* override*/ {
 	CPPLIB__TEST__TRUE( server.close() );
 }
 
+void Handler::varint_header() noexcept {
+	using namespace ::lib;
+	constexpr u32 FAR_ID = 300;
+
+	::lib::stream::impl::fifo stream;
+	::lib::packets::ReadHandler handler;
+	Inbox inbox;
+	Message message_packet;
+	handler.listen( Message::ID, &message_packet, { inbox, &Inbox::onMessage } );
+	handler.listen( FAR_ID, &message_packet, { inbox, &Inbox::onMessage } );
+	handler.header_format( ::lib::packets::Handler::HeaderFormat::VARINT );
+	handler.reset( &stream );
+
+	// Payload: ( 4 + 1 ) + ( 4 + 2 ) bytes, header: 1 byte id and 1 byte size.
+	CPPLIB__TEST__TRUE( handler.send( Message{ "hi", "t" } ) );
+	CPPLIB__TEST__EQ( stream.read_size(), 2_sz + 11 );
+	CPPLIB__TEST__TRUE( handler.send( FAR_ID, Message{ "far", "t" } ) );
+	CPPLIB__TEST__EQ( stream.read_size(), 2_sz + 11 + 3 + 12 );
+	CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::SUCCESS );
+	CPPLIB__TEST__EQ( inbox.messages.size(), 2 );
+	CPPLIB__TEST__EQ( inbox.messages[0], "hi" );
+	CPPLIB__TEST__EQ( inbox.messages[1], "far" );
+
+	// Incomplete header is left in the stream until the rest arrives.
+	const Message far { "far", "t" };
+	const ::lib::packets::Header far_header { FAR_ID, 12 };
+	u8 header[::lib::packets::VARINT_HEADER_SIZE_MAX];
+	const auto header_size = ::lib::packets::encode( ::lib::data::varint{far_header}, header );
+	CPPLIB__TEST__EQ( header_size, 3_sz );
+	CPPLIB__TEST__EQ( stream.write({ header, 1 }), 1_sz );
+	CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( stream.read_size(), 1_sz );
+	CPPLIB__TEST__EQ( handler.recv_header().id, 0 );
+	CPPLIB__TEST__EQ( stream.write({ header + 1, header_size - 1 }), header_size - 1 );
+	CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( handler.recv_header().id, FAR_ID );
+	CPPLIB__TEST__EQ( far.serialize( stream ), 12_sz );
+	CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( inbox.messages.size(), 3 );
+	CPPLIB__TEST__EQ( handler.recv_header().id, 0 );
+
+	// Malformed header (u32 field longer than 5 bytes) breaks the handler instead of waiting for more bytes.
+	const u8 malformed[10] { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 };
+	CPPLIB__TEST__EQ( stream.write({ malformed, sizeof( malformed ) }), sizeof( malformed ) );
+	CPPLIB__TEST__FALSE( handler.receive() );
+	CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::RECEIVE_HEADER_BAD );
+	CPPLIB__TEST__EQ( inbox.messages.size(), 3 );
+
+	// Six continuation bytes are already malformed, no need to wait for the rest.
+	::lib::stream::impl::fifo short_stream;
+	handler.reset( &short_stream );
+	CPPLIB__TEST__EQ( short_stream.write({ malformed, 6 }), 6_sz );
+	CPPLIB__TEST__FALSE( handler.receive() );
+	CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::RECEIVE_HEADER_BAD );
+	u8 bytes[::lib::packets::VARINT_HEADER_SIZE_MAX] { 0x01, 0x80, 0x80, 0x80, 0x80, 0x10 };
+	::lib::packets::Header decoded;
+	CPPLIB__TEST__TRUE( ::lib::packets::detail::decode( bytes, 6, decoded ).failed() );
+	bytes[5] = 0x0f;
+	CPPLIB__TEST__EQ( ::lib::packets::detail::decode( bytes, 6, decoded ), 6_sz );
+	CPPLIB__TEST__EQ( decoded.size, 0xf0000000 );
+	CPPLIB__TEST__EQ( ::lib::packets::detail::decode( bytes, 5, decoded ), 0_sz );
+}
+
+void Handler::chunked() noexcept {
+	using namespace ::lib;
+	static constexpr usize WIRE_SIZE = 4 * 1024;
+
+	// Sender's stream accepts at most WIRE_SIZE bytes per update, the receiver gets them as they come.
+	::std::array<u8, WIRE_SIZE> wire_storage {};
+	::lib::stream::impl::data wire {::lib::data::buffer_t {wire_storage}};
+	::lib::stream::impl::fifo stream;
+	::lib::packets::ReadHandler sender;
+	::lib::packets::ReadHandler receiver;
+	Inbox inbox;
+	Blob blob_packet;
+	::lib::packets::Stats stats;
+	sender.attach_stats( &stats );
+	sender.reset( &wire );
+	receiver.listen( Blob::ID, &blob_packet, { inbox, &Inbox::onBlob } );
+	receiver.reset( &stream );
+
+	Blob blob;
+	blob.tag = 7;
+	blob.data.resize( 1024 * 1024 + 3 );
+	for ( usize i = 0; i < blob.data.size(); ++i )
+		blob.data[i] = (u8)( i * 7 );
+	CPPLIB__TEST__TRUE( sender.send( blob ) );
+	CPPLIB__TEST__TRUE( sender.send_pending() );
+	// Accounted as sent once written completely.
+	CPPLIB__TEST__EQ( stats.snapshot().find( Blob::ID ), nullptr );
+
+	for ( usize update = 0; inbox.blobs.empty(); ++update ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__LT( update, blob.data.size() / WIRE_SIZE + 2 );
+		CPPLIB__TEST__TRUE( sender.send_continue() );
+		const auto & written = wire.write_pos();
+		CPPLIB__TEST__EQ( stream.write({ wire_storage.data(), written.value() }), written );
+		CPPLIB__TEST__TRUE( wire.write_flush() );
+		CPPLIB__TEST__TRUE( receiver.receive() );
+		// Payload doesn't pile up on the receiver side.
+		CPPLIB__TEST__EQ( stream.read_size(), 0_sz );
+		CPPLIB__TEST__TRUE( stream.read_flush() );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__FALSE( sender.send_pending() );
+	CPPLIB__TEST__EQ( sender.error(), ::lib::packets::Handler::Error::SUCCESS );
+	CPPLIB__TEST__EQ( stats.snapshot().find( Blob::ID )->sent, 1_u64 );
+	CPPLIB__TEST__EQ( stats.snapshot().find( Blob::ID )->sent_bytes, sizeof(::lib::packets::Header) + 4 + 4 + blob.data.size() );
+	sender.attach_stats( nullptr );
+	CPPLIB__TEST__EQ( receiver.error(), ::lib::packets::Handler::Error::SUCCESS );
+	CPPLIB__TEST__EQ( inbox.blobs.size(), 1 );
+	CPPLIB__TEST__EQ( inbox.blobs[0], blob.data );
+
+	// Forged length of the data field: bigger than the payload it is in, nothing is allocated.
+	const ::lib::packets::Header forged { Blob::ID, 64 * 1024 + 1 };	// Over Handler::GATHER_SIZE_MAX.
+	blob_packet.data.clear();
+	const u32 forged_length = 0xffffffff;
+	CPPLIB__TEST__TRUE( ::lib::data::serialize( stream, forged, blob.tag, forged_length ).success() );
+	CPPLIB__TEST__EQ( stream.write({ blob.data.data(), 16 }), 16_sz );
+	CPPLIB__TEST__FALSE( receiver.receive() );
+	CPPLIB__TEST__EQ( receiver.error(), ::lib::packets::Handler::Error::RECEIVE_DATA_DESERIALIZE_FAILED );
+	CPPLIB__TEST__TRUE( receiver.deserialize_error() == ::lib::make_error_bad_data() );
+	CPPLIB__TEST__EQ( inbox.blobs.size(), 1 );
+	CPPLIB__TEST__TRUE( blob_packet.data.empty() );
+}
+
+void Handler::broadcast() noexcept {
+	using namespace ::lib;
+	static constexpr usize TARGETS = 3;
+	static constexpr ::lib::packets::Handler::id_type FAR_ID = 300;
+
+	// Targets differ in header format and packet id, payload is the same.
+	::std::array<::lib::stream::impl::fifo, TARGETS> streams;
+	::std::array<::lib::packets::ReadHandler, TARGETS> handlers;
+	::std::array<Counter, TARGETS> packets;
+	Inbox inbox;
+	::lib::packets::Broadcaster broadcaster;
+	for ( usize i = 0; i < TARGETS; ++i ) {
+		const auto id = i == 2 ? FAR_ID : Counter::ID;
+		handlers[i].listen( id, &packets[i], { inbox, &Inbox::onCounter } );
+		if ( i > 0 )
+			handlers[i].header_format( ::lib::packets::Handler::HeaderFormat::VARINT );
+		handlers[i].reset( &streams[i] );
+		broadcaster.attach( handlers[i], id );
+	}
+	CPPLIB__TEST__EQ( broadcaster.size(), TARGETS );
+
+	Counter counter;
+	counter.value = 0x1234;
+	CPPLIB__TEST__EQ( broadcaster.send( counter ), TARGETS );
+	CPPLIB__TEST__EQ( counter.serialized, 1_sz );
+	CPPLIB__TEST__EQ( broadcaster.payload().size(), sizeof(counter.value) );
+	CPPLIB__TEST__EQ( streams[0].read_size(), sizeof(::lib::packets::Header) + 8 );
+	CPPLIB__TEST__EQ( streams[1].read_size(), 2_sz + 8 );
+	CPPLIB__TEST__EQ( streams[2].read_size(), 3_sz + 8 );
+	for ( auto & handler : handlers )
+		CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( inbox.counters.size(), TARGETS );
+	for ( const auto value : inbox.counters )
+		CPPLIB__TEST__EQ( value, counter.value );
+
+	// Detached handler doesn't get the next packet.
+	broadcaster.detach( handlers[1] );
+	counter.value = 42;
+	CPPLIB__TEST__EQ( broadcaster.send( counter ), TARGETS - 1 );
+	CPPLIB__TEST__EQ( streams[1].read_size(), 0_sz );
+	for ( auto & handler : handlers )
+		CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( inbox.counters.size(), TARGETS * 2 - 1 );
+	CPPLIB__TEST__EQ( inbox.counters.back(), 42_u64 );
+	for ( const auto & handler : handlers )
+		CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::SUCCESS );
+
+	// Packet which fails to tell its size isn't sent at all.
+	const Unsized unsized;
+	CPPLIB__TEST__EQ( broadcaster.send( unsized ), 0_sz );
+	CPPLIB__TEST__EQ( unsized.serialized, 0_sz );
+	for ( auto & stream : streams )
+		CPPLIB__TEST__EQ( stream.read_size(), 0_sz );
+
+	// Handler aggregating the id gets the packet through its aggregator, the others get the payload.
+	const auto aggregator = MkSPtr<CounterAggregator>();
+	CPPLIB__TEST__TRUE( handlers[0].attach_aggregator( aggregator ) );
+	CPPLIB__TEST__TRUE( handlers[0].aggregated( Counter::ID ) );
+	CPPLIB__TEST__FALSE( handlers[2].aggregated( FAR_ID ) );
+	counter.value = 7;
+	counter.serialized = 0;
+	CPPLIB__TEST__EQ( broadcaster.send( counter ), TARGETS - 1 );
+	CPPLIB__TEST__EQ( counter.serialized, 1_sz );
+	CPPLIB__TEST__EQ( aggregator->processed, 1_sz );
+	CPPLIB__TEST__EQ( aggregator->value, 7_u64 );
+	CPPLIB__TEST__EQ( streams[0].read_size(), 0_sz );
+	CPPLIB__TEST__EQ( streams[2].read_size(), 3_sz + 8 );
+	CPPLIB__TEST__TRUE( handlers[2].receive() );
+	CPPLIB__TEST__EQ( inbox.counters.back(), 7_u64 );
+	// Aggregated packets are flushed once something else is sent.
+	CPPLIB__TEST__TRUE( handlers[0].send( Message{ "flush", "aggregator" } ) );
+	CPPLIB__TEST__EQ( aggregator->flushed, 1_sz );
+}
+
+void Handler::batch() noexcept {
+	using namespace ::lib;
+	using Op = ::lib::stream::impl::metered::Op;
+
+	::lib::stream::impl::fifo fifo;
+	::lib::stream::impl::metered stream {&fifo};
+	::lib::packets::ReadHandler handler;
+	Inbox inbox;
+	Message message_packet;
+	Counter counter_packet;
+	Blob blob_packet;
+	handler.listen( Message::ID, &message_packet, { inbox, &Inbox::onMessage } );
+	handler.listen( Counter::ID, &counter_packet, { inbox, &Inbox::onCounter } );
+	handler.listen( Blob::ID, &blob_packet, { inbox, &Inbox::onBlob } );
+	handler.reset( &stream );
+
+	// Nothing is written until the outermost batch ends, then everything goes with a single write.
+	handler.begin_batch();
+	CPPLIB__TEST__TRUE( handler.batching() );
+	CPPLIB__TEST__TRUE( handler.send( Message{ "first", "t" } ) );
+	handler.begin_batch();
+	Counter counter;
+	counter.value = 5;
+	CPPLIB__TEST__TRUE( handler.send( counter ) );
+	CPPLIB__TEST__TRUE( handler.end_batch() );
+	const u64 raw = 6;
+	CPPLIB__TEST__TRUE( handler.send_serialized( Counter::ID, { &raw, sizeof(raw) } ) );
+	CPPLIB__TEST__EQ( stream[Op::WRITE].calls.load(), 0_u64 );
+	CPPLIB__TEST__EQ( fifo.read_size(), 0_sz );
+	CPPLIB__TEST__TRUE( handler.end_batch() );
+	CPPLIB__TEST__FALSE( handler.batching() );
+	CPPLIB__TEST__EQ( stream[Op::WRITE].calls.load(), 1_u64 );
+	CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( inbox.messages.size(), 1 );
+	CPPLIB__TEST__EQ( inbox.messages[0], "first" );
+	CPPLIB__TEST__EQ( inbox.counters.size(), 2 );
+	CPPLIB__TEST__EQ( inbox.counters[0], 5_u64 );
+	CPPLIB__TEST__EQ( inbox.counters[1], 6_u64 );
+
+	// Big packet writes the batch first, so the order is kept.
+	Blob blob;
+	blob.tag = 7;
+	blob.data.resize( 128 * 1024 );
+	handler.begin_batch();
+	CPPLIB__TEST__TRUE( handler.send( Message{ "before", "t" } ) );
+	CPPLIB__TEST__TRUE( handler.send( blob ) );
+	while ( handler.send_pending() ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__TRUE( handler.send_continue() );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__TRUE( handler.send( Message{ "after", "t" } ) );
+	CPPLIB__TEST__TRUE( handler.end_batch() );
+	CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::SUCCESS );
+	CPPLIB__TEST__EQ( inbox.messages.size(), 3 );
+	CPPLIB__TEST__EQ( inbox.messages[1], "before" );
+	CPPLIB__TEST__EQ( inbox.messages[2], "after" );
+	CPPLIB__TEST__EQ( inbox.blobs.size(), 1 );
+	CPPLIB__TEST__EQ( inbox.blobs[0], blob.data );
+
+	// Partially written batch keeps its tail, packets are accounted as sent once written.
+	TrickleStream trickle {fifo, 20};
+	::lib::packets::Stats stats;
+	handler.reset( &trickle );
+	handler.attach_stats( &stats );
+	handler.begin_batch();
+	for ( u64 value = 10; value < 13; ++value ) {
+		counter.value = value;
+		CPPLIB__TEST__TRUE( handler.send( counter ) );
+	}
+	CPPLIB__TEST__EQ( stats.snapshot().find( Counter::ID )->sent, 0_u64 );
+	CPPLIB__TEST__FALSE( handler.end_batch() );
+	CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::SEND_DATA_PARTIAL );
+	CPPLIB__TEST__TRUE( handler.send_pending() );
+	CPPLIB__TEST__EQ( stats.snapshot().find( Counter::ID )->sent, 1_u64 );
+	CPPLIB__TEST__FALSE( handler.send( counter ) );
+	while ( handler.send_pending() ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__TRUE( handler.send_continue() );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	const auto wire = sizeof(::lib::packets::Header) + sizeof(counter.value);
+	CPPLIB__TEST__EQ( stats.snapshot().find( Counter::ID )->sent, 3_u64 );
+	CPPLIB__TEST__EQ( stats.snapshot().find( Counter::ID )->sent_bytes, 3 * wire );
+	CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( inbox.counters.size(), 5 );
+	CPPLIB__TEST__EQ( inbox.counters[2], 10_u64 );
+	CPPLIB__TEST__EQ( inbox.counters[4], 12_u64 );
+	handler.attach_stats( nullptr );
+}
+
+void Handler::payload_view() noexcept {
+	using namespace ::lib;
+
+	::lib::stream::impl::fifo stream;
+	::lib::packets::ReadHandler handler;
+	Inbox inbox;
+	Message message_packet;
+	handler.listen( Message::ID, &message_packet, { inbox, &Inbox::onMessage } );
+	handler.reset( &stream );
+
+	struct Relay : ::lib::tag_tl_listener< Relay > {
+		bool onPayload( const ::lib::packets::Header & header, const ::lib::data::cbuffer_t & payload ) {
+			ids.push_back( header.id );
+			payloads.emplace_back( payload.begin(), payload.end() );
+			memory.push_back( payload.data() );
+			unread.push_back( stream->read_size().value() );
+			return true;
+		}
+		::lib::data::rwstream_t * stream = nullptr;
+		::std::vector< ::lib::packets::Header::id_type > ids;
+		::std::vector< ::std::vector< ::lib::u8 > > payloads;
+		::std::vector< const ::lib::u8 * > memory;
+		::std::vector< ::lib::usize > unread;
+	} relay;
+	relay.stream = &stream;
+	handler.listen_payload( Blob::ID, { relay, &Relay::onPayload } );
+
+	Blob blob;
+	blob.tag = 7;
+	blob.data = { 1, 2, 3, 4, 5 };
+	const auto blob_size = blob.serialized_size( stream ).value();
+	CPPLIB__TEST__TRUE( handler.send( blob ) );
+	CPPLIB__TEST__TRUE( handler.send( Message{ "next", "t" } ) );
+	const auto * memory = stream.read_cbuffer( false ).data();
+	CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::SUCCESS );
+	CPPLIB__TEST__EQ( relay.ids.size(), 1 );
+	CPPLIB__TEST__EQ( relay.ids[0], (::lib::u32) Blob::ID );
+	// Payload is the stream memory right after the header, still unread during the call.
+	CPPLIB__TEST__EQ( relay.memory[0], memory + sizeof(::lib::packets::Header) );
+	CPPLIB__TEST__TRUE( relay.unread[0] >= blob_size );
+	::lib::stream::impl::data payload {::lib::data::cbuffer_t {relay.payloads[0]}};
+	Blob blob_;
+	CPPLIB__TEST__EQ( blob_.deserialize( payload ), blob_size );
+	CPPLIB__TEST__EQ( blob_.data, blob.data );
+	// Packets after it are deserialized as usual.
+	CPPLIB__TEST__EQ( inbox.messages.size(), 1 );
+	CPPLIB__TEST__EQ( inbox.messages[0], "next" );
+	CPPLIB__TEST__EQ( stream.read_size(), 0_sz );
+
+	// Stream without memory view: payload is copied.
+	OpaqueStream opaque {stream};
+	relay.stream = &opaque;
+	handler.reset( &opaque );
+	CPPLIB__TEST__TRUE( handler.send( blob ) );
+	CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::SUCCESS );
+	CPPLIB__TEST__EQ( relay.payloads.size(), 2 );
+	CPPLIB__TEST__EQ( relay.payloads[1], relay.payloads[0] );
+	CPPLIB__TEST__EQ( stream.read_size(), 0_sz );
+
+	// Ring stream: payloads crossing the storage end are copied, the others are viewed.
+	::lib::stream::impl::spsc ring {64};
+	relay.stream = &ring;
+	handler.reset( &ring );
+	usize crossed = 0;
+	for ( usize i = 0; i < 10; ++i ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__TRUE( handler.send( blob ) );
+		if ( ring.read_cbuffer( false ).size() < ring.read_size().value() )
+			++crossed;
+		CPPLIB__TEST__TRUE( handler.receive() );
+		CPPLIB__TEST__TRUE( ring.read_flush() );
+		CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::SUCCESS );
+		CPPLIB__TEST__EQ( relay.payloads.back(), relay.payloads[0] );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__GT( crossed, 0_sz );
+	CPPLIB__TEST__EQ( relay.payloads.size(), 12 );
+
+	// Block chain: same for payloads crossing block boundaries.
+	::lib::stream::impl::chain blocks {16};
+	relay.stream = &blocks;
+	handler.reset( &blocks );
+	crossed = 0;
+	for ( usize i = 0; i < 10; ++i ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__TRUE( handler.send( blob ) );
+		if ( blocks.read_cbuffer( false ).size() < blocks.read_size().value() )
+			++crossed;
+		CPPLIB__TEST__TRUE( handler.receive() );
+		CPPLIB__TEST__TRUE( blocks.read_flush() );
+		CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::SUCCESS );
+		CPPLIB__TEST__EQ( relay.payloads.back(), relay.payloads[0] );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__GT( crossed, 0_sz );
+	CPPLIB__TEST__EQ( relay.payloads.size(), 22 );
+}
+
+void Handler::dispatcher() noexcept {
+	using namespace ::lib;
+	static constexpr usize COUNTERS = 1000;
+
+	struct Sink : ::lib::tag_tl_listener< Sink > {
+		bool onCounter( const ::lib::packets::Header &, const ::lib::data::cbuffer_t & payload ) {
+			u64 value = 0;
+			::std::memcpy( &value, payload.data(), sizeof(value) );
+			::std::lock_guard lock {mutex};
+			counters.push_back( value );
+			threads.push_back( ::std::this_thread::get_id() );
+			return true;
+		}
+		bool onMessage( const ::lib::packets::Header & header, const ::lib::data::cbuffer_t & payload ) {
+			::lib::stream::impl::data stream {payload};
+			Message message;
+			const auto & readen = message.deserialize( stream );
+			::std::lock_guard lock {mutex};
+			messages.push_back( message.message );
+			return readen.success() and readen.value() == header.size and message.title == "t";
+		}
+		::std::mutex mutex;
+		::std::vector< u64 > counters;
+		::std::vector< ::std::thread::id > threads;
+		::std::vector< ::std::string > messages;
+	} sink;
+
+	::lib::stream::impl::fifo stream;
+	::lib::packets::ReadHandler handler;
+	handler.reset( &stream );
+	{
+		::lib::packets::Dispatcher dispatcher {2};
+		CPPLIB__TEST__EQ( dispatcher.workers(), 2_sz );
+		dispatcher.listen( handler, Counter::ID, Counter::ID, { sink, &Sink::onCounter } );
+		dispatcher.listen( handler, Message::ID, Message::ID, { sink, &Sink::onMessage } );
+
+		Counter counter;
+		for ( usize i = 0; i < COUNTERS; ++i ) {
+			counter.value = i;
+			CPPLIB__TEST__TRUE( handler.send( counter ) );
+			if ( i % 100 == 0 )
+				CPPLIB__TEST__TRUE( handler.send( Message{ "m", "t" } ) );
+			if ( i % 10 == 0 )
+				CPPLIB__TEST__TRUE( handler.receive() );
+		}
+		CPPLIB__TEST__TRUE( handler.receive() );
+		CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::SUCCESS );
+		CPPLIB__TEST__EQ( stream.read_size(), 0_sz );
+		dispatcher.wait();
+		CPPLIB__TEST__EQ( dispatcher.failed(), 0_sz );
+
+		// Last payloads are queued only, destructor processes them before workers stop.
+		CPPLIB__TEST__TRUE( handler.send( Message{ "last", "t" } ) );
+		CPPLIB__TEST__TRUE( handler.receive() );
+	}
+	// Jobs of the same key keep the order and run on the same worker.
+	CPPLIB__TEST__EQ( sink.counters.size(), COUNTERS );
+	for ( usize i = 0; i < COUNTERS; ++i ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__EQ( sink.counters[i], i );
+		CPPLIB__TEST__TRUE( sink.threads[i] == sink.threads[0] );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	CPPLIB__TEST__TRUE( sink.threads[0] != ::std::this_thread::get_id() );
+	CPPLIB__TEST__EQ( sink.messages.size(), COUNTERS / 100 + 1 );
+	CPPLIB__TEST__EQ( sink.messages.back(), "last" );
+
+	// Dispatcher has unlistened its ids.
+	CPPLIB__TEST__TRUE( handler.send( Counter{} ) );
+	CPPLIB__TEST__FALSE( handler.receive() );
+	CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::RECEIVE_HEADER_BAD_ID );
+}
+
+void Handler::stats() noexcept {
+	using namespace ::lib;
+	using Error = ::lib::packets::Handler::Error;
+	static constexpr ::lib::packets::Handler::id_type FAR_ID = 300;
+
+	::lib::stream::impl::fifo stream;
+	::lib::packets::ReadHandler handler;
+	::lib::packets::Stats stats;
+	Inbox inbox;
+	Message message_packet;
+	Counter counter_packet;
+	handler.listen( Message::ID, &message_packet, { inbox, &Inbox::onMessage } );
+	handler.listen( Counter::ID, &counter_packet, { inbox, &Inbox::onCounter } );
+	handler.attach_stats( &stats );
+	handler.reset( &stream );
+
+	for ( const auto * text : { "a", "bb", "ccc" } )
+		CPPLIB__TEST__TRUE( handler.send( Message{ text, "t" } ) );
+	Counter counter;
+	handler.begin_batch();
+	CPPLIB__TEST__TRUE( handler.send( counter ) );
+	CPPLIB__TEST__TRUE( handler.send( counter ) );
+	CPPLIB__TEST__TRUE( handler.end_batch() );
+	const auto written = stream.read_size().value();
+	CPPLIB__TEST__TRUE( handler.receive() );
+	CPPLIB__TEST__EQ( inbox.messages.size(), 3_sz );
+	CPPLIB__TEST__EQ( inbox.counters.size(), 2_sz );
+
+	auto snapshot = stats.snapshot();
+	CPPLIB__TEST__EQ( snapshot.ids.size(), 2_sz );
+	const auto * messages = snapshot.find( Message::ID );
+	const auto * counters = snapshot.find( Counter::ID );
+	CPPLIB__TEST__TRUE( messages != nullptr and counters != nullptr );
+	CPPLIB__TEST__TRUE( snapshot.find( FAR_ID ) == nullptr );
+	CPPLIB__TEST__EQ( messages->sent, 3_u64 );
+	CPPLIB__TEST__EQ( messages->received, 3_u64 );
+	CPPLIB__TEST__EQ( messages->receiver_ns.count(), 3_u64 );
+	CPPLIB__TEST__EQ( counters->sent, 2_u64 );
+	CPPLIB__TEST__EQ( counters->received, 2_u64 );
+	// Bytes are counted as they are on the wire.
+	CPPLIB__TEST__EQ( counters->sent_bytes, 2 * ( sizeof(::lib::packets::Header) + sizeof(u64) ) );
+	CPPLIB__TEST__EQ( messages->sent_bytes + counters->sent_bytes, written );
+	CPPLIB__TEST__EQ( messages->received_bytes + counters->received_bytes, written );
+
+	// Sent packets are accounted to their id, received unknown ids - to id 0.
+	CPPLIB__TEST__TRUE( handler.send( FAR_ID, Blob{} ) );
+	CPPLIB__TEST__FALSE( handler.receive() );
+	CPPLIB__TEST__EQ( handler.error(), Error::RECEIVE_HEADER_BAD_ID );
+	snapshot = stats.snapshot();
+	const auto * blobs = snapshot.find( FAR_ID );
+	CPPLIB__TEST__TRUE( blobs != nullptr );
+	CPPLIB__TEST__EQ( blobs->sent, 1_u64 );
+	CPPLIB__TEST__EQ( blobs->received, 0_u64 );
+	CPPLIB__TEST__EQ( blobs->errors[(usize) Error::RECEIVE_HEADER_BAD_ID], 0_u64 );
+	const auto * unknown = snapshot.find( 0 );
+	CPPLIB__TEST__TRUE( unknown != nullptr );
+	CPPLIB__TEST__EQ( unknown->errors[(usize) Error::RECEIVE_HEADER_BAD_ID], 1_u64 );
+
+	// Forged id doesn't make the stats grow with it.
+	::lib::stream::impl::fifo forged_stream;
+	const ::lib::packets::Header forged { 0xffffffff, 0 };
+	CPPLIB__TEST__TRUE( ::lib::data::serialize( forged_stream, forged ).success() );
+	handler.reset( &forged_stream );
+	CPPLIB__TEST__FALSE( handler.receive() );
+	CPPLIB__TEST__EQ( handler.error(), Error::RECEIVE_HEADER_BAD_ID );
+	snapshot = stats.snapshot();
+	CPPLIB__TEST__TRUE( snapshot.find( forged.id ) == nullptr );
+	CPPLIB__TEST__EQ( snapshot.find( 0 )->errors[(usize) Error::RECEIVE_HEADER_BAD_ID], 2_u64 );
+
+	const auto & json = snapshot.json();
+	CPPLIB__TEST__TRUE( json.contains( "\"1\":{\"sent\":3," ) );
+	CPPLIB__TEST__TRUE( json.contains( "\"errors\":{\"receive-header bad id\":2}" ) );
+	CPPLIB__TEST__TRUE( snapshot.text().contains( "receive-header bad id: 2" ) );
+
+	stats.clear();
+	CPPLIB__TEST__TRUE( stats.snapshot().ids.empty() );
+	CPPLIB__TEST__EQ( stats.snapshot().json(), "{}" );
+}
+
+void Handler::arena() noexcept {
+	using namespace ::lib;
+
+	::lib::stream::impl::fifo stream;
+	::lib::data::arena_t arena;
+	::lib::packets::ReadHandler handler;
+	Inbox inbox;
+	Names names_packet;
+	handler.listen( Names::ID, &names_packet, { inbox, &Inbox::onNames } );
+	handler.attach_arena( &arena );
+	handler.reset( &stream );
+
+	Names names;
+	names.names = { "a", "bb", ::std::pmr::string( 100, 'c' ) };
+	for ( usize i = 0; i < 2; ++i ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__TRUE( handler.send( names ) );
+		CPPLIB__TEST__TRUE( handler.receive() );
+		CPPLIB__TEST__EQ( handler.error(), ::lib::packets::Handler::Error::SUCCESS );
+		// Receiver sees the packet in the arena, it is left empty and unbound once the receiver returns.
+		CPPLIB__TEST__EQ( inbox.names_resource, arena.resource() );
+		CPPLIB__TEST__EQ( inbox.messages.size(), 3 * ( i + 1 ) );
+		CPPLIB__TEST__EQ( inbox.messages.back(), ::std::string( 100, 'c' ) );
+		CPPLIB__TEST__TRUE( names_packet.names.empty() );
+		CPPLIB__TEST__EQ( names_packet.names.get_allocator().resource(), ::std::pmr::get_default_resource() );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+	handler.reset();
+}
+
 } // namespace test::lib::packets
@@ -19,6 +19,16 @@ public:
 	Handler() noexcept : IUnit {"Handler"} {}
 private:
 	void test_execute() noexcept override;
+
+	void tcp() noexcept;
+	void varint_header() noexcept;
+	void chunked() noexcept;
+	void broadcast() noexcept;
+	void batch() noexcept;
+	void payload_view() noexcept;
+	void dispatcher() noexcept;
+	void stats() noexcept;
+	void arena() noexcept;
 };
 
 } // namespace test::lib::packets
@@ -0,0 +1,116 @@
+/* File: /test/lib/tl/ringfifo.cpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+#include <lib/types.hpp>
+#include <lib/literals.hpp>
+#include <lib/tl/ringfifo.hpp>
+
+#include <lib/impl/stream/fifo.hpp>
+
+#include "./ringfifo.hpp"
+
+namespace test::lib::tl {
+
+void RingFifo::test_execute() noexcept/* override*/ {
+	using namespace ::lib;
+
+	::std::array<u8, 100> data;
+	::std::iota( data.begin(), data.end(), (u8) 0 );
+
+	::lib::tl::ringfifo<u8> ring;
+	CPPLIB__TEST__TRUE( ring.empty() );
+	CPPLIB__TEST__EQ( ring.capacity(), 0 );
+
+	ring.append({ data.data(), 40 });
+	CPPLIB__TEST__EQ( ring.size(), 40 );
+	CPPLIB__TEST__EQ( ring.capacity(), ring.MIN_CAPACITY );
+	CPPLIB__TEST__EQ( ring.segment().size(), 40 );
+
+	// Wrap data around the storage end.
+	ring.consume( 30 );
+	CPPLIB__TEST__EQ( ring.front(), 30 );
+	ring.append({ data.data() + 40, 50 });
+	CPPLIB__TEST__EQ( ring.size(), 60 );
+	CPPLIB__TEST__EQ( ring.capacity(), ring.MIN_CAPACITY );
+	CPPLIB__TEST__EQ( ring.segment().size(), ring.capacity() - 30 );
+	CPPLIB__TEST__EQ( ring.segment( ring.segment().size() ).size(), 60 - ( ring.capacity() - 30 ) );
+	for ( auto i = 0_sz; i < ring.size(); ++i ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__EQ( ring[i], 30 + i );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+
+	::std::array<u8, 100> copy {};
+	CPPLIB__TEST__EQ( ring.copy( copy, 5 ), 55 );
+	CPPLIB__TEST__TRUE( ::std::equal( copy.begin(), copy.begin() + 55, data.begin() + 35 ) );
+
+	const auto & linear = ring.linearize();
+	CPPLIB__TEST__EQ( linear.size(), 60 );
+	CPPLIB__TEST__EQ( ring.segment().size(), 60 );
+	CPPLIB__TEST__TRUE( ::std::equal( linear.begin(), linear.end(), data.begin() + 30 ) );
+
+	// Grow while wrapped.
+	ring.consume( 50 );
+	ring.append( data );
+	CPPLIB__TEST__EQ( ring.size(), 110 );
+	CPPLIB__TEST__EQ( ring.capacity(), 128 );
+	CPPLIB__TEST__EQ( ring.back(), 99 );
+	ring.resize( 112 );
+	CPPLIB__TEST__EQ( ring.back(), 0 );
+	ring.resize( 10 );
+	CPPLIB__TEST__EQ( ring.back(), 89 );
+
+	// Fill spare storage in place.
+	ring.consume( 5 );
+	const auto & spare = ring.spare_segment();
+	CPPLIB__TEST__TRUE( not spare.empty() and spare.size() <= ring.capacity() - 5 );
+	spare[0] = 42;
+	ring.commit( 1 );
+	CPPLIB__TEST__EQ( ring.size(), 6 );
+	CPPLIB__TEST__EQ( ring.back(), 42 );
+	CPPLIB__TEST__EQ( ring.spare_segment().size(), spare.size() - 1 );
+
+	// Few live elements wrapping a big storage.
+	ring.clear();
+	ring.reserve( 4096 );
+	ring.resize( 4090 );
+	ring.consume( 4090 - 3 );
+	ring.append({ data.data(), 7 });
+	CPPLIB__TEST__EQ( ring.segment().size(), 9_sz );
+	const auto & wrapped = ring.linearize();
+	CPPLIB__TEST__EQ( wrapped.size(), 10_sz );
+	CPPLIB__TEST__EQ( ring.segment().size(), 10_sz );
+	CPPLIB__TEST__TRUE( ::std::all_of( wrapped.begin(), wrapped.begin() + 3, []( u8 value ) { return value == 0; } ) );
+	CPPLIB__TEST__TRUE( ::std::equal( wrapped.begin() + 3, wrapped.end(), data.begin() ) );
+
+	ring.clear();
+	ring.shrink_to_fit();
+	CPPLIB__TEST__TRUE( ring.empty() );
+	CPPLIB__TEST__EQ( ring.capacity(), 0 );
+
+	// Stream built on top of the ring.
+	::lib::stream::impl::fifo fifo;
+	for ( auto i = 0_sz; i < 10; ++i ) {
+		CPPLIB__TEST__LOOP_NEXT();
+		CPPLIB__TEST__EQ( fifo.write( data ), data.size() );
+		CPPLIB__TEST__EQ( fifo.read({ copy.data(), 70 }), 70_sz );
+		CPPLIB__TEST__TRUE( fifo.read_flush() );
+		const auto & read_buff = fifo.read_cbuffer( false );
+		CPPLIB__TEST__EQ( read_buff.size(), 30 * ( i + 1 ) );
+		CPPLIB__TEST__EQ( read_buff.back(), 99 );
+		CPPLIB__TEST__EQ( fifo.peek( copy ), ::std::min( copy.size(), read_buff.size() ) );
+		CPPLIB__TEST__EQ( copy[0], ( 70 * ( i + 1 ) ) % 100 );
+	}
+	CPPLIB__TEST__LOOP_RESET();
+}
+
+} // namespace test::lib::tl
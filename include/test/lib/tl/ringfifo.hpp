@@ -0,0 +1,26 @@
+/* File: /test/lib/tl/ringfifo.hpp
+ *
+ * This file is a part of cpplib project which is distributed under MIT License.
+ * See file LICENSE for full license details.
+ *
+ * Copyright (c) 2020-present Nikita Zuev (V.Slavski!) <nikita.zuev@gmx.com>
+ */
+#ifndef CPPLIB__test__lib__tl__ringfifo__hpp
+#define CPPLIB__test__lib__tl__ringfifo__hpp
+
+#include <lib/test/unit.hpp>
+
+namespace test::lib::tl {
+
+class RingFifo final
+	: public ::lib::test::IUnit
+{
+public:
+	RingFifo() noexcept : IUnit {"RingFifo"} {}
+private:
+	void test_execute() noexcept override;
+};
+
+} // namespace test::lib::tl
+
+#endif // CPPLIB__test__lib__tl__ringfifo__hpp
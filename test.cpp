@@ -13,12 +13,14 @@
 #include <test/lib/tl/carray.hpp>
 #include <test/lib/tl/delegate.hpp>
 #include <test/lib/tl/listener.hpp>
+#include <test/lib/tl/ringfifo.hpp>
 
 #include <test/lib/bus.hpp>
 #include <test/lib/cli.hpp>
 #include <test/lib/ecs.hpp>
 #include <test/lib/flags.hpp>
 
+#include <test/lib/data/serialize.hpp>
 #include <test/lib/file/ini.hpp>
 #include <test/lib/packets/handler.hpp>
 
@@ -29,12 +31,20 @@
 #include <test/lib/utils/value.hpp>
 
 #include <test/lib/impl/codec/base64.hpp>
+#include <test/lib/impl/codec/lz.hpp>
 #include <test/lib/impl/hash/sha1.hpp>
+#include <test/lib/impl/stream/buffer.hpp>
+#include <test/lib/impl/stream/chain.hpp>
+#include <test/lib/impl/stream/metered.hpp>
+#include <test/lib/impl/stream/spsc.hpp>
 
 #include <test/lib/impl/socket/tcp.hpp>
 
 #ifdef CPPLIB_PLATFORM_POSIX
 	#include <test/lib/impl_posix/socket/unix.hpp>
+	#include <test/lib/impl_posix/stream/mapped_file.hpp>
+	#include <test/lib/impl_posix/stream/uring_file.hpp>
+	#include <test/lib/impl_posix/stream/transfer.hpp>
 	#include <test/lib/impl_posix/application/termios_keyboard.hpp>
 #endif // CPPLIB_PLATFORM_POSIX
 
@@ -55,6 +65,10 @@ int main() {
 	CPPLIB__TEST_RUN( ::test::lib::tl::Listener );
 #endif // CPPLIB__test__lib__tl__listener__hpp
 
+#ifdef CPPLIB__test__lib__tl__ringfifo__hpp
+	CPPLIB__TEST_RUN( ::test::lib::tl::RingFifo );
+#endif // CPPLIB__test__lib__tl__ringfifo__hpp
+
 
 #ifdef CPPLIB__test__lib__bus__hpp
 	CPPLIB__TEST_RUN( ::test::lib::Bus );
@@ -74,6 +88,10 @@ int main() {
 #endif // CPPLIB__test__lib__flags__hpp
 
 
+#ifdef CPPLIB__test__lib__data__serialize__hpp
+	CPPLIB__TEST_RUN( ::test::lib::data::Serialize );
+#endif // CPPLIB__test__lib__data__serialize__hpp
+
 #ifdef CPPLIB__test__lib__file__ini__hpp
 	CPPLIB__TEST_RUN( ::test::lib::file::Ini );
 #endif // CPPLIB__test__lib__file__ini__hpp
@@ -107,11 +125,29 @@ int main() {
 #ifdef CPPLIB__test__lib__impl__codec__base64__hpp
 	CPPLIB__TEST_RUN( ::test::lib::codec::impl::Base64 );
 #endif // CPPLIB__test__lib__impl__codec__base64__hpp
+#ifdef CPPLIB__test__lib__impl__codec__lz__hpp
+	CPPLIB__TEST_RUN( ::test::lib::codec::impl::Lz );
+#endif // CPPLIB__test__lib__impl__codec__lz__hpp
 
 #ifdef CPPLIB__test__lib__impl__hash__sha1__hpp
 	CPPLIB__TEST_RUN( ::test::lib::hash::impl::Sha1 );
 #endif // CPPLIB__test__lib__impl__hash__sha1__hpp
 
+#ifdef CPPLIB__test__lib__impl__stream__buffer__hpp
+	CPPLIB__TEST_RUN( ::test::lib::stream::impl::Buffer );
+#endif // CPPLIB__test__lib__impl__stream__buffer__hpp
+
+#ifdef CPPLIB__test__lib__impl__stream__chain__hpp
+	CPPLIB__TEST_RUN( ::test::lib::stream::impl::Chain );
+#endif // CPPLIB__test__lib__impl__stream__chain__hpp
+#ifdef CPPLIB__test__lib__impl__stream__metered__hpp
+	CPPLIB__TEST_RUN( ::test::lib::stream::impl::Metered );
+#endif // CPPLIB__test__lib__impl__stream__metered__hpp
+
+#ifdef CPPLIB__test__lib__impl__stream__spsc__hpp
+	CPPLIB__TEST_RUN( ::test::lib::stream::impl::Spsc );
+#endif // CPPLIB__test__lib__impl__stream__spsc__hpp
+
 
 #ifdef CPPLIB__test__lib__impl__socket__tcp__hpp
 	CPPLIB__TEST_RUN( ::test::lib::socket::impl::Tcp );
@@ -122,6 +158,16 @@ int main() {
 	CPPLIB__TEST_RUN( ::test::lib::socket::impl::Unix );
 #endif // CPPLIB__test__lib__impl_posix__socket__unix__hpp
 
+#ifdef CPPLIB__test__lib__impl_posix__stream__mapped_file__hpp
+	CPPLIB__TEST_RUN( ::test::lib::stream::impl::MappedFile );
+#endif // CPPLIB__test__lib__impl_posix__stream__mapped_file__hpp
+#ifdef CPPLIB__test__lib__impl_posix__stream__uring_file__hpp
+	CPPLIB__TEST_RUN( ::test::lib::stream::impl::UringFile );
+#endif // CPPLIB__test__lib__impl_posix__stream__uring_file__hpp
+#ifdef CPPLIB__test__lib__impl_posix__stream__transfer__hpp
+	CPPLIB__TEST_RUN( ::test::lib::stream::impl::Transfer );
+#endif // CPPLIB__test__lib__impl_posix__stream__transfer__hpp
+
 #ifdef CPPLIB__test__lib__impl_posix__application__termios_keyboard__hpp
 	CPPLIB__TEST_RUN( ::test::lib::application::impl::TermiosKeyboard );
 #endif // CPPLIB__test__lib__impl_posix__application__termios_keyboard__hpp